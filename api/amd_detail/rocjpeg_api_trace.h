@@ -45,7 +45,7 @@ THE SOFTWARE.
 
 // Increment the ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION when new runtime API functions are added.
 // If the corresponding ROCJPEG_RUNTIME_API_TABLE_MAJOR_VERSION increases reset the ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION to zero.
-#define ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION 0
+#define ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION 12
 
 // rocJPEG API interface
 typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegStreamCreate)(RocJpegStreamHandle *jpeg_stream_handle);
@@ -57,6 +57,27 @@ typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegGetImageInfo)(RocJpegHandle handle,
 typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegDecode)(RocJpegHandle handle, RocJpegStreamHandle jpeg_stream_handle, const RocJpegDecodeParams *decode_params, RocJpegImage *destination);
 typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegDecodeBatched)(RocJpegHandle handle, RocJpegStreamHandle *jpeg_stream_handles, int batch_size, const RocJpegDecodeParams *decode_params, RocJpegImage *destinations);
 typedef const char* (ROCJPEGAPI *PfnRocJpegGetErrorName)(RocJpegStatus rocjpeg_status);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegStreamParseBatched)(const unsigned char * const *data, const size_t *lengths, RocJpegStreamHandle *jpeg_stream_handles, RocJpegStatus *statuses, int batch_size);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegStreamParseChunk)(const unsigned char *data, size_t length, int is_last_chunk, RocJpegStreamHandle jpeg_stream_handle, RocJpegStreamParseState *parse_state);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegStreamGetMetadata)(RocJpegStreamHandle jpeg_stream_handle, RocJpegStreamMetadata *metadata);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegStreamGetAppSegments)(RocJpegStreamHandle jpeg_stream_handle, RocJpegAppSegment *app_segments, uint32_t *num_app_segments);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegStreamGetThumbnail)(RocJpegStreamHandle jpeg_stream_handle, const unsigned char **data, size_t *length);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegDecodeHost)(RocJpegStreamHandle jpeg_stream_handle, const RocJpegDecodeParams *decode_params, RocJpegImage *destination);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegStreamSplit)(const unsigned char *data, size_t length, RocJpegImageSpan *image_spans, uint32_t *num_image_spans);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegStreamAcquire)(RocJpegStreamHandle *jpeg_stream_handle);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegStreamRelease)(RocJpegStreamHandle jpeg_stream_handle);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegStreamGetImageInfoExt)(RocJpegStreamHandle jpeg_stream_handle, RocJpegImageInfoExt *image_info);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegStreamGetContentHash)(RocJpegStreamHandle jpeg_stream_handle, uint64_t *hash);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegStreamParseV)(const struct iovec *iov, int iovcnt, RocJpegStreamHandle jpeg_stream_handle);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegDecodeAsync)(RocJpegHandle handle, RocJpegStreamHandle jpeg_stream_handle, const RocJpegDecodeParams *decode_params, RocJpegImage *destination, uint64_t *job_id);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegDecodeBatchedAsync)(RocJpegHandle handle, RocJpegStreamHandle *jpeg_stream_handles, int batch_size, const RocJpegDecodeParams *decode_params, RocJpegImage *destinations, uint64_t *job_id);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegQuery)(RocJpegHandle handle, uint64_t job_id);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegWait)(RocJpegHandle handle, uint64_t job_id);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegSetJobCallback)(RocJpegHandle handle, uint64_t job_id, RocJpegJobCallback callback, void *user_data);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegGetCompletionFd)(RocJpegHandle handle, int *fd);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegGetCompletedJobs)(RocJpegHandle handle, RocJpegJobCompletion *completions, uint32_t *num_completions);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegSetMemoryLimits)(RocJpegHandle handle, const RocJpegMemoryLimits *memory_limits);
+typedef RocJpegStatus (ROCJPEGAPI *PfnRocJpegTrimMemory)(RocJpegHandle handle);
 
 
 // rocJPEG API dispatch table
@@ -75,6 +96,63 @@ struct RocJpegDispatchTable {
 
     // PLEASE DO NOT EDIT ABOVE!
     // ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 1
+    PfnRocJpegStreamParseBatched pfn_rocjpeg_stream_parse_batched;
+
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 2
+    PfnRocJpegStreamParseChunk pfn_rocjpeg_stream_parse_chunk;
+
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 3
+    PfnRocJpegStreamGetMetadata pfn_rocjpeg_stream_get_metadata;
+    PfnRocJpegStreamGetAppSegments pfn_rocjpeg_stream_get_app_segments;
+
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 4
+    PfnRocJpegStreamGetThumbnail pfn_rocjpeg_stream_get_thumbnail;
+    PfnRocJpegDecodeHost pfn_rocjpeg_decode_host;
+
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 5
+    PfnRocJpegStreamSplit pfn_rocjpeg_stream_split;
+
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 6
+    PfnRocJpegStreamAcquire pfn_rocjpeg_stream_acquire;
+    PfnRocJpegStreamRelease pfn_rocjpeg_stream_release;
+
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 7
+    PfnRocJpegStreamGetImageInfoExt pfn_rocjpeg_stream_get_image_info_ext;
+
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 8
+    PfnRocJpegStreamGetContentHash pfn_rocjpeg_stream_get_content_hash;
+
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 9
+    PfnRocJpegStreamParseV pfn_rocjpeg_stream_parse_v;
+
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 10
+    PfnRocJpegDecodeAsync pfn_rocjpeg_decode_async;
+    PfnRocJpegDecodeBatchedAsync pfn_rocjpeg_decode_batched_async;
+    PfnRocJpegQuery pfn_rocjpeg_query;
+    PfnRocJpegWait pfn_rocjpeg_wait;
+
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 11
+    PfnRocJpegSetJobCallback pfn_rocjpeg_set_job_callback;
+    PfnRocJpegGetCompletionFd pfn_rocjpeg_get_completion_fd;
+    PfnRocJpegGetCompletedJobs pfn_rocjpeg_get_completed_jobs;
+
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 12
+    PfnRocJpegSetMemoryLimits pfn_rocjpeg_set_memory_limits;
+    PfnRocJpegTrimMemory pfn_rocjpeg_trim_memory;
+
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 13
 
     // ******************************************************************************************* //
     //                                            READ BELOW
@@ -27,6 +27,7 @@ THE SOFTWARE.
 #pragma once
 #include "hip/hip_runtime.h"
 #include "rocjpeg_version.h"
+#include <sys/uio.h>
 
 /**
  * @file rocjpeg.h
@@ -64,6 +65,7 @@ typedef enum {
     ROCJPEG_STATUS_HW_JPEG_DECODER_NOT_SUPPORTED = -10, /**< Hardware JPEG decoder is not supported. */
     ROCJPEG_STATUS_RUNTIME_ERROR = -11, /**< Runtime error occurred. */
     ROCJPEG_STATUS_NOT_IMPLEMENTED = -12, /**< The requested feature is not implemented. */
+    ROCJPEG_STATUS_NOT_READY = -13, /**< The asynchronous decode job has not completed yet. */
 } RocJpegStatus;
 
 /**
@@ -178,6 +180,147 @@ typedef enum {
     ROCJPEG_BACKEND_HYBRID = 1    /**< Hybrid backend option. */
 } RocJpegBackend;
 
+/**
+ * @enum RocJpegStreamParseState
+ * @ingroup group_amd_rocjpeg
+ * @brief Enum representing the progress of an incremental parse of a JPEG stream with rocJpegStreamParseChunk.
+ *
+ * The states are ordered, so a state greater than or equal to `ROCJPEG_STREAM_PARSE_FRAME_HEADER_READY` means the
+ * frame header is available.
+ *
+ * The possible values are:
+ * - `ROCJPEG_STREAM_PARSE_NEED_MORE_DATA`: The frame header has not been received yet.
+ * - `ROCJPEG_STREAM_PARSE_FRAME_HEADER_READY`: The frame header (SOF marker) has been parsed. The number of components,
+ *   chroma subsampling, and dimensions of the image can be retrieved with rocJpegGetImageInfo.
+ * - `ROCJPEG_STREAM_PARSE_SCAN_HEADER_READY`: The scan header (SOS marker) has been parsed. The rest of the stream is
+ *   entropy-coded data, which is buffered until the stream is complete.
+ * - `ROCJPEG_STREAM_PARSE_COMPLETE`: The whole stream has been parsed and can be decoded.
+ */
+typedef enum {
+    ROCJPEG_STREAM_PARSE_NEED_MORE_DATA = 0,
+    ROCJPEG_STREAM_PARSE_FRAME_HEADER_READY = 1,
+    ROCJPEG_STREAM_PARSE_SCAN_HEADER_READY = 2,
+    ROCJPEG_STREAM_PARSE_COMPLETE = 3
+} RocJpegStreamParseState;
+
+/**
+ * @struct RocJpegAppSegment
+ * @ingroup group_amd_rocjpeg
+ * @brief Structure representing an application (APPn) segment of a JPEG stream.
+ *
+ * The payload is not copied; `data` points into the buffer that was parsed and remains valid until the stream handle
+ * parses another stream or is destroyed. For rocJpegStreamParseChunk, it points into the buffer owned by the stream
+ * handle, which grows as chunks are appended, so it is invalidated by the next call to rocJpegStreamParseChunk.
+ */
+typedef struct {
+    uint8_t marker; /**< The APPn marker of the segment, e.g., 0xE1 for APP1. */
+    uint32_t offset; /**< Offset of the segment payload (after the length field) from the start of the JPEG stream. */
+    uint32_t length; /**< Length of the segment payload in bytes. */
+    const unsigned char *data; /**< Pointer to the segment payload. */
+} RocJpegAppSegment;
+
+/**
+ * @struct RocJpegImageSpan
+ * @ingroup group_amd_rocjpeg
+ * @brief Structure representing the location of a JPEG image in a buffer that contains several images.
+ *
+ * The images of an MPO (multi-picture object) file are described by the MP index of its first image; `mp_type` is the
+ * MP type code of the image in that index, e.g., 0x030000 for the baseline primary image, 0x010001 or 0x010002 for a
+ * large thumbnail, or 0x020001 to 0x020003 for the frames of a panorama, disparity, or multi-angle image.
+ */
+typedef struct {
+    size_t offset; /**< Offset of the image (its SOI marker) from the start of the buffer. */
+    size_t length; /**< Length of the image in bytes. */
+    uint32_t mp_type; /**< MP type code of the image, or 0 if the image is not described by an MP index. */
+} RocJpegImageSpan;
+
+/**
+ * @struct RocJpegImageInfoExt
+ * @ingroup group_amd_rocjpeg
+ * @brief Structure representing the extended information of a parsed JPEG stream.
+ *
+ * In addition to the information returned by rocJpegGetImageInfo, the structure holds an estimate of the quality
+ * factor the image was encoded with and the quantities that drive its decode cost, so that images can be binned or
+ * routed by cost before they are decoded. The cost of the entropy decoding grows with `entropy_data_size`, and the
+ * cost of the inverse DCT and of the output conversion with `num_pixels`. Restart intervals allow the entropy-coded
+ * data of an image to be decoded in parallel.
+ */
+typedef struct {
+    uint8_t num_components; /**< The number of components of the image. */
+    RocJpegChromaSubsampling subsampling; /**< The chroma subsampling of the image. */
+    uint32_t width; /**< The width of the image in pixels. */
+    uint32_t height; /**< The height of the image in pixels. */
+    uint32_t quality_factor; /**< The estimated IJG quality factor (1 to 100) of the luma quantization table. */
+    uint64_t num_pixels; /**< The number of pixels of the image. */
+    uint32_t num_mcus; /**< The number of MCUs of the image. */
+    uint32_t entropy_data_size; /**< The size in bytes of the entropy-coded data of the scan. */
+    float bytes_per_mcu; /**< The average number of bytes of entropy-coded data per MCU. */
+    float bits_per_pixel; /**< The average number of bits of entropy-coded data per pixel. */
+    uint32_t restart_interval; /**< The number of MCUs per restart interval, or 0 if the image has no restart markers. */
+    uint32_t num_restart_intervals; /**< The number of restart intervals, 1 if the image has no restart markers. */
+} RocJpegImageInfoExt;
+
+/**
+ * @struct RocJpegStreamMetadata
+ * @ingroup group_amd_rocjpeg
+ * @brief Structure containing the metadata carried by the application segments of a JPEG stream.
+ *
+ * The metadata is collected while parsing the stream, from the APP0 (JFIF), APP1 (EXIF), APP2 (ICC profile),
+ * and APP14 (Adobe) segments. The EXIF orientation is reported as-is; it is not applied by the decoder.
+ */
+typedef struct {
+    uint16_t orientation; /**< EXIF orientation (1 to 8), or 0 if the stream has no EXIF orientation tag. */
+    uint8_t density_unit; /**< JFIF density unit (0: no unit (aspect ratio only), 1: dots per inch, 2: dots per cm). */
+    uint16_t x_density; /**< JFIF horizontal pixel density, or 0 if the stream has no JFIF segment. */
+    uint16_t y_density; /**< JFIF vertical pixel density, or 0 if the stream has no JFIF segment. */
+    int32_t adobe_transform; /**< Adobe color transform (0: none, 1: YCbCr, 2: YCCK), or -1 if the stream has no Adobe segment. */
+    const unsigned char *icc_profile; /**< Pointer to the ICC profile, or NULL if the stream has no ICC profile.
+                                           A profile stored in a single APP2 segment is not copied. */
+    size_t icc_profile_size; /**< Size of the ICC profile in bytes. */
+    uint32_t num_app_segments; /**< Number of APP0, APP1, APP2, and APP14 segments in the stream. */
+} RocJpegStreamMetadata;
+
+/**
+ * @struct RocJpegJobCompletion
+ * @ingroup group_amd_rocjpeg
+ * @brief Structure representing an asynchronous decode job that has completed, as returned by rocJpegGetCompletedJobs.
+ */
+typedef struct {
+    uint64_t job_id; /**< The ID of the decode job. */
+    RocJpegStatus status; /**< The status of the decoding. */
+} RocJpegJobCompletion;
+
+/**
+ * @brief The function called when an asynchronous decode job completes, see rocJpegSetJobCallback.
+ *
+ * @param job_id The ID of the decode job.
+ * @param status The status of the decoding.
+ * @param user_data The pointer passed to rocJpegSetJobCallback.
+ */
+typedef void (*RocJpegJobCallback)(uint64_t job_id, RocJpegStatus status, void *user_data);
+
+/**
+ * @brief Enumeration of what a decode does when the memory budget of a rocJPEG handle is exhausted, see RocJpegMemoryLimits.
+ * @ingroup group_amd_rocjpeg
+ */
+typedef enum {
+    ROCJPEG_SURFACE_ACQUIRE_GROW = 0, /**< Allocate the surfaces anyway, exceeding the budget until they are released (default). */
+    ROCJPEG_SURFACE_ACQUIRE_WAIT = 1, /**< Wait for the asynchronous decode jobs in flight to release surfaces. */
+    ROCJPEG_SURFACE_ACQUIRE_TRY = 2, /**< Return ROCJPEG_STATUS_NOT_READY without decoding. */
+} RocJpegSurfaceAcquireMode;
+
+/**
+ * @struct RocJpegMemoryLimits
+ * @ingroup group_amd_rocjpeg
+ * @brief Structure representing the limits of the device memory held by a rocJPEG handle, see rocJpegSetMemoryLimits.
+ */
+typedef struct {
+    size_t max_pool_bytes; /**< Maximum device memory held by the decoded surfaces of the handle in bytes, or 0 for no limit. */
+    uint32_t idle_timeout_ms; /**< Time after which a surface that is not in use is released in milliseconds, or 0 to keep it. */
+    RocJpegSurfaceAcquireMode surface_acquire_mode; /**< What a decode does when `max_pool_bytes` would be exceeded. */
+    uint32_t surface_acquire_timeout_ms; /**< Maximum wait of ROCJPEG_SURFACE_ACQUIRE_WAIT in milliseconds, or 0 for no limit. */
+} RocJpegMemoryLimits;
+
 /**
  * @brief A handle representing a RocJpegStream instance.
  *
@@ -209,7 +352,8 @@ RocJpegStatus ROCJPEGAPI rocJpegStreamCreate(RocJpegStreamHandle *jpeg_stream_ha
  * @brief Parses a JPEG stream.
  *
  * This function parses a JPEG stream represented by the `data` parameter of length `length`.
- * The parsed stream is associated with the `jpeg_stream_handle` provided.
+ * The parsed stream is associated with the `jpeg_stream_handle` provided. A stream without DHT segments, such as a
+ * Motion-JPEG frame, is decoded with the typical Huffman tables of Annex K of the JPEG specification.
  *
  * @param data The pointer to the JPEG stream data.
  * @param length The length of the JPEG stream data.
@@ -218,6 +362,271 @@ RocJpegStatus ROCJPEGAPI rocJpegStreamCreate(RocJpegStreamHandle *jpeg_stream_ha
  */
 RocJpegStatus ROCJPEGAPI rocJpegStreamParse(const unsigned char *data, size_t length, RocJpegStreamHandle jpeg_stream_handle);
 
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegStreamParseV(const struct iovec *iov, int iovcnt, RocJpegStreamHandle jpeg_stream_handle);
+ * @ingroup group_amd_rocjpeg
+ * @brief Parses a JPEG stream that is scattered over several buffers.
+ *
+ * This function parses a JPEG stream whose bytes are the concatenation of the `iovcnt` buffers described by `iov`,
+ * such as the buffers received from a network stack or an object store, without concatenating them first. Only the
+ * marker segments that precede the entropy-coded data are copied into the stream handle; the entropy-coded data is
+ * referenced in place and is copied straight from the buffers into the slice data buffer of the hardware decoder.
+ * The buffers must therefore remain valid, and unmodified, until the stream has been decoded. Empty buffers are
+ * allowed. The payloads returned by rocJpegStreamGetAppSegments point into the copy of the marker segments.
+ *
+ * @param iov The array of buffers of the JPEG stream, in order.
+ * @param iovcnt The number of buffers in `iov`.
+ * @param jpeg_stream_handle The handle to the JPEG stream.
+ * @return RocJpegStatus Returns the status of the operation. Possible values are:
+ *                      - ROCJPEG_STATUS_SUCCESS: The operation was successful.
+ *                      - ROCJPEG_STATUS_INVALID_PARAMETER: One of the parameters is NULL, or `iovcnt` is not positive.
+ *                      - ROCJPEG_STATUS_BAD_JPEG: The stream could not be parsed.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamParseV(const struct iovec *iov, int iovcnt, RocJpegStreamHandle jpeg_stream_handle);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegStreamParseBatched(const unsigned char * const *data, const size_t *lengths, RocJpegStreamHandle *jpeg_stream_handles, RocJpegStatus *statuses, int batch_size);
+ * @ingroup group_amd_rocjpeg
+ * @brief Parses a batch of JPEG streams in parallel.
+ *
+ * This function parses `batch_size` JPEG streams, where the i-th stream is represented by `data[i]` of length
+ * `lengths[i]` and is associated with `jpeg_stream_handles[i]`. The streams are parsed concurrently on an
+ * internal pool of CPU threads, which is shared by all the stream handles of the process. The number of
+ * worker threads defaults to the number of hardware threads minus one (the calling thread also parses streams)
+ * and can be changed by setting the ROCJPEG_NUM_PARSER_THREADS environment variable before the first call to
+ * this function.
+ *
+ * The handles in `jpeg_stream_handles` must be distinct. Each handle is left in the same state as if
+ * rocJpegStreamParse had been called on it, so the batch can be passed as-is to rocJpegDecodeBatched.
+ *
+ * @param data An array of `batch_size` pointers to the JPEG stream data.
+ * @param lengths An array of `batch_size` lengths of the JPEG stream data.
+ * @param jpeg_stream_handles An array of `batch_size` handles to the JPEG streams.
+ * @param statuses An optional array of `batch_size` elements that receives the status of each stream's parsing.
+ *                 Can be NULL if the per-stream status is not needed.
+ * @param batch_size The number of JPEG streams in the batch.
+ * @return RocJpegStatus Returns the status of the operation. Possible values are:
+ *                      - ROCJPEG_STATUS_SUCCESS: All the streams were parsed successfully.
+ *                      - ROCJPEG_STATUS_INVALID_PARAMETER: One of the array parameters is NULL or `batch_size` is less than 1.
+ *                      - Otherwise, the status of the first stream in the batch that failed to parse.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamParseBatched(const unsigned char * const *data, const size_t *lengths, RocJpegStreamHandle *jpeg_stream_handles, RocJpegStatus *statuses, int batch_size);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegStreamParseChunk(const unsigned char *data, size_t length, int is_last_chunk, RocJpegStreamHandle jpeg_stream_handle, RocJpegStreamParseState *parse_state);
+ * @ingroup group_amd_rocjpeg
+ * @brief Parses the next chunk of a JPEG stream that is received in several pieces.
+ *
+ * This function consumes a JPEG stream incrementally, e.g., as it is received from the network. The chunk represented
+ * by `data` of length `length` is copied into a buffer owned by `jpeg_stream_handle`, so the caller can reuse its
+ * buffer as soon as the function returns. The headers are parsed as soon as they are complete, and the progress is
+ * returned in `parse_state`:
+ * - Once the state reaches ROCJPEG_STREAM_PARSE_FRAME_HEADER_READY, rocJpegGetImageInfo can be called to get the
+ *   dimensions of the image and allocate the output buffers before the rest of the stream is received.
+ * - Once the state reaches ROCJPEG_STREAM_PARSE_COMPLETE, the stream can be decoded with rocJpegDecode or
+ *   rocJpegDecodeBatched. The stream is complete when the EOI marker is received or when `is_last_chunk` is set.
+ *   Any data following the EOI marker in the same chunk is ignored.
+ *
+ * After the stream is complete, the next call to this function starts parsing a new stream on the same handle.
+ * Calling rocJpegStreamParse on the handle also discards any partially received stream.
+ *
+ * Appending a chunk may reallocate the buffer of the stream handle, so each call to this function invalidates the
+ * pointers previously returned by rocJpegStreamGetMetadata, rocJpegStreamGetAppSegments and
+ * rocJpegStreamGetThumbnail for the handle.
+ *
+ * @param data The pointer to the chunk of the JPEG stream data. Can be NULL if `length` is 0.
+ * @param length The length of the chunk.
+ * @param is_last_chunk Nonzero if this chunk is the last one of the JPEG stream.
+ * @param jpeg_stream_handle The handle to the JPEG stream.
+ * @param parse_state Pointer to a RocJpegStreamParseState variable that receives the progress of the parse.
+ * @return RocJpegStatus Returns the status of the operation. Possible values are:
+ *                      - ROCJPEG_STATUS_SUCCESS: The chunk was parsed successfully.
+ *                      - ROCJPEG_STATUS_INVALID_PARAMETER: One of the parameters is invalid.
+ *                      - ROCJPEG_STATUS_BAD_JPEG: The JPEG stream is invalid, or it ended before the scan header. The
+ *                        partially received stream is discarded.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamParseChunk(const unsigned char *data, size_t length, int is_last_chunk, RocJpegStreamHandle jpeg_stream_handle, RocJpegStreamParseState *parse_state);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegStreamGetMetadata(RocJpegStreamHandle jpeg_stream_handle, RocJpegStreamMetadata *metadata);
+ * @ingroup group_amd_rocjpeg
+ * @brief Retrieves the metadata of a parsed JPEG stream.
+ *
+ * This function returns the EXIF orientation, the ICC profile, the JFIF pixel density, and the Adobe color transform
+ * found while parsing the stream associated with `jpeg_stream_handle`. The pointers returned in `metadata` remain valid
+ * until the stream handle parses another stream or is destroyed, or, for a stream parsed with rocJpegStreamParseChunk,
+ * until the next call to rocJpegStreamParseChunk on the handle.
+ *
+ * @param jpeg_stream_handle The handle to the parsed JPEG stream.
+ * @param metadata Pointer to a RocJpegStreamMetadata structure that receives the metadata.
+ * @return RocJpegStatus Returns the status of the operation. Possible values are:
+ *                      - ROCJPEG_STATUS_SUCCESS: The operation was successful.
+ *                      - ROCJPEG_STATUS_INVALID_PARAMETER: One of the parameters is NULL.
+ *                      - ROCJPEG_STATUS_BAD_JPEG: A chunk of the ICC profile is missing.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetMetadata(RocJpegStreamHandle jpeg_stream_handle, RocJpegStreamMetadata *metadata);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegStreamGetAppSegments(RocJpegStreamHandle jpeg_stream_handle, RocJpegAppSegment *app_segments, uint32_t *num_app_segments);
+ * @ingroup group_amd_rocjpeg
+ * @brief Retrieves the locations of the APP0, APP1, APP2, and APP14 segments of a parsed JPEG stream.
+ *
+ * If `app_segments` is NULL, the number of segments is returned in `num_app_segments`. Otherwise, `num_app_segments`
+ * must contain the number of elements of the `app_segments` array; on return it contains the number of segments
+ * written, in the order in which they appear in the stream.
+ *
+ * @param jpeg_stream_handle The handle to the parsed JPEG stream.
+ * @param app_segments An array that receives the segments, or NULL to query the number of segments.
+ * @param num_app_segments Pointer to the number of elements of `app_segments`; receives the number of segments.
+ * @return RocJpegStatus Returns the status of the operation. Possible values are:
+ *                      - ROCJPEG_STATUS_SUCCESS: The operation was successful.
+ *                      - ROCJPEG_STATUS_INVALID_PARAMETER: `jpeg_stream_handle` or `num_app_segments` is NULL.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetAppSegments(RocJpegStreamHandle jpeg_stream_handle, RocJpegAppSegment *app_segments, uint32_t *num_app_segments);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegStreamGetThumbnail(RocJpegStreamHandle jpeg_stream_handle, const unsigned char **data, size_t *length);
+ * @ingroup group_amd_rocjpeg
+ * @brief Retrieves the JPEG thumbnail embedded in the EXIF data of a parsed JPEG stream.
+ *
+ * The thumbnail is located while parsing the stream, from the 1st IFD of the EXIF APP1 segment. It is not copied:
+ * `data` points into the stream associated with `jpeg_stream_handle` and remains valid until the stream handle
+ * parses another stream or is destroyed, or, for a stream parsed with rocJpegStreamParseChunk, until the next call
+ * to rocJpegStreamParseChunk on the handle. The thumbnail is itself a JPEG stream; it can be parsed into another
+ * stream handle with rocJpegStreamParse and decoded with rocJpegDecodeHost.
+ *
+ * @param jpeg_stream_handle The handle to the parsed JPEG stream.
+ * @param data Receives a pointer to the thumbnail, or NULL if the stream has no JPEG thumbnail.
+ * @param length Receives the length of the thumbnail in bytes, or 0 if the stream has no JPEG thumbnail.
+ * @return RocJpegStatus Returns the status of the operation. Possible values are:
+ *                      - ROCJPEG_STATUS_SUCCESS: The operation was successful.
+ *                      - ROCJPEG_STATUS_INVALID_PARAMETER: One of the parameters is NULL.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetThumbnail(RocJpegStreamHandle jpeg_stream_handle, const unsigned char **data, size_t *length);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegDecodeHost(RocJpegStreamHandle jpeg_stream_handle, const RocJpegDecodeParams *decode_params, RocJpegImage *destination);
+ * @ingroup group_amd_rocjpeg
+ * @brief Decodes a small parsed JPEG stream on the CPU into host memory.
+ *
+ * This function is intended for images that are too small for the hardware JPEG decoder (less than 64x64 pixels),
+ * such as EXIF thumbnails, for which a round trip to the GPU costs more than the decoding itself. No RocJpegHandle
+ * is needed. The channels of `destination` must point to host memory, sized and laid out as for rocJpegDecode
+ * (see rocJpegGetImageInfo). Only baseline streams with one or three components are supported; the crop rectangle
+ * and the target dimensions of `decode_params` are ignored.
+ *
+ * @param jpeg_stream_handle The handle to the parsed JPEG stream.
+ * @param decode_params Pointer to a RocJpegDecodeParams structure that specifies the output format.
+ * @param destination Pointer to a RocJpegImage structure whose channels point to host memory.
+ * @return RocJpegStatus Returns the status of the operation. Possible values are:
+ *                      - ROCJPEG_STATUS_SUCCESS: The operation was successful.
+ *                      - ROCJPEG_STATUS_INVALID_PARAMETER: One of the parameters is NULL or a required channel is NULL.
+ *                      - ROCJPEG_STATUS_BAD_JPEG: The JPEG stream is invalid or has not been completely parsed.
+ *                      - ROCJPEG_STATUS_JPEG_NOT_SUPPORTED: The chroma subsampling or the scan structure is not supported.
+ *                      - ROCJPEG_STATUS_RUNTIME_ERROR: An internal error occurred.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegDecodeHost(RocJpegStreamHandle jpeg_stream_handle, const RocJpegDecodeParams *decode_params, RocJpegImage *destination);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegStreamSplit(const unsigned char *data, size_t length, RocJpegImageSpan *image_spans, uint32_t *num_image_spans);
+ * @ingroup group_amd_rocjpeg
+ * @brief Locates the JPEG images of a buffer that contains several images.
+ *
+ * This function scans `data` once and returns the location of each JPEG image it contains: images stored back to
+ * back, as in burst captures or MJPEG dumps, and the images of MPO files, which are located through the MP index
+ * (APP2 "MPF" segment) of their first image. Bytes between the images are skipped. An image that is not terminated
+ * by an EOI marker extends to the end of the buffer. Each image can then be parsed into its own stream handle, e.g.,
+ * with rocJpegStreamParseBatched, and the images can be decoded in a single batch.
+ *
+ * If `image_spans` is NULL, the number of images is returned in `num_image_spans`. Otherwise, `num_image_spans` must
+ * contain the number of elements of the `image_spans` array; on return it contains the number of images written.
+ *
+ * @param data Pointer to the buffer.
+ * @param length The length of the buffer in bytes.
+ * @param image_spans An array that receives the image spans, or NULL to query the number of images.
+ * @param num_image_spans Pointer to the number of elements of `image_spans`; receives the number of images.
+ * @return RocJpegStatus Returns the status of the operation. Possible values are:
+ *                      - ROCJPEG_STATUS_SUCCESS: The operation was successful.
+ *                      - ROCJPEG_STATUS_INVALID_PARAMETER: `data` or `num_image_spans` is NULL.
+ *                      - ROCJPEG_STATUS_BAD_JPEG: The buffer does not contain any JPEG image.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamSplit(const unsigned char *data, size_t length, RocJpegImageSpan *image_spans, uint32_t *num_image_spans);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegStreamAcquire(RocJpegStreamHandle *jpeg_stream_handle);
+ * @ingroup group_amd_rocjpeg
+ * @brief Takes a stream handle from a pool of stream handles owned by the library.
+ *
+ * The pool is shared by the whole process and is lock-free. Its handles are constructed in advance and keep
+ * their internal buffers when they are released, so acquiring a handle, parsing a stream with it, and releasing
+ * it does not allocate memory once the buffers have grown to the size of the streams. This is intended for
+ * servers that decode each request with a short-lived stream handle. A handle taken from the pool must be
+ * returned with rocJpegStreamRelease; rocJpegStreamDestroy also returns it to the pool.
+ *
+ * @param jpeg_stream_handle Pointer to a RocJpegStreamHandle that receives the handle.
+ * @return RocJpegStatus Returns the status of the operation. Possible values are:
+ *                      - ROCJPEG_STATUS_SUCCESS: The operation was successful.
+ *                      - ROCJPEG_STATUS_INVALID_PARAMETER: `jpeg_stream_handle` is NULL.
+ *                      - ROCJPEG_STATUS_OUTOF_MEMORY: The pool has reached its maximum size and all its handles are in use.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamAcquire(RocJpegStreamHandle *jpeg_stream_handle);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegStreamRelease(RocJpegStreamHandle jpeg_stream_handle);
+ * @ingroup group_amd_rocjpeg
+ * @brief Returns a stream handle taken with rocJpegStreamAcquire to the pool.
+ *
+ * The handle must not be used after it is released. Any pointer obtained from the handle, e.g., by
+ * rocJpegStreamGetMetadata, is invalidated.
+ *
+ * @param jpeg_stream_handle The stream handle to release.
+ * @return RocJpegStatus Returns the status of the operation. Possible values are:
+ *                      - ROCJPEG_STATUS_SUCCESS: The operation was successful.
+ *                      - ROCJPEG_STATUS_INVALID_PARAMETER: `jpeg_stream_handle` is NULL, was not taken from the pool,
+ *                        or has already been released.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamRelease(RocJpegStreamHandle jpeg_stream_handle);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegStreamGetImageInfoExt(RocJpegStreamHandle jpeg_stream_handle, RocJpegImageInfoExt *image_info);
+ * @ingroup group_amd_rocjpeg
+ * @brief Retrieves the extended information of a parsed JPEG stream.
+ *
+ * This function returns the dimensions and chroma subsampling of the image, the estimated quality factor, and the
+ * predictors of the decode cost described in RocJpegImageInfoExt. No decoder handle is needed, so the information
+ * can be used to choose how, and with which decoder, each image is decoded. The quality factor is estimated once
+ * per distinct set of quantization tables, so retrieving it does not add to the cost of parsing.
+ *
+ * @param jpeg_stream_handle The handle to the parsed JPEG stream.
+ * @param image_info Pointer to a RocJpegImageInfoExt structure that receives the information.
+ * @return RocJpegStatus Returns the status of the operation. Possible values are:
+ *                      - ROCJPEG_STATUS_SUCCESS: The operation was successful.
+ *                      - ROCJPEG_STATUS_INVALID_PARAMETER: One of the parameters is NULL.
+ *                      - ROCJPEG_STATUS_BAD_JPEG: The stream has not been completely parsed.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetImageInfoExt(RocJpegStreamHandle jpeg_stream_handle, RocJpegImageInfoExt *image_info);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegStreamGetContentHash(RocJpegStreamHandle jpeg_stream_handle, uint64_t *hash);
+ * @ingroup group_amd_rocjpeg
+ * @brief Retrieves the content hash of a parsed JPEG stream.
+ *
+ * The 64-bit hash is computed by rocJpegStreamParse in the same pass that searches the entropy-coded data for the
+ * EOI marker, so it adds almost nothing to the cost of parsing. It covers the quantization and Huffman tables, the
+ * frame and scan headers, the restart interval, and the entropy-coded data, but not the application segments such
+ * as EXIF or ICC profiles: two streams that decode to the same image with the same tables have the same hash even
+ * if their metadata differs. This can be used to skip decoding an image that has already been decoded. The hash is
+ * not cryptographic, so when a collision would be harmful, compare the streams byte by byte after a match.
+ *
+ * @param jpeg_stream_handle The handle to the parsed JPEG stream.
+ * @param hash Pointer to a variable that receives the content hash.
+ * @return RocJpegStatus Returns the status of the operation. Possible values are:
+ *                      - ROCJPEG_STATUS_SUCCESS: The operation was successful.
+ *                      - ROCJPEG_STATUS_INVALID_PARAMETER: One of the parameters is NULL.
+ *                      - ROCJPEG_STATUS_BAD_JPEG: The stream has not been completely parsed.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetContentHash(RocJpegStreamHandle jpeg_stream_handle, uint64_t *hash);
+
 /**
  * @fn RocJpegStatus ROCJPEGAPI rocJpegStreamDestroy(RocJpegStreamHandle jpeg_stream_handle);
  * @ingroup group_amd_rocjpeg
@@ -225,7 +634,7 @@ RocJpegStatus ROCJPEGAPI rocJpegStreamParse(const unsigned char *data, size_t le
  *
  * This function destroys the RocJpegStreamHandle object specified by `jpeg_stream_handle` and releases any resources
  * associated with it. After calling this function, the `jpeg_stream_handle` becomes invalid and should not be used
- * anymore.
+ * anymore. A handle taken with rocJpegStreamAcquire is returned to the pool instead, as with rocJpegStreamRelease.
  *
  * @param jpeg_stream_handle The handle to the RocJpegStreamHandle object to be destroyed.
  * @return The status of the operation. Returns ROCJPEG_STATUS_SUCCESS if the operation is successful, or an error code
@@ -304,6 +713,10 @@ RocJpegStatus ROCJPEGAPI rocJpegGetImageInfo(RocJpegHandle handle, RocJpegStream
  * a pointer to RocJpegDecodeParams, and a pointer to RocJpegImage as input parameters. The function returns a
  * RocJpegStatus indicating the success or failure of the decoding operation.
  *
+ * The parsed stream is not modified by the decoding, so the same rocJpegStreamHandle can be decoded by several
+ * rocJpegHandles at the same time, for example with different crop rectangles or on different devices, as long as
+ * it is not parsed again or destroyed until all the decodes have returned.
+ *
  * @param handle The rocJpegHandle representing the rocJPEG decoder instance.
  * @param jpeg_stream_handle The rocJpegStreamHandle representing the input JPEG stream.
  * @param decode_params A pointer to RocJpegDecodeParams containing the decoding parameters.
@@ -320,6 +733,7 @@ RocJpegStatus ROCJPEGAPI rocJpegDecode(RocJpegHandle handle, RocJpegStreamHandle
  * @brief Decodes a batch of JPEG images using the rocJPEG library.
  *
  * Decodes a batch of JPEG images using the rocJPEG library.
+ * As with rocJpegDecode, the parsed streams are not modified and can be decoded by other rocJpegHandles at the same time.
  *
  * @param handle The rocJPEG handle.
  * @param jpeg_stream_handles An array of rocJPEG stream handles representing the input JPEG streams.
@@ -330,6 +744,177 @@ RocJpegStatus ROCJPEGAPI rocJpegDecode(RocJpegHandle handle, RocJpegStreamHandle
  */
 RocJpegStatus ROCJPEGAPI rocJpegDecodeBatched(RocJpegHandle handle, RocJpegStreamHandle *jpeg_stream_handles, int batch_size, const RocJpegDecodeParams *decode_params, RocJpegImage *destinations);
 
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegDecodeAsync(RocJpegHandle handle, RocJpegStreamHandle jpeg_stream_handle, const RocJpegDecodeParams *decode_params, RocJpegImage *destination, uint64_t *job_id);
+ * @ingroup group_amd_rocjpeg
+ * @brief Submits a JPEG image for decoding and returns without waiting for the decoded image.
+ *
+ * This function submits the parsed stream to the hardware JPEG decoder and returns a job ID as soon as the
+ * submission is done, so a single host thread can keep all the JPEG cores busy. The copy or color conversion of
+ * the decoded image into the destination, and the release of the decoder's internal surfaces, are performed by the
+ * following calls of rocJpegDecodeAsync, rocJpegDecodeBatchedAsync, rocJpegQuery, and rocJpegWait on the same
+ * handle; rocJpegWait completes the job. When too many jobs are in flight on the handle, the oldest one is
+ * completed before the new one is submitted.
+ *
+ * The stream must not be parsed again or destroyed, and the destination buffers must not be freed or read, until
+ * the job has completed. The decode parameters and the RocJpegImage structure itself are copied, so they can be
+ * reused as soon as the function returns.
+ *
+ * @param handle The rocJpegHandle representing the rocJPEG decoder instance.
+ * @param jpeg_stream_handle The rocJpegStreamHandle representing the input JPEG stream.
+ * @param decode_params A pointer to RocJpegDecodeParams containing the decoding parameters.
+ * @param destination A pointer to RocJpegImage where the decoded image will be stored.
+ * @param job_id A pointer to store the ID of the decode job, to be passed to rocJpegQuery and rocJpegWait.
+ * @return ROCJPEG_STATUS_SUCCESS if the image was submitted, or an error code otherwise.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegDecodeAsync(RocJpegHandle handle, RocJpegStreamHandle jpeg_stream_handle, const RocJpegDecodeParams *decode_params, RocJpegImage *destination, uint64_t *job_id);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegDecodeBatchedAsync(RocJpegHandle handle, RocJpegStreamHandle *jpeg_stream_handles, int batch_size, const RocJpegDecodeParams *decode_params, RocJpegImage *destinations, uint64_t *job_id);
+ * @ingroup group_amd_rocjpeg
+ * @brief Submits a batch of JPEG images for decoding and returns without waiting for the decoded images.
+ *
+ * The whole batch is submitted to the hardware JPEG decoder and forms a single job, which completes when all its
+ * images have been decoded into their destinations. The same lifetime rules as for rocJpegDecodeAsync apply to the
+ * streams and destinations of the batch; the array of stream handles itself can be reused once the function returns.
+ *
+ * @param handle The rocJPEG handle.
+ * @param jpeg_stream_handles An array of rocJPEG stream handles representing the input JPEG streams.
+ * @param batch_size The number of JPEG streams in the batch.
+ * @param decode_params The decode parameters for the JPEG decoding process.
+ * @param destinations An array of rocJPEG images representing the output decoded images.
+ * @param job_id A pointer to store the ID of the decode job, to be passed to rocJpegQuery and rocJpegWait.
+ * @return ROCJPEG_STATUS_SUCCESS if the batch was submitted, or an error code otherwise.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegDecodeBatchedAsync(RocJpegHandle handle, RocJpegStreamHandle *jpeg_stream_handles, int batch_size, const RocJpegDecodeParams *decode_params, RocJpegImage *destinations, uint64_t *job_id);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegQuery(RocJpegHandle handle, uint64_t job_id);
+ * @ingroup group_amd_rocjpeg
+ * @brief Queries the status of an asynchronous decode job without blocking.
+ *
+ * This function advances the jobs in flight on the handle and returns ROCJPEG_STATUS_NOT_READY if the job has not
+ * completed yet. Once the job has completed, its destinations are ready and the status of the decoding is returned.
+ *
+ * @param handle The rocJPEG handle the job was submitted to.
+ * @param job_id The ID of the decode job.
+ * @return ROCJPEG_STATUS_NOT_READY if the job is in flight, ROCJPEG_STATUS_SUCCESS if it completed successfully,
+ *         the error of the job if it failed, or ROCJPEG_STATUS_INVALID_PARAMETER for an unknown job ID or a job
+ *         whose status is no longer kept.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegQuery(RocJpegHandle handle, uint64_t job_id);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegWait(RocJpegHandle handle, uint64_t job_id);
+ * @ingroup group_amd_rocjpeg
+ * @brief Waits for an asynchronous decode job to complete.
+ *
+ * This function blocks until the images of the job have been decoded into their destinations, and returns the
+ * status of the decoding. Other threads can submit and query jobs on the same handle while it waits. The status of
+ * a job is kept for the 4096 most recent jobs of the handle, so it can be queried and waited for any number of times,
+ * whether or not it has been delivered to a callback or by rocJpegGetCompletedJobs; for an older job,
+ * ROCJPEG_STATUS_INVALID_PARAMETER is returned.
+ *
+ * @param handle The rocJPEG handle the job was submitted to.
+ * @param job_id The ID of the decode job.
+ * @return ROCJPEG_STATUS_SUCCESS if the job completed successfully, the error of the job if it failed, or
+ *         ROCJPEG_STATUS_INVALID_PARAMETER for an unknown job ID or a job whose status is no longer kept.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegWait(RocJpegHandle handle, uint64_t job_id);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegSetJobCallback(RocJpegHandle handle, uint64_t job_id, RocJpegJobCallback callback, void *user_data);
+ * @ingroup group_amd_rocjpeg
+ * @brief Sets the function called when an asynchronous decode job completes.
+ *
+ * The callback is called once, with the status of the job, after its images have been decoded into their
+ * destinations. It is called from an internal completion thread of the handle, which is started by the first call
+ * of rocJpegSetJobCallback or rocJpegGetCompletionFd and advances the jobs in flight on its own, so no application
+ * thread needs to wait for them. The callback may submit new jobs on the handle, but must not destroy it. If the job
+ * has already completed, the callback is called from the calling thread before this function returns.
+ *
+ * @param handle The rocJPEG handle the job was submitted to.
+ * @param job_id The ID of the decode job.
+ * @param callback The function to call, or NULL to remove the callback of the job.
+ * @param user_data The pointer passed to the callback.
+ * @return ROCJPEG_STATUS_SUCCESS if successful, or ROCJPEG_STATUS_INVALID_PARAMETER for an unknown job ID.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegSetJobCallback(RocJpegHandle handle, uint64_t job_id, RocJpegJobCallback callback, void *user_data);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegGetCompletionFd(RocJpegHandle handle, int *fd);
+ * @ingroup group_amd_rocjpeg
+ * @brief Retrieves a file descriptor that becomes readable when asynchronous decode jobs complete.
+ *
+ * The file descriptor is a non-blocking eventfd that can be added to an epoll or poll loop. It is created, along with
+ * the completion thread of the handle, by the first call; from then on, each job that completes increments its
+ * counter and is queued for rocJpegGetCompletedJobs. When the descriptor is readable, read its 8-byte counter to reset
+ * it, then call rocJpegGetCompletedJobs until it returns fewer jobs than requested. The descriptor is owned by the
+ * handle and is closed by rocJpegDestroy.
+ *
+ * @param handle The rocJPEG handle.
+ * @param fd A pointer to store the file descriptor.
+ * @return ROCJPEG_STATUS_SUCCESS if successful, or an error code otherwise.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegGetCompletionFd(RocJpegHandle handle, int *fd);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegGetCompletedJobs(RocJpegHandle handle, RocJpegJobCompletion *completions, uint32_t *num_completions);
+ * @ingroup group_amd_rocjpeg
+ * @brief Retrieves the asynchronous decode jobs that have completed since rocJpegGetCompletionFd was first called.
+ *
+ * The completed jobs are removed from the queue of the handle and returned oldest first. Their statuses can still
+ * be retrieved by rocJpegQuery and rocJpegWait afterwards.
+ *
+ * @param handle The rocJPEG handle.
+ * @param completions An array that receives the completed jobs.
+ * @param num_completions On input, the number of elements of `completions`; on output, the number of completed jobs returned.
+ * @return ROCJPEG_STATUS_SUCCESS if successful, or an error code otherwise.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegGetCompletedJobs(RocJpegHandle handle, RocJpegJobCompletion *completions, uint32_t *num_completions);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegSetMemoryLimits(RocJpegHandle handle, const RocJpegMemoryLimits *memory_limits);
+ * @ingroup group_amd_rocjpeg
+ * @brief Sets the limits of the device memory held by the decoded surfaces that a rocJPEG handle keeps for reuse.
+ *
+ * A handle keeps the surfaces that the JPEG cores decode into for the following images, so by default the surfaces
+ * of the largest images decoded stay allocated until rocJpegDestroy. With a budget, the least recently used surfaces
+ * that are not in use are released whenever a new surface would take the handle over the budget, and right away if
+ * the handle is already over it. The surfaces of the images being decoded are never released, so the handle can
+ * exceed its budget while they are in use. With an idle timeout, the surfaces that are not used for longer than the
+ * timeout are released by the completion thread of the handle, which this call starts. The limits apply to each handle
+ * separately; to bound the memory used on a device, divide the budget of the device among its handles.
+ *
+ * When the surfaces of a decode do not fit in the budget and all the surfaces are in use, the surface acquire mode
+ * applies. By default, the surfaces are allocated anyway. With ROCJPEG_SURFACE_ACQUIRE_WAIT, the decode waits, up to
+ * the acquire timeout, for the asynchronous decode jobs in flight to release surfaces, and fails with
+ * ROCJPEG_STATUS_NOT_READY when the timeout expires. The waiting decode does not block the other threads using the
+ * handle, and the completion thread of the handle is started to advance the jobs in the meantime. With ROCJPEG_SURFACE_ACQUIRE_TRY, the decode fails with
+ * ROCJPEG_STATUS_NOT_READY right away, and can be retried once jobs have completed. A decode never waits or fails
+ * when no job is in flight, since no surface could be released, and a batch fails only before any of its images has
+ * been submitted; once started, the rest of the batch may exceed the budget.
+ *
+ * @param handle The rocJPEG handle.
+ * @param memory_limits The memory limits.
+ * @return ROCJPEG_STATUS_SUCCESS if successful, or an error code otherwise.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegSetMemoryLimits(RocJpegHandle handle, const RocJpegMemoryLimits *memory_limits);
+
+/**
+ * @fn RocJpegStatus ROCJPEGAPI rocJpegTrimMemory(RocJpegHandle handle);
+ * @ingroup group_amd_rocjpeg
+ * @brief Releases the decoded surfaces of a rocJPEG handle that are not in use.
+ *
+ * Only the surfaces of the asynchronous decode jobs still in flight are kept. This can be called, for example, before
+ * an application allocates a large amount of device memory for another task; the handle allocates surfaces again
+ * as it needs them.
+ *
+ * @param handle The rocJPEG handle.
+ * @return ROCJPEG_STATUS_SUCCESS if successful, or an error code otherwise.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegTrimMemory(RocJpegHandle handle);
+
 /**
  * @fn extern const char* ROCDECAPI rocJpegGetErrorName(RocJpegStatus rocjpeg_status);
  * @ingroup group_amd_rocjpeg
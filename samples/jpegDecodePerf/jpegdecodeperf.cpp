@@ -67,6 +67,9 @@ void DecodeImages(DecodeInfo &decode_info, RocJpegUtils rocjpeg_utils, RocJpegDe
     std::vector<RocJpegImage> output_images(batch_size);
     std::vector<std::string> base_file_names(batch_size);
     std::vector<RocJpegStreamHandle> rocjpeg_stream_handles(batch_size);
+    std::vector<const unsigned char*> batch_data(batch_size, nullptr);
+    std::vector<size_t> batch_lengths(batch_size, 0);
+    std::vector<RocJpegStatus> parse_statuses(batch_size, ROCJPEG_STATUS_SUCCESS);
     std::vector<uint32_t> temp_widths(ROCJPEG_MAX_COMPONENT, 0);
     std::vector<uint32_t> temp_heights(ROCJPEG_MAX_COMPONENT, 0);
     RocJpegChromaSubsampling temp_subsampling;
@@ -76,8 +79,6 @@ void DecodeImages(DecodeInfo &decode_info, RocJpegUtils rocjpeg_utils, RocJpegDe
         int batch_end = std::min(i + batch_size, static_cast<int>(decode_info.file_paths.size()));
         for (int j = i; j < batch_end; j++) {
             int index = j - i;
-
-            temp_base_file_name = decode_info.file_paths[j].substr(decode_info.file_paths[j].find_last_of("/\\") + 1);
             // Read an image from disk.
             std::ifstream input(decode_info.file_paths[j].c_str(), std::ios::in | std::ios::binary | std::ios::ate);
             if (!(input.is_open())) {
@@ -95,9 +96,18 @@ void DecodeImages(DecodeInfo &decode_info, RocJpegUtils rocjpeg_utils, RocJpegDe
                 std::cerr << "ERROR: Cannot read from file: " << decode_info.file_paths[j] << std::endl;
                 return;
             }
+            batch_data[index] = reinterpret_cast<uint8_t*>(batch_images[index].data());
+            batch_lengths[index] = file_size;
+        }
+
+        // Parse all the images of the batch in parallel.
+        rocJpegStreamParseBatched(batch_data.data(), batch_lengths.data(), decode_info.rocjpeg_stream_handles.data(), parse_statuses.data(), batch_end - i);
 
-            RocJpegStatus rocjpeg_status = rocJpegStreamParse(reinterpret_cast<uint8_t*>(batch_images[index].data()), file_size, decode_info.rocjpeg_stream_handles[index]);
-            if (rocjpeg_status != ROCJPEG_STATUS_SUCCESS) {
+        for (int j = i; j < batch_end; j++) {
+            int index = j - i;
+
+            temp_base_file_name = decode_info.file_paths[j].substr(decode_info.file_paths[j].find_last_of("/\\") + 1);
+            if (parse_statuses[index] != ROCJPEG_STATUS_SUCCESS) {
                 decode_info.num_bad_jpegs++;
                 std::cerr << "Skipping decoding input file: " << decode_info.file_paths[j] << std::endl;
                 continue;
@@ -209,7 +219,7 @@ int main(int argc, char **argv) {
     std::vector<std::string> file_paths = {};
     std::vector<DecodeInfo> decode_info_per_thread;
 
-    RocJpegUtils::ParseCommandLine(input_path, output_file_path, save_images, device_id, rocjpeg_backend, decode_params, &num_threads, &batch_size, argc, argv);
+    RocJpegUtils::ParseCommandLine(input_path, &output_file_path, &save_images, device_id, rocjpeg_backend, decode_params, &num_threads, &batch_size, argc, argv);
     if (!RocJpegUtils::GetFilePaths(input_path, file_paths, is_dir, is_file)) {
         std::cerr << "ERROR: Failed to get input file paths!" << std::endl;
         return EXIT_FAILURE;
@@ -0,0 +1,329 @@
+/*
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <sys/uio.h>
+#include "../rocjpeg_samples_utils.h"
+
+/**
+ * @brief The results of parsing a JPEG stream that must not depend on how the stream was passed to the parser.
+ */
+struct ParseResult {
+    RocJpegImageInfoExt image_info;
+    uint64_t content_hash;
+    RocJpegStreamMetadata metadata;
+    std::vector<uint8_t> icc_profile;
+    RocJpegStatus decode_status;
+    std::vector<uint8_t> rgb_image;
+};
+
+/**
+ * @brief Queries the image info, the content hash and the metadata of a parsed stream, and decodes it on the CPU.
+ *
+ * The ICC profile is copied, since it may point into a buffer owned by the stream handle. The stream is decoded
+ * into interleaved RGB with rocJpegDecodeHost; streams that it does not support only record the returned status.
+ *
+ * @param rocjpeg_stream_handle The handle to the parsed stream.
+ * @param parse_result Receives the results.
+ */
+void GetParseResult(RocJpegStreamHandle rocjpeg_stream_handle, ParseResult &parse_result) {
+    CHECK_ROCJPEG(rocJpegStreamGetImageInfoExt(rocjpeg_stream_handle, &parse_result.image_info));
+    CHECK_ROCJPEG(rocJpegStreamGetContentHash(rocjpeg_stream_handle, &parse_result.content_hash));
+    CHECK_ROCJPEG(rocJpegStreamGetMetadata(rocjpeg_stream_handle, &parse_result.metadata));
+    if (parse_result.metadata.icc_profile != nullptr) {
+        parse_result.icc_profile.assign(parse_result.metadata.icc_profile, parse_result.metadata.icc_profile + parse_result.metadata.icc_profile_size);
+    } else {
+        parse_result.icc_profile.clear();
+    }
+
+    RocJpegDecodeParams decode_params = {};
+    decode_params.output_format = ROCJPEG_OUTPUT_RGB;
+    RocJpegImage output_image = {};
+    uint32_t pitch = parse_result.image_info.width * 3;
+    parse_result.rgb_image.assign(static_cast<size_t>(pitch) * parse_result.image_info.height, 0);
+    output_image.channel[0] = parse_result.rgb_image.data();
+    output_image.pitch[0] = pitch;
+    parse_result.decode_status = rocJpegDecodeHost(rocjpeg_stream_handle, &decode_params, &output_image);
+    if (parse_result.decode_status != ROCJPEG_STATUS_SUCCESS) {
+        parse_result.rgb_image.clear();
+    }
+}
+
+/**
+ * @brief Compares the results of a parse with the results of the whole-buffer parse of the same stream.
+ *
+ * @param expected The results of the whole-buffer parse.
+ * @param actual The results to check.
+ * @param parse_name The name of the way the stream was parsed, printed on a mismatch.
+ * @param file_path The path of the image, printed on a mismatch.
+ * @return true if the results are the same.
+ */
+bool CompareParseResults(const ParseResult &expected, const ParseResult &actual, const std::string &parse_name, const std::string &file_path) {
+    const RocJpegImageInfoExt &e = expected.image_info;
+    const RocJpegImageInfoExt &a = actual.image_info;
+    std::string mismatch;
+    if (e.num_components != a.num_components || e.subsampling != a.subsampling || e.width != a.width || e.height != a.height ||
+        e.quality_factor != a.quality_factor || e.num_pixels != a.num_pixels || e.num_mcus != a.num_mcus ||
+        e.entropy_data_size != a.entropy_data_size || e.bytes_per_mcu != a.bytes_per_mcu || e.bits_per_pixel != a.bits_per_pixel ||
+        e.restart_interval != a.restart_interval || e.num_restart_intervals != a.num_restart_intervals) {
+        mismatch = "image info";
+    } else if (expected.content_hash != actual.content_hash) {
+        mismatch = "content hash";
+    } else if (expected.metadata.orientation != actual.metadata.orientation || expected.metadata.density_unit != actual.metadata.density_unit ||
+               expected.metadata.x_density != actual.metadata.x_density || expected.metadata.y_density != actual.metadata.y_density ||
+               expected.metadata.adobe_transform != actual.metadata.adobe_transform ||
+               expected.metadata.num_app_segments != actual.metadata.num_app_segments || expected.icc_profile != actual.icc_profile) {
+        mismatch = "metadata";
+    } else if (expected.decode_status != actual.decode_status || expected.rgb_image != actual.rgb_image) {
+        mismatch = "host-decoded image";
+    }
+    if (!mismatch.empty()) {
+        std::cerr << "ERROR: " << parse_name << ": the " << mismatch << " differs from the whole-buffer parse of " << file_path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the offsets that fall inside the markers of a stream: between the 0xFF prefix and the marker code,
+ * and between the two bytes of the length field of a marker segment.
+ *
+ * @param image The JPEG stream.
+ * @return The offsets, in increasing order.
+ */
+std::vector<size_t> GetMarkerSplitOffsets(const std::vector<char> &image) {
+    std::vector<size_t> offsets;
+    const uint8_t *data = reinterpret_cast<const uint8_t*>(image.data());
+    for (size_t i = 0; i + 1 < image.size(); i++) {
+        if (data[i] == 0xFF && data[i + 1] != 0x00 && data[i + 1] != 0xFF) {
+            offsets.push_back(i + 1);
+            if (i + 3 < image.size()) {
+                offsets.push_back(i + 3);
+            }
+        }
+    }
+    std::sort(offsets.begin(), offsets.end());
+    offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+    return offsets;
+}
+
+/**
+ * @brief Returns the offsets that fall inside the stuffed 0xFF00 byte pairs of the entropy-coded data of a stream.
+ *
+ * @param image The JPEG stream.
+ * @return The offsets, in increasing order.
+ */
+std::vector<size_t> GetStuffedByteSplitOffsets(const std::vector<char> &image) {
+    std::vector<size_t> offsets;
+    const uint8_t *data = reinterpret_cast<const uint8_t*>(image.data());
+    for (size_t i = 0; i + 1 < image.size(); i++) {
+        if (data[i] == 0xFF && data[i + 1] == 0x00) {
+            offsets.push_back(i + 1);
+        }
+    }
+    return offsets;
+}
+
+/**
+ * @brief Returns the offsets that split a stream into pieces of the same size.
+ *
+ * @param size The size of the stream.
+ * @param piece_size The size of the pieces.
+ * @return The offsets, in increasing order.
+ */
+std::vector<size_t> GetFixedSizeSplitOffsets(size_t size, size_t piece_size) {
+    std::vector<size_t> offsets;
+    for (size_t offset = piece_size; offset < size; offset += piece_size) {
+        offsets.push_back(offset);
+    }
+    return offsets;
+}
+
+/**
+ * @brief Parses a stream with rocJpegStreamParseChunk, in chunks that end at the specified offsets.
+ *
+ * @param image The JPEG stream.
+ * @param split_offsets The offsets at which the stream is split.
+ * @param rocjpeg_stream_handle The stream handle.
+ * @return true if the stream was parsed completely.
+ */
+bool ParseInChunks(const std::vector<char> &image, const std::vector<size_t> &split_offsets, RocJpegStreamHandle rocjpeg_stream_handle) {
+    const unsigned char *data = reinterpret_cast<const unsigned char*>(image.data());
+    RocJpegStreamParseState parse_state = ROCJPEG_STREAM_PARSE_NEED_MORE_DATA;
+    size_t chunk_start = 0;
+    for (size_t i = 0; i <= split_offsets.size(); i++) {
+        size_t chunk_end = i < split_offsets.size() ? split_offsets[i] : image.size();
+        int is_last_chunk = i == split_offsets.size();
+        if (rocJpegStreamParseChunk(data + chunk_start, chunk_end - chunk_start, is_last_chunk, rocjpeg_stream_handle, &parse_state) != ROCJPEG_STATUS_SUCCESS) {
+            return false;
+        }
+        chunk_start = chunk_end;
+        if (parse_state == ROCJPEG_STREAM_PARSE_COMPLETE) {
+            // The stream is complete once its EOI marker is received; a new stream would start with the next chunk.
+            break;
+        }
+    }
+    return parse_state == ROCJPEG_STREAM_PARSE_COMPLETE;
+}
+
+/**
+ * @brief Parses a stream with rocJpegStreamParseV, scattered over buffers that end at the specified offsets.
+ *
+ * An empty buffer is inserted at the start and at each split offset, since the parser must skip them.
+ *
+ * @param image The JPEG stream.
+ * @param split_offsets The offsets at which the stream is split.
+ * @param rocjpeg_stream_handle The stream handle.
+ * @return true if the stream was parsed.
+ */
+bool ParseScattered(std::vector<char> &image, const std::vector<size_t> &split_offsets, RocJpegStreamHandle rocjpeg_stream_handle) {
+    std::vector<struct iovec> iov;
+    size_t segment_start = 0;
+    for (size_t i = 0; i <= split_offsets.size(); i++) {
+        size_t segment_end = i < split_offsets.size() ? split_offsets[i] : image.size();
+        iov.push_back({image.data() + segment_start, 0});
+        iov.push_back({image.data() + segment_start, segment_end - segment_start});
+        segment_start = segment_end;
+    }
+    return rocJpegStreamParseV(iov.data(), static_cast<int>(iov.size()), rocjpeg_stream_handle) == ROCJPEG_STATUS_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+    int device_id = 0;
+    bool is_dir = false;
+    bool is_file = false;
+    uint64_t num_failed_checks = 0;
+    RocJpegBackend rocjpeg_backend = ROCJPEG_BACKEND_HARDWARE;
+    RocJpegDecodeParams decode_params = {};
+    RocJpegStreamHandle rocjpeg_stream_handle = nullptr;
+    RocJpegStreamHandle check_stream_handle = nullptr;
+    std::string input_path;
+    std::vector<std::string> file_paths = {};
+    std::vector<std::vector<char>> images;
+    std::vector<ParseResult> expected_results;
+
+    RocJpegUtils::ParseCommandLine(input_path, nullptr, nullptr, device_id, rocjpeg_backend, decode_params, nullptr, nullptr, argc, argv);
+    if (!RocJpegUtils::GetFilePaths(input_path, file_paths, is_dir, is_file)) {
+        std::cerr << "ERROR: Failed to get input file paths!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    CHECK_ROCJPEG(rocJpegStreamCreate(&rocjpeg_stream_handle));
+    CHECK_ROCJPEG(rocJpegStreamAcquire(&check_stream_handle));
+    std::vector<std::string> parsed_file_paths;
+    for (auto &file_path : file_paths) {
+        // Read an image from disk.
+        std::ifstream input(file_path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+        if (!(input.is_open())) {
+            std::cerr << "ERROR: Cannot open image: " << file_path << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::streamsize file_size = input.tellg();
+        input.seekg(0, std::ios::beg);
+        std::vector<char> image(file_size);
+        if (!input.read(image.data(), file_size)) {
+            std::cerr << "ERROR: Cannot read from file: " << file_path << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // The whole-buffer parse gives the expected results; the images it cannot parse are skipped.
+        if (rocJpegStreamParse(reinterpret_cast<uint8_t*>(image.data()), image.size(), rocjpeg_stream_handle) != ROCJPEG_STATUS_SUCCESS) {
+            std::cout << "Skipping the image that cannot be parsed: " << file_path << std::endl;
+            continue;
+        }
+        ParseResult expected_result, result;
+        GetParseResult(rocjpeg_stream_handle, expected_result);
+
+        std::vector<std::pair<std::string, std::vector<size_t>>> chunk_splits = {
+            {"chunks split inside the markers", GetMarkerSplitOffsets(image)},
+            {"chunks of 1 byte", GetFixedSizeSplitOffsets(image.size(), 1)},
+            {"chunks of 4093 bytes", GetFixedSizeSplitOffsets(image.size(), 4093)},
+        };
+        for (auto &chunk_split : chunk_splits) {
+            if (!ParseInChunks(image, chunk_split.second, check_stream_handle)) {
+                std::cerr << "ERROR: " << chunk_split.first << ": the stream was not parsed completely: " << file_path << std::endl;
+                num_failed_checks++;
+                continue;
+            }
+            GetParseResult(check_stream_handle, result);
+            num_failed_checks += !CompareParseResults(expected_result, result, chunk_split.first, file_path);
+        }
+
+        std::vector<std::pair<std::string, std::vector<size_t>>> iovec_splits = {
+            {"iovec split inside the stuffed bytes", GetStuffedByteSplitOffsets(image)},
+            {"iovec split inside the markers", GetMarkerSplitOffsets(image)},
+            {"iovec of 4093 bytes", GetFixedSizeSplitOffsets(image.size(), 4093)},
+        };
+        for (auto &iovec_split : iovec_splits) {
+            if (!ParseScattered(image, iovec_split.second, check_stream_handle)) {
+                std::cerr << "ERROR: " << iovec_split.first << ": the stream was not parsed: " << file_path << std::endl;
+                num_failed_checks++;
+                continue;
+            }
+            GetParseResult(check_stream_handle, result);
+            num_failed_checks += !CompareParseResults(expected_result, result, iovec_split.first, file_path);
+        }
+
+        parsed_file_paths.push_back(file_path);
+        images.push_back(std::move(image));
+        expected_results.push_back(std::move(expected_result));
+    }
+
+    // Concatenate the images, with a few bytes of padding between them, and locate them with rocJpegStreamSplit.
+    if (!images.empty()) {
+        std::vector<char> concatenated_images;
+        for (auto &image : images) {
+            concatenated_images.insert(concatenated_images.end(), image.begin(), image.end());
+            concatenated_images.insert(concatenated_images.end(), 3, 0);
+        }
+        const unsigned char *data = reinterpret_cast<const unsigned char*>(concatenated_images.data());
+        uint32_t num_image_spans = 0;
+        CHECK_ROCJPEG(rocJpegStreamSplit(data, concatenated_images.size(), nullptr, &num_image_spans));
+        std::vector<RocJpegImageSpan> image_spans(num_image_spans);
+        CHECK_ROCJPEG(rocJpegStreamSplit(data, concatenated_images.size(), image_spans.data(), &num_image_spans));
+        if (num_image_spans != images.size()) {
+            std::cerr << "ERROR: rocJpegStreamSplit located " << num_image_spans << " images instead of " << images.size() << std::endl;
+            num_failed_checks++;
+        } else {
+            for (uint32_t i = 0; i < num_image_spans; i++) {
+                ParseResult result;
+                if (rocJpegStreamParse(data + image_spans[i].offset, image_spans[i].length, check_stream_handle) != ROCJPEG_STATUS_SUCCESS) {
+                    std::cerr << "ERROR: split image: the stream was not parsed: " << parsed_file_paths[i] << std::endl;
+                    num_failed_checks++;
+                    continue;
+                }
+                GetParseResult(check_stream_handle, result);
+                num_failed_checks += !CompareParseResults(expected_results[i], result, "split image", parsed_file_paths[i]);
+            }
+        }
+    }
+
+    CHECK_ROCJPEG(rocJpegStreamRelease(check_stream_handle));
+    CHECK_ROCJPEG(rocJpegStreamDestroy(rocjpeg_stream_handle));
+
+    std::cout << "Checked " << images.size() << " images" << std::endl;
+    if (num_failed_checks) {
+        std::cout << "Total failed checks: " << num_failed_checks << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "Parse check completed!" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+/*
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "../rocjpeg_samples_utils.h"
+
+/**
+ * @brief The ways of obtaining a stream handle for each parse that are measured by this sample.
+ */
+enum ParseMode {
+    PARSE_MODE_CREATE_DESTROY = 0, /**< rocJpegStreamCreate and rocJpegStreamDestroy around each parse. */
+    PARSE_MODE_ACQUIRE_RELEASE = 1, /**< rocJpegStreamAcquire and rocJpegStreamRelease around each parse. */
+    PARSE_MODE_REUSE = 2, /**< A single stream handle reused for every parse. */
+    PARSE_MODE_COUNT = 3,
+};
+
+static const char *parse_mode_names[PARSE_MODE_COUNT] = {"create/parse/destroy", "acquire/parse/release", "reused handle"};
+
+struct ParseInfo {
+    std::vector<std::vector<char>> *images;
+    int num_iterations;
+    uint64_t num_parsed_images;
+    uint64_t num_bad_jpegs;
+    double total_parse_time_in_micro_sec;
+};
+
+/**
+ * @brief Parses all the images the specified number of times and measures the time taken.
+ *
+ * @param parse_info parameters info for parsing the images.
+ * @param parse_mode The way of obtaining the stream handle for each parse.
+ */
+void ParseImages(ParseInfo &parse_info, ParseMode parse_mode) {
+    RocJpegStreamHandle rocjpeg_stream_handle = nullptr;
+    if (parse_mode == PARSE_MODE_REUSE) {
+        CHECK_ROCJPEG(rocJpegStreamCreate(&rocjpeg_stream_handle));
+    }
+    auto start_time = std::chrono::high_resolution_clock::now();
+    for (int iter = 0; iter < parse_info.num_iterations; iter++) {
+        for (auto &image : *parse_info.images) {
+            if (parse_mode == PARSE_MODE_CREATE_DESTROY) {
+                CHECK_ROCJPEG(rocJpegStreamCreate(&rocjpeg_stream_handle));
+            } else if (parse_mode == PARSE_MODE_ACQUIRE_RELEASE) {
+                CHECK_ROCJPEG(rocJpegStreamAcquire(&rocjpeg_stream_handle));
+            }
+            if (rocJpegStreamParse(reinterpret_cast<uint8_t*>(image.data()), image.size(), rocjpeg_stream_handle) == ROCJPEG_STATUS_SUCCESS) {
+                parse_info.num_parsed_images++;
+            } else {
+                parse_info.num_bad_jpegs++;
+            }
+            if (parse_mode == PARSE_MODE_CREATE_DESTROY) {
+                CHECK_ROCJPEG(rocJpegStreamDestroy(rocjpeg_stream_handle));
+            } else if (parse_mode == PARSE_MODE_ACQUIRE_RELEASE) {
+                CHECK_ROCJPEG(rocJpegStreamRelease(rocjpeg_stream_handle));
+            }
+        }
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    parse_info.total_parse_time_in_micro_sec = std::chrono::duration<double, std::micro>(end_time - start_time).count();
+    if (parse_mode == PARSE_MODE_REUSE) {
+        CHECK_ROCJPEG(rocJpegStreamDestroy(rocjpeg_stream_handle));
+    }
+}
+
+int main(int argc, char **argv) {
+    int device_id = 0;
+    int num_threads = 1;
+    int num_iterations = 100;
+    bool is_dir = false;
+    bool is_file = false;
+    RocJpegBackend rocjpeg_backend = ROCJPEG_BACKEND_HARDWARE;
+    RocJpegDecodeParams decode_params = {};
+    std::string input_path;
+    std::vector<std::string> file_paths = {};
+    std::vector<std::vector<char>> images;
+
+    RocJpegUtils::ParseCommandLine(input_path, nullptr, nullptr, device_id, rocjpeg_backend, decode_params, &num_threads, nullptr, argc, argv);
+    if (!RocJpegUtils::GetFilePaths(input_path, file_paths, is_dir, is_file)) {
+        std::cerr << "ERROR: Failed to get input file paths!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    for (auto &file_path : file_paths) {
+        // Read an image from disk.
+        std::ifstream input(file_path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+        if (!(input.is_open())) {
+            std::cerr << "ERROR: Cannot open image: " << file_path << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::streamsize file_size = input.tellg();
+        input.seekg(0, std::ios::beg);
+        images.emplace_back(file_size);
+        if (!input.read(images.back().data(), file_size)) {
+            std::cerr << "ERROR: Cannot read from file: " << file_path << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cout << "Parsing " << images.size() << " images " << num_iterations << " times with " << num_threads << " threads, please wait!" << std::endl;
+    for (int mode = 0; mode < PARSE_MODE_COUNT; mode++) {
+        std::vector<ParseInfo> parse_info_per_thread(num_threads);
+        for (auto &parse_info : parse_info_per_thread) {
+            parse_info.images = &images;
+            parse_info.num_iterations = num_iterations;
+            parse_info.num_parsed_images = 0;
+            parse_info.num_bad_jpegs = 0;
+            parse_info.total_parse_time_in_micro_sec = 0;
+        }
+
+        ThreadPool thread_pool(num_threads);
+        for (int i = 0; i < num_threads; ++i) {
+            thread_pool.ExecuteJob(std::bind(ParseImages, std::ref(parse_info_per_thread[i]), static_cast<ParseMode>(mode)));
+        }
+        thread_pool.JoinThreads();
+
+        uint64_t total_parsed_images = 0;
+        uint64_t total_num_bad_jpegs = 0;
+        double total_parse_time_in_micro_sec = 0;
+        for (auto &parse_info : parse_info_per_thread) {
+            total_parsed_images += parse_info.num_parsed_images;
+            total_num_bad_jpegs += parse_info.num_bad_jpegs;
+            total_parse_time_in_micro_sec += parse_info.total_parse_time_in_micro_sec;
+        }
+        uint64_t total_parses = total_parsed_images + total_num_bad_jpegs;
+        double avg_time_per_parse = total_parses > 0 ? total_parse_time_in_micro_sec / total_parses : 0;
+        std::cout << std::left << std::setw(24) << parse_mode_names[mode] << " average time per parse (us): " << avg_time_per_parse;
+        if (total_num_bad_jpegs) {
+            std::cout << " ,total images that cannot be parsed: " << total_num_bad_jpegs;
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << "Parsing completed!" << std::endl;
+    return EXIT_SUCCESS;
+}
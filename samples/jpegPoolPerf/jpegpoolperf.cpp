@@ -0,0 +1,219 @@
+/*
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "../rocjpeg_samples_utils.h"
+
+/**
+ * @brief The number of asynchronous decode jobs kept in flight; each job holds one surface per image of its batch.
+ */
+static const int num_jobs_in_flight = 2;
+
+/**
+ * @brief The largest ratio between the number of entries of the memory pool and the number of surfaces in use.
+ */
+static const int max_pool_scale = 8;
+
+/**
+ * @brief An input image, parsed once and decoded by every job that references it.
+ */
+struct PoolPerfImage {
+    std::vector<char> data;
+    RocJpegStreamHandle rocjpeg_stream_handle;
+    RocJpegChromaSubsampling subsampling;
+    uint32_t widths[ROCJPEG_MAX_COMPONENT];
+    uint32_t heights[ROCJPEG_MAX_COMPONENT];
+};
+
+/**
+ * @brief Decodes the images with a memory pool of the specified size, and measures the average time per image.
+ *
+ * A new decoder handle is created, and its memory pool is first filled by a warm-up round of
+ * num_jobs_in_flight * pool_scale jobs in flight at once, which is not timed. The timed rounds then keep
+ * num_jobs_in_flight jobs of the same batch size in flight, each job waiting for the one submitted in its slot by the
+ * previous round, so the number of images in flight, and the work of the JPEG cores, is the same for every pool
+ * scale; only the number of idle entries the memory pool holds next to the surfaces in use changes.
+ *
+ * @param rocjpeg_backend The rocJPEG backend.
+ * @param device_id The GPU device ID.
+ * @param images The parsed input images.
+ * @param batch_size The number of images of each job.
+ * @param pool_scale The ratio between the number of entries of the memory pool and the number of surfaces in use.
+ * @param num_iterations The number of timed rounds.
+ * @param decode_params The decode parameters.
+ * @param rocjpeg_utils The sample utilities.
+ * @return The average time per image in microseconds.
+ */
+double DecodeImages(RocJpegBackend rocjpeg_backend, int device_id, std::vector<PoolPerfImage> &images, int batch_size, int pool_scale, int num_iterations, RocJpegDecodeParams &decode_params, RocJpegUtils &rocjpeg_utils) {
+    RocJpegHandle rocjpeg_handle = nullptr;
+    std::vector<std::vector<RocJpegStreamHandle>> job_stream_handles(num_jobs_in_flight, std::vector<RocJpegStreamHandle>(batch_size));
+    std::vector<std::vector<RocJpegImage>> job_output_images(num_jobs_in_flight, std::vector<RocJpegImage>(batch_size));
+    std::vector<uint64_t> job_ids(num_jobs_in_flight, 0);
+    uint32_t channel_sizes[ROCJPEG_MAX_COMPONENT] = {};
+    uint32_t num_channels = 0;
+
+    CHECK_ROCJPEG(rocJpegCreate(rocjpeg_backend, device_id, &rocjpeg_handle));
+    // Each image of each job has its own destination, since the jobs in flight write to them at the same time.
+    for (int j = 0; j < num_jobs_in_flight; j++) {
+        for (int b = 0; b < batch_size; b++) {
+            PoolPerfImage &image = images[(j * batch_size + b) % images.size()];
+            RocJpegImage &output_image = job_output_images[j][b];
+            output_image = {};
+            if (rocjpeg_utils.GetChannelPitchAndSizes(decode_params, image.subsampling, image.widths, image.heights, num_channels, output_image, channel_sizes)) {
+                std::cerr << "ERROR: Failed to get the channel pitch and sizes" << std::endl;
+                exit(1);
+            }
+            for (int n = 0; n < num_channels; n++) {
+                CHECK_HIP(hipMalloc(&output_image.channel[n], channel_sizes[n]));
+            }
+            job_stream_handles[j][b] = image.rocjpeg_stream_handle;
+        }
+    }
+
+    // The warm-up jobs hold pool_scale times as many surfaces as the timed jobs. Their decoded images are
+    // discarded, so the jobs of each slot share the destinations of the timed job of that slot.
+    std::vector<uint64_t> warm_up_job_ids(num_jobs_in_flight * pool_scale, 0);
+    for (int j = 0; j < num_jobs_in_flight * pool_scale; j++) {
+        int slot = j % num_jobs_in_flight;
+        CHECK_ROCJPEG(rocJpegDecodeBatchedAsync(rocjpeg_handle, job_stream_handles[slot].data(), batch_size, &decode_params, job_output_images[slot].data(), &warm_up_job_ids[j]));
+    }
+    for (auto warm_up_job_id : warm_up_job_ids) {
+        CHECK_ROCJPEG(rocJpegWait(rocjpeg_handle, warm_up_job_id));
+    }
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    for (int iter = 0; iter < num_iterations; iter++) {
+        for (int j = 0; j < num_jobs_in_flight; j++) {
+            if (job_ids[j] != 0) {
+                CHECK_ROCJPEG(rocJpegWait(rocjpeg_handle, job_ids[j]));
+            }
+            CHECK_ROCJPEG(rocJpegDecodeBatchedAsync(rocjpeg_handle, job_stream_handles[j].data(), batch_size, &decode_params, job_output_images[j].data(), &job_ids[j]));
+        }
+    }
+    for (int j = 0; j < num_jobs_in_flight; j++) {
+        CHECK_ROCJPEG(rocJpegWait(rocjpeg_handle, job_ids[j]));
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    double total_decode_time_in_micro_sec = std::chrono::duration<double, std::micro>(end_time - start_time).count();
+
+    CHECK_ROCJPEG(rocJpegDestroy(rocjpeg_handle));
+    for (auto &output_images : job_output_images) {
+        for (auto &output_image : output_images) {
+            for (int i = 0; i < ROCJPEG_MAX_COMPONENT; i++) {
+                if (output_image.channel[i] != nullptr) {
+                    CHECK_HIP(hipFree((void *)output_image.channel[i]));
+                    output_image.channel[i] = nullptr;
+                }
+            }
+        }
+    }
+    return total_decode_time_in_micro_sec / (static_cast<double>(num_iterations) * num_jobs_in_flight * batch_size);
+}
+
+int main(int argc, char **argv) {
+    int device_id = 0;
+    int batch_size = 2;
+    int num_iterations = 20;
+    bool is_dir = false;
+    bool is_file = false;
+    uint8_t num_components;
+    uint64_t num_skipped_images = 0;
+    RocJpegBackend rocjpeg_backend = ROCJPEG_BACKEND_HARDWARE;
+    RocJpegHandle rocjpeg_handle = nullptr;
+    RocJpegDecodeParams decode_params = {};
+    RocJpegUtils rocjpeg_utils;
+    std::string input_path;
+    std::vector<std::string> file_paths = {};
+    std::vector<PoolPerfImage> images;
+
+    RocJpegUtils::ParseCommandLine(input_path, nullptr, nullptr, device_id, rocjpeg_backend, decode_params, nullptr, &batch_size, argc, argv);
+    if (batch_size <= 0) {
+        std::cerr << "ERROR: The batch size must be positive!" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!RocJpegUtils::GetFilePaths(input_path, file_paths, is_dir, is_file)) {
+        std::cerr << "ERROR: Failed to get input file paths!" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!RocJpegUtils::InitHipDevice(device_id)) {
+        std::cerr << "ERROR: Failed to initialize HIP!" << std::endl;
+        return EXIT_FAILURE;
+    }
+    CHECK_ROCJPEG(rocJpegCreate(rocjpeg_backend, device_id, &rocjpeg_handle));
+
+    images.reserve(file_paths.size());
+    for (auto &file_path : file_paths) {
+        // Read an image from disk.
+        std::ifstream input(file_path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+        if (!(input.is_open())) {
+            std::cerr << "ERROR: Cannot open image: " << file_path << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::streamsize file_size = input.tellg();
+        input.seekg(0, std::ios::beg);
+        PoolPerfImage image = {};
+        image.data.resize(file_size);
+        if (!input.read(image.data.data(), file_size)) {
+            std::cerr << "ERROR: Cannot read from file: " << file_path << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        CHECK_ROCJPEG(rocJpegStreamCreate(&image.rocjpeg_stream_handle));
+        if (rocJpegStreamParse(reinterpret_cast<uint8_t*>(image.data.data()), image.data.size(), image.rocjpeg_stream_handle) != ROCJPEG_STATUS_SUCCESS) {
+            CHECK_ROCJPEG(rocJpegStreamDestroy(image.rocjpeg_stream_handle));
+            num_skipped_images++;
+            continue;
+        }
+        CHECK_ROCJPEG(rocJpegGetImageInfo(rocjpeg_handle, image.rocjpeg_stream_handle, &num_components, &image.subsampling, image.widths, image.heights));
+        // Skip the images the VCN hardware cannot decode, as the other samples do.
+        if (image.widths[0] < 64 || image.heights[0] < 64 || image.subsampling == ROCJPEG_CSS_411 || image.subsampling == ROCJPEG_CSS_UNKNOWN) {
+            CHECK_ROCJPEG(rocJpegStreamDestroy(image.rocjpeg_stream_handle));
+            num_skipped_images++;
+            continue;
+        }
+        images.push_back(std::move(image));
+    }
+    if (num_skipped_images) {
+        std::cout << "Total skipped images: " << num_skipped_images << std::endl;
+    }
+    if (images.empty()) {
+        std::cerr << "ERROR: No image can be decoded!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Each pool scale creates its own decoder handle, so that its memory pool starts empty.
+    CHECK_ROCJPEG(rocJpegDestroy(rocjpeg_handle));
+
+    int num_images_in_flight = num_jobs_in_flight * batch_size;
+    std::cout << "Decoding " << num_images_in_flight << " images at a time " << num_iterations << " times with " << num_jobs_in_flight << " jobs in flight, please wait!" << std::endl;
+    for (int pool_scale = 1; pool_scale <= max_pool_scale; pool_scale *= 2) {
+        double avg_time_per_image = DecodeImages(rocjpeg_backend, device_id, images, batch_size, pool_scale, num_iterations, decode_params, rocjpeg_utils);
+        std::cout << "pool scale: " << std::left << std::setw(3) << pool_scale << " surfaces held by the warm-up: " << std::setw(6) << num_images_in_flight * pool_scale
+                  << " average time per image (us): " << avg_time_per_image << std::endl;
+    }
+
+    for (auto &image : images) {
+        CHECK_ROCJPEG(rocJpegStreamDestroy(image.rocjpeg_stream_handle));
+    }
+
+    std::cout << "Decoding completed!" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -76,8 +76,8 @@ public:
      * This function parses the command line arguments and sets the corresponding variables.
      *
      * @param input_path The input path.
-     * @param output_file_path The output file path.
-     * @param save_images Flag indicating whether to save images.
+     * @param output_file_path The output file path, or nullptr if the sample does not write its output (-o is rejected).
+     * @param save_images Flag indicating whether to save images, or nullptr if the sample does not write its output.
      * @param device_id The device ID.
      * @param rocjpeg_backend The rocJPEG backend.
      * @param decode_params The rocJPEG decode parameters.
@@ -86,7 +86,7 @@ public:
      * @param argc The number of command line arguments.
      * @param argv The command line arguments.
      */
-    static void ParseCommandLine(std::string &input_path, std::string &output_file_path, bool &save_images, int &device_id,
+    static void ParseCommandLine(std::string &input_path, std::string *output_file_path, bool *save_images, int &device_id,
                                  RocJpegBackend &rocjpeg_backend, RocJpegDecodeParams &decode_params, int *num_threads, int *batch_size, int argc, char *argv[]) {
         if(argc <= 1) {
             ShowHelpAndExit("", num_threads != nullptr, batch_size != nullptr);
@@ -103,11 +103,11 @@ public:
                 continue;
             }
             if (!strcmp(argv[i], "-o")) {
-                if (++i == argc) {
+                if (++i == argc || output_file_path == nullptr || save_images == nullptr) {
                     ShowHelpAndExit("-o", num_threads != nullptr, batch_size != nullptr);
                 }
-                output_file_path = argv[i];
-                save_images = true;
+                *output_file_path = argv[i];
+                *save_images = true;
                 continue;
             }
             if (!strcmp(argv[i], "-d")) {
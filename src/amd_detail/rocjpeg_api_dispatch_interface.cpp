@@ -52,4 +52,67 @@ RocJpegStatus ROCJPEGAPI rocJpegDecodeBatched(RocJpegHandle handle, RocJpegStrea
 }
 const char* ROCJPEGAPI rocJpegGetErrorName(RocJpegStatus rocjpeg_status) {
     return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_get_error_name(rocjpeg_status);
+}
+RocJpegStatus ROCJPEGAPI rocJpegStreamParseBatched(const unsigned char * const *data, const size_t *lengths, RocJpegStreamHandle *jpeg_stream_handles, RocJpegStatus *statuses, int batch_size) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_stream_parse_batched(data, lengths, jpeg_stream_handles, statuses, batch_size);
+}
+RocJpegStatus ROCJPEGAPI rocJpegStreamParseChunk(const unsigned char *data, size_t length, int is_last_chunk, RocJpegStreamHandle jpeg_stream_handle, RocJpegStreamParseState *parse_state) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_stream_parse_chunk(data, length, is_last_chunk, jpeg_stream_handle, parse_state);
+}
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetMetadata(RocJpegStreamHandle jpeg_stream_handle, RocJpegStreamMetadata *metadata) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_stream_get_metadata(jpeg_stream_handle, metadata);
+}
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetAppSegments(RocJpegStreamHandle jpeg_stream_handle, RocJpegAppSegment *app_segments, uint32_t *num_app_segments) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_stream_get_app_segments(jpeg_stream_handle, app_segments, num_app_segments);
+}
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetThumbnail(RocJpegStreamHandle jpeg_stream_handle, const unsigned char **data, size_t *length) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_stream_get_thumbnail(jpeg_stream_handle, data, length);
+}
+RocJpegStatus ROCJPEGAPI rocJpegDecodeHost(RocJpegStreamHandle jpeg_stream_handle, const RocJpegDecodeParams *decode_params, RocJpegImage *destination) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_decode_host(jpeg_stream_handle, decode_params, destination);
+}
+RocJpegStatus ROCJPEGAPI rocJpegStreamSplit(const unsigned char *data, size_t length, RocJpegImageSpan *image_spans, uint32_t *num_image_spans) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_stream_split(data, length, image_spans, num_image_spans);
+}
+RocJpegStatus ROCJPEGAPI rocJpegStreamAcquire(RocJpegStreamHandle *jpeg_stream_handle) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_stream_acquire(jpeg_stream_handle);
+}
+RocJpegStatus ROCJPEGAPI rocJpegStreamRelease(RocJpegStreamHandle jpeg_stream_handle) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_stream_release(jpeg_stream_handle);
+}
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetImageInfoExt(RocJpegStreamHandle jpeg_stream_handle, RocJpegImageInfoExt *image_info) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_stream_get_image_info_ext(jpeg_stream_handle, image_info);
+}
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetContentHash(RocJpegStreamHandle jpeg_stream_handle, uint64_t *hash) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_stream_get_content_hash(jpeg_stream_handle, hash);
+}
+RocJpegStatus ROCJPEGAPI rocJpegStreamParseV(const struct iovec *iov, int iovcnt, RocJpegStreamHandle jpeg_stream_handle) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_stream_parse_v(iov, iovcnt, jpeg_stream_handle);
+}
+RocJpegStatus ROCJPEGAPI rocJpegDecodeAsync(RocJpegHandle handle, RocJpegStreamHandle jpeg_stream_handle, const RocJpegDecodeParams *decode_params, RocJpegImage *destination, uint64_t *job_id) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_decode_async(handle, jpeg_stream_handle, decode_params, destination, job_id);
+}
+RocJpegStatus ROCJPEGAPI rocJpegDecodeBatchedAsync(RocJpegHandle handle, RocJpegStreamHandle *jpeg_stream_handles, int batch_size, const RocJpegDecodeParams *decode_params, RocJpegImage *destinations, uint64_t *job_id) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_decode_batched_async(handle, jpeg_stream_handles, batch_size, decode_params, destinations, job_id);
+}
+RocJpegStatus ROCJPEGAPI rocJpegQuery(RocJpegHandle handle, uint64_t job_id) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_query(handle, job_id);
+}
+RocJpegStatus ROCJPEGAPI rocJpegWait(RocJpegHandle handle, uint64_t job_id) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_wait(handle, job_id);
+}
+RocJpegStatus ROCJPEGAPI rocJpegSetJobCallback(RocJpegHandle handle, uint64_t job_id, RocJpegJobCallback callback, void *user_data) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_set_job_callback(handle, job_id, callback, user_data);
+}
+RocJpegStatus ROCJPEGAPI rocJpegGetCompletionFd(RocJpegHandle handle, int *fd) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_get_completion_fd(handle, fd);
+}
+RocJpegStatus ROCJPEGAPI rocJpegGetCompletedJobs(RocJpegHandle handle, RocJpegJobCompletion *completions, uint32_t *num_completions) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_get_completed_jobs(handle, completions, num_completions);
+}
+RocJpegStatus ROCJPEGAPI rocJpegSetMemoryLimits(RocJpegHandle handle, const RocJpegMemoryLimits *memory_limits) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_set_memory_limits(handle, memory_limits);
+}
+RocJpegStatus ROCJPEGAPI rocJpegTrimMemory(RocJpegHandle handle) {
+    return rocjpeg::GetRocJpegDispatchTable()->pfn_rocjpeg_trim_memory(handle);
 }
\ No newline at end of file
@@ -43,6 +43,27 @@ RocJpegStatus ROCJPEGAPI rocJpegGetImageInfo(RocJpegHandle handle, RocJpegStream
 RocJpegStatus ROCJPEGAPI rocJpegDecode(RocJpegHandle handle, RocJpegStreamHandle jpeg_stream_handle, const RocJpegDecodeParams *decode_params, RocJpegImage *destination);
 RocJpegStatus ROCJPEGAPI rocJpegDecodeBatched(RocJpegHandle handle, RocJpegStreamHandle *jpeg_stream_handles, int batch_size, const RocJpegDecodeParams *decode_params, RocJpegImage *destinations);
 const char* ROCJPEGAPI rocJpegGetErrorName(RocJpegStatus rocjpeg_status);
+RocJpegStatus ROCJPEGAPI rocJpegStreamParseBatched(const unsigned char * const *data, const size_t *lengths, RocJpegStreamHandle *jpeg_stream_handles, RocJpegStatus *statuses, int batch_size);
+RocJpegStatus ROCJPEGAPI rocJpegStreamParseChunk(const unsigned char *data, size_t length, int is_last_chunk, RocJpegStreamHandle jpeg_stream_handle, RocJpegStreamParseState *parse_state);
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetMetadata(RocJpegStreamHandle jpeg_stream_handle, RocJpegStreamMetadata *metadata);
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetAppSegments(RocJpegStreamHandle jpeg_stream_handle, RocJpegAppSegment *app_segments, uint32_t *num_app_segments);
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetThumbnail(RocJpegStreamHandle jpeg_stream_handle, const unsigned char **data, size_t *length);
+RocJpegStatus ROCJPEGAPI rocJpegDecodeHost(RocJpegStreamHandle jpeg_stream_handle, const RocJpegDecodeParams *decode_params, RocJpegImage *destination);
+RocJpegStatus ROCJPEGAPI rocJpegStreamSplit(const unsigned char *data, size_t length, RocJpegImageSpan *image_spans, uint32_t *num_image_spans);
+RocJpegStatus ROCJPEGAPI rocJpegStreamAcquire(RocJpegStreamHandle *jpeg_stream_handle);
+RocJpegStatus ROCJPEGAPI rocJpegStreamRelease(RocJpegStreamHandle jpeg_stream_handle);
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetImageInfoExt(RocJpegStreamHandle jpeg_stream_handle, RocJpegImageInfoExt *image_info);
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetContentHash(RocJpegStreamHandle jpeg_stream_handle, uint64_t *hash);
+RocJpegStatus ROCJPEGAPI rocJpegStreamParseV(const struct iovec *iov, int iovcnt, RocJpegStreamHandle jpeg_stream_handle);
+RocJpegStatus ROCJPEGAPI rocJpegDecodeAsync(RocJpegHandle handle, RocJpegStreamHandle jpeg_stream_handle, const RocJpegDecodeParams *decode_params, RocJpegImage *destination, uint64_t *job_id);
+RocJpegStatus ROCJPEGAPI rocJpegDecodeBatchedAsync(RocJpegHandle handle, RocJpegStreamHandle *jpeg_stream_handles, int batch_size, const RocJpegDecodeParams *decode_params, RocJpegImage *destinations, uint64_t *job_id);
+RocJpegStatus ROCJPEGAPI rocJpegQuery(RocJpegHandle handle, uint64_t job_id);
+RocJpegStatus ROCJPEGAPI rocJpegWait(RocJpegHandle handle, uint64_t job_id);
+RocJpegStatus ROCJPEGAPI rocJpegSetJobCallback(RocJpegHandle handle, uint64_t job_id, RocJpegJobCallback callback, void *user_data);
+RocJpegStatus ROCJPEGAPI rocJpegGetCompletionFd(RocJpegHandle handle, int *fd);
+RocJpegStatus ROCJPEGAPI rocJpegGetCompletedJobs(RocJpegHandle handle, RocJpegJobCompletion *completions, uint32_t *num_completions);
+RocJpegStatus ROCJPEGAPI rocJpegSetMemoryLimits(RocJpegHandle handle, const RocJpegMemoryLimits *memory_limits);
+RocJpegStatus ROCJPEGAPI rocJpegTrimMemory(RocJpegHandle handle);
 }
 
 namespace rocjpeg {
@@ -58,6 +79,27 @@ void UpdateDispatchTable(RocJpegDispatchTable* ptr_dispatch_table) {
     ptr_dispatch_table->pfn_rocjpeg_decode = rocjpeg::rocJpegDecode;
     ptr_dispatch_table->pfn_rocjpeg_decode_batched = rocjpeg::rocJpegDecodeBatched;
     ptr_dispatch_table->pfn_rocjpeg_get_error_name = rocjpeg::rocJpegGetErrorName;
+    ptr_dispatch_table->pfn_rocjpeg_stream_parse_batched = rocjpeg::rocJpegStreamParseBatched;
+    ptr_dispatch_table->pfn_rocjpeg_stream_parse_chunk = rocjpeg::rocJpegStreamParseChunk;
+    ptr_dispatch_table->pfn_rocjpeg_stream_get_metadata = rocjpeg::rocJpegStreamGetMetadata;
+    ptr_dispatch_table->pfn_rocjpeg_stream_get_app_segments = rocjpeg::rocJpegStreamGetAppSegments;
+    ptr_dispatch_table->pfn_rocjpeg_stream_get_thumbnail = rocjpeg::rocJpegStreamGetThumbnail;
+    ptr_dispatch_table->pfn_rocjpeg_decode_host = rocjpeg::rocJpegDecodeHost;
+    ptr_dispatch_table->pfn_rocjpeg_stream_split = rocjpeg::rocJpegStreamSplit;
+    ptr_dispatch_table->pfn_rocjpeg_stream_acquire = rocjpeg::rocJpegStreamAcquire;
+    ptr_dispatch_table->pfn_rocjpeg_stream_release = rocjpeg::rocJpegStreamRelease;
+    ptr_dispatch_table->pfn_rocjpeg_stream_get_image_info_ext = rocjpeg::rocJpegStreamGetImageInfoExt;
+    ptr_dispatch_table->pfn_rocjpeg_stream_get_content_hash = rocjpeg::rocJpegStreamGetContentHash;
+    ptr_dispatch_table->pfn_rocjpeg_stream_parse_v = rocjpeg::rocJpegStreamParseV;
+    ptr_dispatch_table->pfn_rocjpeg_decode_async = rocjpeg::rocJpegDecodeAsync;
+    ptr_dispatch_table->pfn_rocjpeg_decode_batched_async = rocjpeg::rocJpegDecodeBatchedAsync;
+    ptr_dispatch_table->pfn_rocjpeg_query = rocjpeg::rocJpegQuery;
+    ptr_dispatch_table->pfn_rocjpeg_wait = rocjpeg::rocJpegWait;
+    ptr_dispatch_table->pfn_rocjpeg_set_job_callback = rocjpeg::rocJpegSetJobCallback;
+    ptr_dispatch_table->pfn_rocjpeg_get_completion_fd = rocjpeg::rocJpegGetCompletionFd;
+    ptr_dispatch_table->pfn_rocjpeg_get_completed_jobs = rocjpeg::rocJpegGetCompletedJobs;
+    ptr_dispatch_table->pfn_rocjpeg_set_memory_limits = rocjpeg::rocJpegSetMemoryLimits;
+    ptr_dispatch_table->pfn_rocjpeg_trim_memory = rocjpeg::rocJpegTrimMemory;
 }
 
 #if ROCJPEG_ROCPROFILER_REGISTER > 0
@@ -149,14 +191,47 @@ ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_get_image_info, 5)
 ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_decode, 6)
 ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_decode_batched, 7)
 ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_get_error_name, 8)
+// ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 1
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_stream_parse_batched, 9)
+// ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 2
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_stream_parse_chunk, 10)
+// ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 3
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_stream_get_metadata, 11)
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_stream_get_app_segments, 12)
+// ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 4
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_stream_get_thumbnail, 13)
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_decode_host, 14)
+// ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 5
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_stream_split, 15)
+// ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 6
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_stream_acquire, 16)
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_stream_release, 17)
+// ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 7
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_stream_get_image_info_ext, 18)
+// ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 8
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_stream_get_content_hash, 19)
+// ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 9
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_stream_parse_v, 20)
+// ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 10
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_decode_async, 21)
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_decode_batched_async, 22)
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_query, 23)
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_wait, 24)
+// ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 11
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_set_job_callback, 25)
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_get_completion_fd, 26)
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_get_completed_jobs, 27)
+// ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 12
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_set_memory_limits, 28)
+ROCJPEG_ENFORCE_ABI(RocJpegDispatchTable, pfn_rocjpeg_trim_memory, 29)
 
 // If ROCJPEG_ENFORCE_ABI entries are added for each new function pointer in the table,
 // the number below will be one greater than the number in the last ROCJPEG_ENFORCE_ABI line. For example:
 //  ROCJPEG_ENFORCE_ABI(<table>, <functor>, 8)
 //  ROCJPEG_ENFORCE_ABI_VERSIONING(<table>, 9) <- 8 + 1 = 9
-ROCJPEG_ENFORCE_ABI_VERSIONING(RocJpegDispatchTable, 9)
+ROCJPEG_ENFORCE_ABI_VERSIONING(RocJpegDispatchTable, 30)
 
-static_assert(ROCJPEG_RUNTIME_API_TABLE_MAJOR_VERSION == 0 && ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 0,
+static_assert(ROCJPEG_RUNTIME_API_TABLE_MAJOR_VERSION == 0 && ROCJPEG_RUNTIME_API_TABLE_STEP_VERSION == 12,
               "If you encounter this error, add the new ROCJPEG_ENFORCE_ABI(...) code for the updated function pointers, "
               "and then modify this check to ensure it evaluates to true.");
 #endif
\ No newline at end of file
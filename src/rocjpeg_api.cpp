@@ -23,6 +23,9 @@ THE SOFTWARE.
 #include "rocjpeg_api_stream_handle.h"
 #include "rocjpeg_api_decoder_handle.h"
 #include "rocjpeg_commons.h"
+#include "rocjpeg_thread_pool.h"
+#include "rocjpeg_cpu_decoder.h"
+#include "rocjpeg_stream_handle_pool.h"
 
 namespace rocjpeg {
 /**
@@ -77,18 +80,394 @@ RocJpegStatus ROCJPEGAPI rocJpegStreamParse(const unsigned char *data, size_t le
     return ROCJPEG_STATUS_SUCCESS;
 }
 
+/**
+ * @brief Parses a JPEG stream that is scattered over several buffers.
+ *
+ * @param iov The array of buffers of the JPEG stream, in order.
+ * @param iovcnt The number of buffers.
+ * @param jpeg_stream_handle The handle to the JPEG stream.
+ * @return The status of the JPEG stream parsing operation.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamParseV(const struct iovec *iov, int iovcnt, RocJpegStreamHandle jpeg_stream_handle) {
+    if (iov == nullptr || iovcnt <= 0 || jpeg_stream_handle == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    auto rocjpeg_stream_handle = static_cast<RocJpegStreamParserHandle*>(jpeg_stream_handle);
+    if (!rocjpeg_stream_handle->rocjpeg_stream->ParseJpegStreamV(iov, iovcnt)) {
+        return ROCJPEG_STATUS_BAD_JPEG;
+    }
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Parses a batch of JPEG streams in parallel.
+ *
+ * This function parses each of the `batch_size` JPEG streams into its own stream handle. The streams are
+ * distributed dynamically over the process-wide parser thread pool and the calling thread, so a few large
+ * streams in the batch do not leave the other threads idle.
+ *
+ * @param data An array of pointers to the JPEG stream data.
+ * @param lengths An array of lengths of the JPEG stream data.
+ * @param jpeg_stream_handles An array of handles to the JPEG streams.
+ * @param statuses An optional array that receives the status of each stream's parsing.
+ * @param batch_size The number of JPEG streams in the batch.
+ * @return The status of the batched parsing operation.
+ *         - ROCJPEG_STATUS_SUCCESS if all the streams are parsed successfully.
+ *         - ROCJPEG_STATUS_INVALID_PARAMETER if the input parameters are invalid.
+ *         - The status of the first stream that failed to parse otherwise.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamParseBatched(const unsigned char * const *data, const size_t *lengths, RocJpegStreamHandle *jpeg_stream_handles, RocJpegStatus *statuses, int batch_size) {
+    if (data == nullptr || lengths == nullptr || jpeg_stream_handles == nullptr || batch_size < 1) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    std::vector<RocJpegStatus> batch_statuses(batch_size, ROCJPEG_STATUS_SUCCESS);
+    RocJpegThreadPool::GetParserThreadPool().ParallelFor(static_cast<uint32_t>(batch_size), [&](uint32_t i) {
+        if (data[i] == nullptr || jpeg_stream_handles[i] == nullptr) {
+            batch_statuses[i] = ROCJPEG_STATUS_INVALID_PARAMETER;
+            return;
+        }
+        auto rocjpeg_stream_handle = static_cast<RocJpegStreamParserHandle*>(jpeg_stream_handles[i]);
+        try {
+            if (!rocjpeg_stream_handle->rocjpeg_stream->ParseJpegStream(data[i], lengths[i])) {
+                batch_statuses[i] = ROCJPEG_STATUS_BAD_JPEG;
+            }
+        } catch (const std::exception& e) {
+            rocjpeg_stream_handle->CaptureError(e.what());
+            batch_statuses[i] = ROCJPEG_STATUS_RUNTIME_ERROR;
+        }
+    });
+
+    RocJpegStatus rocjpeg_status = ROCJPEG_STATUS_SUCCESS;
+    for (int i = 0; i < batch_size; i++) {
+        if (statuses != nullptr) {
+            statuses[i] = batch_statuses[i];
+        }
+        if (rocjpeg_status == ROCJPEG_STATUS_SUCCESS) {
+            rocjpeg_status = batch_statuses[i];
+        }
+    }
+    return rocjpeg_status;
+}
+
+/**
+ * @brief Parses the next chunk of a JPEG stream.
+ *
+ * This function appends the chunk to the buffer of the JPEG stream handle and parses the headers that are complete.
+ *
+ * @param data The pointer to the chunk of the JPEG stream data.
+ * @param length The length of the chunk.
+ * @param is_last_chunk Nonzero if this chunk is the last one of the JPEG stream.
+ * @param jpeg_stream_handle The handle to the JPEG stream.
+ * @param parse_state Receives the progress of the parse.
+ * @return The status of the JPEG stream parsing operation.
+ *         - ROCJPEG_STATUS_SUCCESS if the chunk is parsed successfully.
+ *         - ROCJPEG_STATUS_INVALID_PARAMETER if the input parameters are invalid.
+ *         - ROCJPEG_STATUS_BAD_JPEG if the JPEG stream is invalid.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamParseChunk(const unsigned char *data, size_t length, int is_last_chunk, RocJpegStreamHandle jpeg_stream_handle, RocJpegStreamParseState *parse_state) {
+    if ((data == nullptr && length > 0) || jpeg_stream_handle == nullptr || parse_state == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    auto rocjpeg_stream_handle = static_cast<RocJpegStreamParserHandle*>(jpeg_stream_handle);
+    JpegChunkParseState chunk_parse_state = CHUNK_PARSE_NEED_MORE_DATA;
+    try {
+        if (!rocjpeg_stream_handle->rocjpeg_stream->ParseJpegStreamChunk(data, length, is_last_chunk != 0, &chunk_parse_state)) {
+            return ROCJPEG_STATUS_BAD_JPEG;
+        }
+    } catch (const std::exception& e) {
+        rocjpeg_stream_handle->CaptureError(e.what());
+        ERR(e.what());
+        return ROCJPEG_STATUS_RUNTIME_ERROR;
+    }
+    *parse_state = static_cast<RocJpegStreamParseState>(chunk_parse_state);
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Retrieves the metadata of a parsed JPEG stream.
+ *
+ * This function returns the metadata collected from the application segments while parsing the JPEG stream.
+ *
+ * @param jpeg_stream_handle The handle to the parsed JPEG stream.
+ * @param metadata Receives the metadata of the JPEG stream.
+ * @return The status of the operation.
+ *         - ROCJPEG_STATUS_SUCCESS if the metadata is retrieved successfully.
+ *         - ROCJPEG_STATUS_INVALID_PARAMETER if the input parameters are invalid.
+ *         - ROCJPEG_STATUS_BAD_JPEG if a chunk of the ICC profile is missing.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetMetadata(RocJpegStreamHandle jpeg_stream_handle, RocJpegStreamMetadata *metadata) {
+    if (jpeg_stream_handle == nullptr || metadata == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    auto rocjpeg_stream_handle = static_cast<RocJpegStreamParserHandle*>(jpeg_stream_handle);
+    const JpegStreamMetadata *jpeg_stream_metadata = rocjpeg_stream_handle->rocjpeg_stream->GetJpegStreamMetadata();
+    *metadata = {};
+    metadata->orientation = jpeg_stream_metadata->exif_orientation;
+    metadata->density_unit = jpeg_stream_metadata->jfif_density_unit;
+    metadata->x_density = jpeg_stream_metadata->jfif_x_density;
+    metadata->y_density = jpeg_stream_metadata->jfif_y_density;
+    metadata->adobe_transform = jpeg_stream_metadata->adobe_transform;
+    metadata->num_app_segments = static_cast<uint32_t>(jpeg_stream_metadata->app_segments.size());
+    if (!rocjpeg_stream_handle->rocjpeg_stream->GetIccProfile(&metadata->icc_profile, &metadata->icc_profile_size)) {
+        return ROCJPEG_STATUS_BAD_JPEG;
+    }
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Retrieves the locations of the application segments of a parsed JPEG stream.
+ *
+ * @param jpeg_stream_handle The handle to the parsed JPEG stream.
+ * @param app_segments An array that receives the segments, or nullptr to query the number of segments.
+ * @param num_app_segments The number of elements of app_segments; receives the number of segments.
+ * @return The status of the operation.
+ *         - ROCJPEG_STATUS_SUCCESS if the segments are retrieved successfully.
+ *         - ROCJPEG_STATUS_INVALID_PARAMETER if the input parameters are invalid.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetAppSegments(RocJpegStreamHandle jpeg_stream_handle, RocJpegAppSegment *app_segments, uint32_t *num_app_segments) {
+    if (jpeg_stream_handle == nullptr || num_app_segments == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    auto rocjpeg_stream_handle = static_cast<RocJpegStreamParserHandle*>(jpeg_stream_handle);
+    const JpegStreamMetadata *jpeg_stream_metadata = rocjpeg_stream_handle->rocjpeg_stream->GetJpegStreamMetadata();
+    uint32_t num_segments = static_cast<uint32_t>(jpeg_stream_metadata->app_segments.size());
+    if (app_segments == nullptr) {
+        *num_app_segments = num_segments;
+        return ROCJPEG_STATUS_SUCCESS;
+    }
+    num_segments = std::min(num_segments, *num_app_segments);
+    const uint8_t *stream_start = rocjpeg_stream_handle->rocjpeg_stream->GetStreamStart();
+    for (uint32_t i = 0; i < num_segments; i++) {
+        const JpegAppSegment &segment = jpeg_stream_metadata->app_segments[i];
+        app_segments[i].marker = segment.marker;
+        app_segments[i].offset = segment.offset;
+        app_segments[i].length = segment.length;
+        app_segments[i].data = stream_start + segment.offset;
+    }
+    *num_app_segments = num_segments;
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Retrieves the JPEG thumbnail embedded in the EXIF data of a parsed JPEG stream.
+ *
+ * @param jpeg_stream_handle The handle to the parsed JPEG stream.
+ * @param data Receives a pointer to the thumbnail, or nullptr if the stream has no JPEG thumbnail.
+ * @param length Receives the length of the thumbnail in bytes.
+ * @return The status of the operation.
+ *         - ROCJPEG_STATUS_SUCCESS if the thumbnail is retrieved successfully.
+ *         - ROCJPEG_STATUS_INVALID_PARAMETER if the input parameters are invalid.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetThumbnail(RocJpegStreamHandle jpeg_stream_handle, const unsigned char **data, size_t *length) {
+    if (jpeg_stream_handle == nullptr || data == nullptr || length == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    auto rocjpeg_stream_handle = static_cast<RocJpegStreamParserHandle*>(jpeg_stream_handle);
+    const JpegStreamMetadata *jpeg_stream_metadata = rocjpeg_stream_handle->rocjpeg_stream->GetJpegStreamMetadata();
+    if (jpeg_stream_metadata->exif_thumbnail_length == 0) {
+        *data = nullptr;
+        *length = 0;
+        return ROCJPEG_STATUS_SUCCESS;
+    }
+    *data = rocjpeg_stream_handle->rocjpeg_stream->GetStreamStart() + jpeg_stream_metadata->exif_thumbnail_offset;
+    *length = jpeg_stream_metadata->exif_thumbnail_length;
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Decodes a small parsed JPEG stream on the CPU into host memory.
+ *
+ * @param jpeg_stream_handle The handle to the parsed JPEG stream.
+ * @param decode_params The decode parameters; only the output format is used.
+ * @param destination The destination image, whose channels must point to host memory.
+ * @return The status of the decoding.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegDecodeHost(RocJpegStreamHandle jpeg_stream_handle, const RocJpegDecodeParams *decode_params, RocJpegImage *destination) {
+    if (jpeg_stream_handle == nullptr || decode_params == nullptr || destination == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    auto rocjpeg_stream_handle = static_cast<RocJpegStreamParserHandle*>(jpeg_stream_handle);
+    try {
+        // Each thread keeps its decoder, so the buffers of the decoder are reused by the next decode on the thread.
+        thread_local RocJpegCpuDecoder cpu_decoder;
+        return cpu_decoder.Decode(rocjpeg_stream_handle->rocjpeg_stream->GetJpegStreamParameters(), decode_params, destination);
+    } catch (const std::exception& e) {
+        // The error is not captured in the stream handle, which may be decoded by other threads at the same time.
+        ERR(e.what());
+        return ROCJPEG_STATUS_RUNTIME_ERROR;
+    }
+}
+
+/**
+ * @brief Locates the JPEG images of a buffer that contains several images.
+ *
+ * @param data The buffer.
+ * @param length The length of the buffer in bytes.
+ * @param image_spans An array that receives the image spans, or nullptr to query the number of images.
+ * @param num_image_spans The number of elements of image_spans; receives the number of images.
+ * @return The status of the operation.
+ *         - ROCJPEG_STATUS_SUCCESS if the images are located successfully.
+ *         - ROCJPEG_STATUS_INVALID_PARAMETER if the input parameters are invalid.
+ *         - ROCJPEG_STATUS_BAD_JPEG if the buffer does not contain any JPEG image.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamSplit(const unsigned char *data, size_t length, RocJpegImageSpan *image_spans, uint32_t *num_image_spans) {
+    if (data == nullptr || num_image_spans == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    std::vector<JpegImageSpan> jpeg_image_spans;
+    try {
+        RocJpegStreamParser::SplitJpegImages(data, length, jpeg_image_spans);
+    } catch (const std::exception& e) {
+        ERR(e.what());
+        return ROCJPEG_STATUS_RUNTIME_ERROR;
+    }
+    if (jpeg_image_spans.empty()) {
+        *num_image_spans = 0;
+        return ROCJPEG_STATUS_BAD_JPEG;
+    }
+    uint32_t num_spans = static_cast<uint32_t>(jpeg_image_spans.size());
+    if (image_spans == nullptr) {
+        *num_image_spans = num_spans;
+        return ROCJPEG_STATUS_SUCCESS;
+    }
+    num_spans = std::min(num_spans, *num_image_spans);
+    for (uint32_t i = 0; i < num_spans; i++) {
+        image_spans[i].offset = jpeg_image_spans[i].offset;
+        image_spans[i].length = jpeg_image_spans[i].length;
+        image_spans[i].mp_type = jpeg_image_spans[i].mp_type;
+    }
+    *num_image_spans = num_spans;
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Takes a stream handle from the process-wide stream handle pool.
+ *
+ * @param jpeg_stream_handle Receives the handle.
+ * @return The status of the operation.
+ *         - ROCJPEG_STATUS_SUCCESS if a handle is acquired successfully.
+ *         - ROCJPEG_STATUS_INVALID_PARAMETER if jpeg_stream_handle is nullptr.
+ *         - ROCJPEG_STATUS_OUTOF_MEMORY if the pool cannot provide a handle.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamAcquire(RocJpegStreamHandle *jpeg_stream_handle) {
+    if (jpeg_stream_handle == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    RocJpegStreamParserHandle *rocjpeg_stream_handle = nullptr;
+    try {
+        rocjpeg_stream_handle = RocJpegStreamHandlePool::GetInstance().Acquire();
+    } catch (const std::exception& e) {
+        ERR(STR("Failed to acquire a rocJPEG stream handle, ") + STR(e.what()));
+        return ROCJPEG_STATUS_OUTOF_MEMORY;
+    }
+    if (rocjpeg_stream_handle == nullptr) {
+        return ROCJPEG_STATUS_OUTOF_MEMORY;
+    }
+    *jpeg_stream_handle = rocjpeg_stream_handle;
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Returns a stream handle to the process-wide stream handle pool.
+ *
+ * @param jpeg_stream_handle The handle to release.
+ * @return The status of the operation.
+ *         - ROCJPEG_STATUS_SUCCESS if the handle is released successfully.
+ *         - ROCJPEG_STATUS_INVALID_PARAMETER if the handle is nullptr, was not taken from the pool, or has already
+ *           been released.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamRelease(RocJpegStreamHandle jpeg_stream_handle) {
+    if (jpeg_stream_handle == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    auto rocjpeg_stream_handle = static_cast<RocJpegStreamParserHandle*>(jpeg_stream_handle);
+    if (rocjpeg_stream_handle->pool_index == 0 || !RocJpegStreamHandlePool::GetInstance().Release(rocjpeg_stream_handle)) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Retrieves the extended information of a parsed JPEG stream.
+ *
+ * @param jpeg_stream_handle The handle to the parsed JPEG stream.
+ * @param image_info Receives the extended information of the JPEG stream.
+ * @return The status of the operation.
+ *         - ROCJPEG_STATUS_SUCCESS if the information is retrieved successfully.
+ *         - ROCJPEG_STATUS_INVALID_PARAMETER if the input parameters are invalid.
+ *         - ROCJPEG_STATUS_BAD_JPEG if the stream has not been completely parsed.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetImageInfoExt(RocJpegStreamHandle jpeg_stream_handle, RocJpegImageInfoExt *image_info) {
+    if (jpeg_stream_handle == nullptr || image_info == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    auto rocjpeg_stream_handle = static_cast<RocJpegStreamParserHandle*>(jpeg_stream_handle);
+    const JpegStreamParameters *jpeg_stream_params = rocjpeg_stream_handle->rocjpeg_stream->GetJpegStreamParameters();
+    if (jpeg_stream_params->slice_data_buffer == nullptr) {
+        ERR("the JPEG stream has not been completely parsed!");
+        return ROCJPEG_STATUS_BAD_JPEG;
+    }
+    *image_info = {};
+    image_info->num_components = jpeg_stream_params->picture_parameters.num_components;
+    // ChromaSubsampling and RocJpegChromaSubsampling have the same values.
+    image_info->subsampling = static_cast<RocJpegChromaSubsampling>(jpeg_stream_params->chroma_subsampling);
+    image_info->width = jpeg_stream_params->picture_parameters.picture_width;
+    image_info->height = jpeg_stream_params->picture_parameters.picture_height;
+    image_info->quality_factor = rocjpeg_stream_handle->rocjpeg_stream->GetQualityFactor();
+    image_info->num_pixels = static_cast<uint64_t>(image_info->width) * image_info->height;
+    image_info->num_mcus = jpeg_stream_params->slice_parameter_buffer.num_mcus;
+    image_info->entropy_data_size = jpeg_stream_params->slice_parameter_buffer.slice_data_size;
+    if (image_info->num_mcus > 0) {
+        image_info->bytes_per_mcu = static_cast<float>(image_info->entropy_data_size) / image_info->num_mcus;
+    }
+    if (image_info->num_pixels > 0) {
+        image_info->bits_per_pixel = static_cast<float>(image_info->entropy_data_size) * 8.0f / image_info->num_pixels;
+    }
+    image_info->restart_interval = jpeg_stream_params->slice_parameter_buffer.restart_interval;
+    image_info->num_restart_intervals = image_info->restart_interval > 0 ?
+        (image_info->num_mcus + image_info->restart_interval - 1) / image_info->restart_interval : 1;
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Retrieves the content hash of a parsed JPEG stream.
+ *
+ * @param jpeg_stream_handle The handle to the parsed JPEG stream.
+ * @param hash Receives the content hash computed while parsing.
+ * @return The status of the operation.
+ *         - ROCJPEG_STATUS_SUCCESS if the hash is retrieved successfully.
+ *         - ROCJPEG_STATUS_INVALID_PARAMETER if the input parameters are invalid.
+ *         - ROCJPEG_STATUS_BAD_JPEG if the stream has not been completely parsed.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegStreamGetContentHash(RocJpegStreamHandle jpeg_stream_handle, uint64_t *hash) {
+    if (jpeg_stream_handle == nullptr || hash == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    auto rocjpeg_stream_handle = static_cast<RocJpegStreamParserHandle*>(jpeg_stream_handle);
+    if (rocjpeg_stream_handle->rocjpeg_stream->GetJpegStreamParameters()->slice_data_buffer == nullptr) {
+        ERR("the JPEG stream has not been completely parsed!");
+        return ROCJPEG_STATUS_BAD_JPEG;
+    }
+    *hash = rocjpeg_stream_handle->rocjpeg_stream->GetContentHash();
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
 /**
  * @brief Destroys a RocJpegStreamHandle object and releases associated resources.
  *
  * @param jpeg_stream_handle The handle to the RocJpegStreamHandle object to be destroyed.
  * @return RocJpegStatus The status of the operation. Returns ROCJPEG_STATUS_SUCCESS if successful,
- *         or ROCJPEG_STATUS_INVALID_PARAMETER if the input handle is nullptr.
+ *         or ROCJPEG_STATUS_INVALID_PARAMETER if the input handle is nullptr or is a pooled handle that has already
+ *         been released.
  */
 RocJpegStatus ROCJPEGAPI rocJpegStreamDestroy(RocJpegStreamHandle jpeg_stream_handle) {
     if (jpeg_stream_handle == nullptr) {
         return ROCJPEG_STATUS_INVALID_PARAMETER;
     }
     auto rocjpeg_stream_handle = static_cast<RocJpegStreamParserHandle*>(jpeg_stream_handle);
+    if (rocjpeg_stream_handle->pool_index != 0) {
+        return RocJpegStreamHandlePool::GetInstance().Release(rocjpeg_stream_handle) ? ROCJPEG_STATUS_SUCCESS : ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
     delete rocjpeg_stream_handle;
     return ROCJPEG_STATUS_SUCCESS;
 }
@@ -236,6 +615,232 @@ RocJpegStatus ROCJPEGAPI rocJpegDecodeBatched(RocJpegHandle handle, RocJpegStrea
 
     return rocjpeg_status;
 }
+
+/**
+ * @brief Submits a JPEG image for decoding without waiting for the decoded image.
+ *
+ * @param handle The handle to the RocJpeg decoder.
+ * @param jpeg_stream_handle The stream handle of the JPEG image to be decoded.
+ * @param decode_params The decode parameters for the decoding process.
+ * @param destination The RocJpegImage structure to store the decoded image.
+ * @param job_id Receives the ID of the decode job.
+ * @return The status of the submission.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegDecodeAsync(RocJpegHandle handle, RocJpegStreamHandle jpeg_stream_handle, const RocJpegDecodeParams *decode_params, RocJpegImage *destination, uint64_t *job_id) {
+    if (handle == nullptr || decode_params == nullptr || destination == nullptr || job_id == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    RocJpegStatus rocjpeg_status = ROCJPEG_STATUS_SUCCESS;
+    auto rocjpeg_handle = static_cast<RocJpegDecoderHandle*>(handle);
+    try {
+        rocjpeg_status = rocjpeg_handle->rocjpeg_decoder->DecodeAsync(jpeg_stream_handle, decode_params, destination, job_id);
+    } catch (const std::exception& e) {
+        rocjpeg_handle->CaptureError(e.what());
+        ERR(e.what());
+        return ROCJPEG_STATUS_RUNTIME_ERROR;
+    }
+
+    return rocjpeg_status;
+}
+
+/**
+ * @brief Submits a batch of JPEG images for decoding without waiting for the decoded images.
+ *
+ * @param handle The handle to the RocJpeg decoder.
+ * @param jpeg_stream_handles An array of stream handles for the JPEG images to be decoded.
+ * @param batch_size The number of JPEG images in the batch.
+ * @param decode_params The decode parameters for the decoding process.
+ * @param destinations An array of RocJpegImage structures to store the decoded images.
+ * @param job_id Receives the ID of the decode job.
+ * @return The status of the submission.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegDecodeBatchedAsync(RocJpegHandle handle, RocJpegStreamHandle *jpeg_stream_handles, int batch_size, const RocJpegDecodeParams *decode_params, RocJpegImage *destinations, uint64_t *job_id) {
+    if (handle == nullptr || jpeg_stream_handles == nullptr || decode_params == nullptr || destinations == nullptr || job_id == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    RocJpegStatus rocjpeg_status = ROCJPEG_STATUS_SUCCESS;
+    auto rocjpeg_handle = static_cast<RocJpegDecoderHandle*>(handle);
+    try {
+        rocjpeg_status = rocjpeg_handle->rocjpeg_decoder->DecodeBatchedAsync(jpeg_stream_handles, batch_size, decode_params, destinations, job_id);
+    } catch (const std::exception& e) {
+        rocjpeg_handle->CaptureError(e.what());
+        ERR(e.what());
+        return ROCJPEG_STATUS_RUNTIME_ERROR;
+    }
+
+    return rocjpeg_status;
+}
+
+/**
+ * @brief Queries the status of an asynchronous decode job without blocking.
+ *
+ * @param handle The handle to the RocJpeg decoder the job was submitted to.
+ * @param job_id The ID of the decode job.
+ * @return ROCJPEG_STATUS_NOT_READY while the job is in flight, otherwise the status of the job.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegQuery(RocJpegHandle handle, uint64_t job_id) {
+    if (handle == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    RocJpegStatus rocjpeg_status = ROCJPEG_STATUS_SUCCESS;
+    auto rocjpeg_handle = static_cast<RocJpegDecoderHandle*>(handle);
+    try {
+        rocjpeg_status = rocjpeg_handle->rocjpeg_decoder->Query(job_id);
+    } catch (const std::exception& e) {
+        rocjpeg_handle->CaptureError(e.what());
+        ERR(e.what());
+        return ROCJPEG_STATUS_RUNTIME_ERROR;
+    }
+
+    return rocjpeg_status;
+}
+
+/**
+ * @brief Waits for an asynchronous decode job to complete.
+ *
+ * @param handle The handle to the RocJpeg decoder the job was submitted to.
+ * @param job_id The ID of the decode job.
+ * @return The status of the job.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegWait(RocJpegHandle handle, uint64_t job_id) {
+    if (handle == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    RocJpegStatus rocjpeg_status = ROCJPEG_STATUS_SUCCESS;
+    auto rocjpeg_handle = static_cast<RocJpegDecoderHandle*>(handle);
+    try {
+        rocjpeg_status = rocjpeg_handle->rocjpeg_decoder->Wait(job_id);
+    } catch (const std::exception& e) {
+        rocjpeg_handle->CaptureError(e.what());
+        ERR(e.what());
+        return ROCJPEG_STATUS_RUNTIME_ERROR;
+    }
+
+    return rocjpeg_status;
+}
+
+/**
+ * @brief Sets the function called when an asynchronous decode job completes.
+ *
+ * @param handle The handle to the RocJpeg decoder the job was submitted to.
+ * @param job_id The ID of the decode job.
+ * @param callback The function to call, or nullptr.
+ * @param user_data The pointer passed to the callback.
+ * @return The status of the operation.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegSetJobCallback(RocJpegHandle handle, uint64_t job_id, RocJpegJobCallback callback, void *user_data) {
+    if (handle == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    RocJpegStatus rocjpeg_status = ROCJPEG_STATUS_SUCCESS;
+    auto rocjpeg_handle = static_cast<RocJpegDecoderHandle*>(handle);
+    try {
+        rocjpeg_status = rocjpeg_handle->rocjpeg_decoder->SetJobCallback(job_id, callback, user_data);
+    } catch (const std::exception& e) {
+        rocjpeg_handle->CaptureError(e.what());
+        ERR(e.what());
+        return ROCJPEG_STATUS_RUNTIME_ERROR;
+    }
+
+    return rocjpeg_status;
+}
+
+/**
+ * @brief Retrieves the eventfd that is signaled when asynchronous decode jobs complete.
+ *
+ * @param handle The handle to the RocJpeg decoder.
+ * @param fd Receives the file descriptor.
+ * @return The status of the operation.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegGetCompletionFd(RocJpegHandle handle, int *fd) {
+    if (handle == nullptr || fd == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    RocJpegStatus rocjpeg_status = ROCJPEG_STATUS_SUCCESS;
+    auto rocjpeg_handle = static_cast<RocJpegDecoderHandle*>(handle);
+    try {
+        rocjpeg_status = rocjpeg_handle->rocjpeg_decoder->GetCompletionFd(fd);
+    } catch (const std::exception& e) {
+        rocjpeg_handle->CaptureError(e.what());
+        ERR(e.what());
+        return ROCJPEG_STATUS_RUNTIME_ERROR;
+    }
+
+    return rocjpeg_status;
+}
+
+/**
+ * @brief Retrieves the asynchronous decode jobs that have completed.
+ *
+ * @param handle The handle to the RocJpeg decoder.
+ * @param completions The array that receives the completed jobs.
+ * @param num_completions The capacity of the array on input, the number of completed jobs on output.
+ * @return The status of the operation.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegGetCompletedJobs(RocJpegHandle handle, RocJpegJobCompletion *completions, uint32_t *num_completions) {
+    if (handle == nullptr || completions == nullptr || num_completions == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    RocJpegStatus rocjpeg_status = ROCJPEG_STATUS_SUCCESS;
+    auto rocjpeg_handle = static_cast<RocJpegDecoderHandle*>(handle);
+    try {
+        rocjpeg_status = rocjpeg_handle->rocjpeg_decoder->GetCompletedJobs(completions, num_completions);
+    } catch (const std::exception& e) {
+        rocjpeg_handle->CaptureError(e.what());
+        ERR(e.what());
+        return ROCJPEG_STATUS_RUNTIME_ERROR;
+    }
+
+    return rocjpeg_status;
+}
+
+/**
+ * @brief Sets the limits of the device memory held by the decoded surfaces of a decoder.
+ *
+ * @param handle The handle to the RocJpeg decoder.
+ * @param memory_limits The memory limits.
+ * @return The status of the operation.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegSetMemoryLimits(RocJpegHandle handle, const RocJpegMemoryLimits *memory_limits) {
+    if (handle == nullptr || memory_limits == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    RocJpegStatus rocjpeg_status = ROCJPEG_STATUS_SUCCESS;
+    auto rocjpeg_handle = static_cast<RocJpegDecoderHandle*>(handle);
+    try {
+        rocjpeg_status = rocjpeg_handle->rocjpeg_decoder->SetMemoryLimits(memory_limits);
+    } catch (const std::exception& e) {
+        rocjpeg_handle->CaptureError(e.what());
+        ERR(e.what());
+        return ROCJPEG_STATUS_RUNTIME_ERROR;
+    }
+
+    return rocjpeg_status;
+}
+
+/**
+ * @brief Releases the decoded surfaces of a decoder that are not in use.
+ *
+ * @param handle The handle to the RocJpeg decoder.
+ * @return The status of the operation.
+ */
+RocJpegStatus ROCJPEGAPI rocJpegTrimMemory(RocJpegHandle handle) {
+    if (handle == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    RocJpegStatus rocjpeg_status = ROCJPEG_STATUS_SUCCESS;
+    auto rocjpeg_handle = static_cast<RocJpegDecoderHandle*>(handle);
+    try {
+        rocjpeg_status = rocjpeg_handle->rocjpeg_decoder->TrimMemory();
+    } catch (const std::exception& e) {
+        rocjpeg_handle->CaptureError(e.what());
+        ERR(e.what());
+        return ROCJPEG_STATUS_RUNTIME_ERROR;
+    }
+
+    return rocjpeg_status;
+}
+
 /**
  * @brief Returns the error name corresponding to the given RocJpegStatus.
  *
@@ -272,6 +877,8 @@ extern const char* ROCJPEGAPI rocJpegGetErrorName(RocJpegStatus rocjpeg_status)
             return "ROCJPEG_STATUS_OUTOF_MEMORY";
         case ROCJPEG_STATUS_NOT_IMPLEMENTED:
             return "ROCJPEG_STATUS_NOT_IMPLEMENTED";
+        case ROCJPEG_STATUS_NOT_READY:
+            return "ROCJPEG_STATUS_NOT_READY";
         default:
             return "UNKNOWN_ERROR";
     }
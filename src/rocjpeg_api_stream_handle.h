@@ -25,6 +25,7 @@ THE SOFTWARE.
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include "rocjpeg_parser.h"
 
@@ -42,7 +43,7 @@ class RocJpegStreamParserHandle {
          * This constructor initializes the rocjpeg_stream member with a new instance of RocJpegStreamParser
          * using std::make_shared.
          */
-        explicit RocJpegStreamParserHandle() : rocjpeg_stream(std::make_shared<RocJpegStreamParser>()) {};
+        explicit RocJpegStreamParserHandle() : rocjpeg_stream(std::make_shared<RocJpegStreamParser>()), pool_index{0}, pool_next{0}, in_pool{false} {};
 
         /**
          * @brief Destroys the RocJpegStreamParserHandle object.
@@ -52,6 +53,9 @@ class RocJpegStreamParserHandle {
         ~RocJpegStreamParserHandle() { ClearErrors(); }
 
         std::shared_ptr<RocJpegStreamParser> rocjpeg_stream; /**< The RocJpegStreamParser object. */
+        uint32_t pool_index; /**< The 1-based index of the handle in the RocJpegStreamHandlePool, or 0 if the handle is not pooled. */
+        std::atomic<uint32_t> pool_next; /**< The pool index of the next free handle while the handle is in the free list of the pool. */
+        std::atomic<bool> in_pool; /**< Whether the handle is in the free list of the pool, so it is not pushed twice. */
 
         /**
          * @brief Checks if there are no errors associated with the handle.
@@ -71,6 +75,14 @@ class RocJpegStreamParserHandle {
          */
         void CaptureError(const std::string& err_msg) { error_ = err_msg; }
 
+        /**
+         * @brief Clears any errors and the stream parsed last before the handle is returned to the pool.
+         */
+        void Recycle() {
+            ClearErrors();
+            rocjpeg_stream->Reset();
+        }
+
     private:
         /**
          * @brief Clears any errors associated with the handle.
@@ -0,0 +1,557 @@
+/*
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "rocjpeg_cpu_decoder.h"
+
+namespace {
+// Maps the zigzag index of a coefficient to its position in the 8x8 block (see Figure A.6 of ITU-T T.81).
+const uint8_t kZigzagToNatural[64] = {
+     0,  1,  8, 16,  9,  2,  3, 10,
+    17, 24, 32, 25, 18, 11,  4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34,
+    27, 20, 13,  6,  7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36,
+    29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46,
+    53, 60, 61, 54, 47, 55, 62, 63,
+};
+
+/**
+ * @brief Returns the basis of the 8-point inverse DCT, idct_basis[x][u] = C(u) * cos((2x + 1) * u * pi / 16) / 2.
+ */
+const float (&GetIdctBasis())[8][8] {
+    static float idct_basis[8][8];
+    static const bool initialized = [] {
+        for (int x = 0; x < 8; x++) {
+            for (int u = 0; u < 8; u++) {
+                float c = (u == 0) ? 1.0f / std::sqrt(2.0f) : 1.0f;
+                idct_basis[x][u] = c * std::cos((2 * x + 1) * u * static_cast<float>(M_PI) / 16.0f) / 2.0f;
+            }
+        }
+        return true;
+    }();
+    (void)initialized;
+    return idct_basis;
+}
+
+inline uint8_t ClampToByte(int32_t value) {
+    return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+/**
+ * @brief Converts a JFIF YCbCr sample to RGB using 16-bit fixed-point coefficients.
+ */
+inline void YCbCrToRgb(int32_t y, int32_t cb, int32_t cr, uint8_t &r, uint8_t &g, uint8_t &b) {
+    cb -= 128;
+    cr -= 128;
+    r = ClampToByte(y + ((91881 * cr + 32768) >> 16));
+    g = ClampToByte(y - ((22554 * cb + 46802 * cr - 32768) >> 16));
+    b = ClampToByte(y + ((116130 * cb + 32768) >> 16));
+}
+} // namespace
+
+RocJpegCpuDecoder::RocJpegCpuDecoder() : num_components_{0}, max_h_sampling_factor_{1},
+    max_v_sampling_factor_{1}, entropy_data_{}, next_restart_index_{0}, bit_stream_{nullptr}, bit_stream_end_{nullptr}, bit_buffer_{0},
+    num_buffered_bits_{0} {
+}
+
+RocJpegCpuDecoder::~RocJpegCpuDecoder() {
+}
+
+/**
+ * @brief Decodes a parsed JPEG stream into host memory.
+ *
+ * This function prepares the components of the frame, decodes the scan into one plane per component using the
+ * Huffman lookup tables of the interned table set of the stream, and writes the planes to the destination image in
+ * the requested output format. The crop rectangle and the target dimension of the decode parameters are not
+ * supported and are ignored.
+ *
+ * @param jpeg_stream_params The parameters of the parsed JPEG stream.
+ * @param decode_params The decode parameters.
+ * @param destination The destination image, whose channels must point to host memory.
+ * @return The status of the decoding.
+ */
+RocJpegStatus RocJpegCpuDecoder::Decode(const JpegStreamParameters *jpeg_stream_params, const RocJpegDecodeParams *decode_params, RocJpegImage *destination) {
+    if (jpeg_stream_params == nullptr || decode_params == nullptr || destination == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    const JpegPictureParameters &picture_params = jpeg_stream_params->picture_parameters;
+    const SliceParameterBuffer &slice_params = jpeg_stream_params->slice_parameter_buffer;
+    if (jpeg_stream_params->slice_data_buffer == nullptr || picture_params.picture_width == 0 || picture_params.picture_height == 0) {
+        ERR("the JPEG stream has not been completely parsed!");
+        return ROCJPEG_STATUS_BAD_JPEG;
+    }
+    if (jpeg_stream_params->chroma_subsampling == CSS_411 || jpeg_stream_params->chroma_subsampling == CSS_UNKNOWN) {
+        ERR("the chroma subsampling of the JPEG stream is not supported!");
+        return ROCJPEG_STATUS_JPEG_NOT_SUPPORTED;
+    }
+    num_components_ = picture_params.num_components;
+    if ((num_components_ != 1 && num_components_ != 3) || slice_params.num_components != num_components_) {
+        ERR("only single-scan JPEG streams with 1 or 3 components are supported!");
+        return ROCJPEG_STATUS_JPEG_NOT_SUPPORTED;
+    }
+
+    const JpegHuffmanLookupTables *huffman_lookup_tables = jpeg_stream_params->huffman_lookup_tables;
+
+    max_h_sampling_factor_ = 1;
+    max_v_sampling_factor_ = 1;
+    for (uint32_t c = 0; c < num_components_; c++) {
+        uint32_t h_sampling_factor = picture_params.components[c].h_sampling_factor;
+        uint32_t v_sampling_factor = picture_params.components[c].v_sampling_factor;
+        if (h_sampling_factor < 1 || h_sampling_factor > 4 || v_sampling_factor < 1 || v_sampling_factor > 4) {
+            ERR("invalid sampling factor!");
+            return ROCJPEG_STATUS_BAD_JPEG;
+        }
+        max_h_sampling_factor_ = std::max(max_h_sampling_factor_, h_sampling_factor);
+        max_v_sampling_factor_ = std::max(max_v_sampling_factor_, v_sampling_factor);
+    }
+
+    uint32_t mcu_width = max_h_sampling_factor_ * 8;
+    uint32_t mcu_height = max_v_sampling_factor_ * 8;
+    uint32_t num_mcus_x = (picture_params.picture_width + mcu_width - 1) / mcu_width;
+    uint32_t num_mcus_y = (picture_params.picture_height + mcu_height - 1) / mcu_height;
+    for (uint32_t c = 0; c < num_components_; c++) {
+        ComponentInfo &component = components_[c];
+        component.h_sampling_factor = picture_params.components[c].h_sampling_factor;
+        component.v_sampling_factor = picture_params.components[c].v_sampling_factor;
+        component.width = (picture_params.picture_width * component.h_sampling_factor + max_h_sampling_factor_ - 1) / max_h_sampling_factor_;
+        component.height = (picture_params.picture_height * component.v_sampling_factor + max_v_sampling_factor_ - 1) / max_v_sampling_factor_;
+        component.plane_stride = num_mcus_x * component.h_sampling_factor * 8;
+        component.plane.resize(component.plane_stride * num_mcus_y * component.v_sampling_factor * 8);
+
+        uint8_t quantization_table_index = picture_params.components[c].quantiser_table_selector;
+        if (!jpeg_stream_params->quantization_matrix_buffer->load_quantiser_table[quantization_table_index]) {
+            ERR("missing quantization table!");
+            return ROCJPEG_STATUS_BAD_JPEG;
+        }
+        component.quantization_table = jpeg_stream_params->quantization_matrix_buffer->quantiser_table[quantization_table_index];
+
+        uint8_t dc_table_index = slice_params.components[c].dc_table_selector;
+        uint8_t ac_table_index = slice_params.components[c].ac_table_selector;
+        if (dc_table_index >= HUFFMAN_TABLES || ac_table_index >= HUFFMAN_TABLES ||
+            !huffman_lookup_tables->is_valid[dc_table_index] || !huffman_lookup_tables->is_valid[ac_table_index]) {
+            ERR("missing or invalid Huffman table!");
+            return ROCJPEG_STATUS_BAD_JPEG;
+        }
+        component.dc_table = &huffman_lookup_tables->dc_tables[dc_table_index];
+        component.ac_table = &huffman_lookup_tables->ac_tables[ac_table_index];
+        component.dc_predictor = 0;
+    }
+
+    RocJpegStatus rocjpeg_status = DecodeScan(jpeg_stream_params);
+    if (rocjpeg_status != ROCJPEG_STATUS_SUCCESS) {
+        return rocjpeg_status;
+    }
+    return WriteOutput(jpeg_stream_params, decode_params->output_format, destination);
+}
+
+/**
+ * @brief Decodes the entropy-coded data of the scan into the planes of the components.
+ *
+ * The scan is interleaved when it has several components, in which case each MCU contains h x v blocks of each
+ * component. A scan with a single component is not interleaved and each MCU is a single block.
+ *
+ * @param jpeg_stream_params The parameters of the parsed JPEG stream.
+ * @return The status of the decoding.
+ */
+RocJpegStatus RocJpegCpuDecoder::DecodeScan(const JpegStreamParameters *jpeg_stream_params) {
+    const uint8_t *scan_data = jpeg_stream_params->slice_data_buffer;
+    if (jpeg_stream_params->slice_data_segments != nullptr) {
+        // A byte stuffing or a restart marker may be split between two segments, so they are gathered first.
+        scan_data_.clear();
+        for (uint32_t i = 0; i < jpeg_stream_params->num_slice_data_segments; i++) {
+            const JpegDataSegment &segment = jpeg_stream_params->slice_data_segments[i];
+            scan_data_.insert(scan_data_.end(), segment.data, segment.data + segment.size);
+        }
+        scan_data = scan_data_.data();
+    }
+    RocJpegStreamParser::UnstuffEntropyData(scan_data, jpeg_stream_params->slice_parameter_buffer.slice_data_size, entropy_data_);
+    next_restart_index_ = 0;
+    bit_stream_ = entropy_data_.data.get();
+    bit_stream_end_ = bit_stream_ + (entropy_data_.restart_offsets.empty() ? entropy_data_.size : entropy_data_.restart_offsets[0]);
+    bit_buffer_ = 0;
+    num_buffered_bits_ = 0;
+
+    uint32_t restart_interval = jpeg_stream_params->slice_parameter_buffer.restart_interval;
+    uint32_t num_mcus_x, num_mcus_y;
+    if (num_components_ == 1) {
+        num_mcus_x = (components_[0].width + 7) / 8;
+        num_mcus_y = (components_[0].height + 7) / 8;
+    } else {
+        num_mcus_x = components_[0].plane_stride / (components_[0].h_sampling_factor * 8);
+        num_mcus_y = static_cast<uint32_t>(components_[0].plane.size() / components_[0].plane_stride) / (components_[0].v_sampling_factor * 8);
+    }
+
+    uint32_t mcu_count = 0;
+    for (uint32_t mcu_y = 0; mcu_y < num_mcus_y; mcu_y++) {
+        for (uint32_t mcu_x = 0; mcu_x < num_mcus_x; mcu_x++) {
+            if (restart_interval != 0 && mcu_count != 0 && mcu_count % restart_interval == 0) {
+                ProcessRestartMarker();
+            }
+            mcu_count++;
+            if (num_components_ == 1) {
+                ComponentInfo &component = components_[0];
+                if (!DecodeBlock(component, component.plane.data() + (mcu_y * 8) * component.plane_stride + mcu_x * 8)) {
+                    return ROCJPEG_STATUS_BAD_JPEG;
+                }
+                continue;
+            }
+            for (uint32_t c = 0; c < num_components_; c++) {
+                ComponentInfo &component = components_[c];
+                for (uint32_t v = 0; v < component.v_sampling_factor; v++) {
+                    for (uint32_t h = 0; h < component.h_sampling_factor; h++) {
+                        uint32_t block_x = (mcu_x * component.h_sampling_factor + h) * 8;
+                        uint32_t block_y = (mcu_y * component.v_sampling_factor + v) * 8;
+                        if (!DecodeBlock(component, component.plane.data() + block_y * component.plane_stride + block_x)) {
+                            return ROCJPEG_STATUS_BAD_JPEG;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Decodes and reconstructs an 8x8 block of a component.
+ *
+ * This function decodes the DC difference and the run-length coded AC coefficients of the block (see F.2.2 of
+ * ITU-T T.81), dequantizes them, and writes the inverse DCT of the block to the plane of the component.
+ *
+ * @param component The component of the block.
+ * @param output The top-left sample of the block in the plane of the component.
+ * @return true if the block is decoded successfully, false otherwise.
+ */
+bool RocJpegCpuDecoder::DecodeBlock(ComponentInfo &component, uint8_t *output) {
+    float coefficients[64] = {};
+    const uint8_t *quantization_table = component.quantization_table;
+
+    int32_t size = DecodeHuffmanSymbol(*component.dc_table);
+    if (size < 0 || size > 11) {
+        ERR("invalid DC coefficient!");
+        return false;
+    }
+    int32_t diff = 0;
+    if (size > 0) {
+        diff = static_cast<int32_t>(GetBits(size));
+        if (diff < (1 << (size - 1))) {
+            diff -= (1 << size) - 1;
+        }
+    }
+    component.dc_predictor += diff;
+    coefficients[0] = static_cast<float>(component.dc_predictor * quantization_table[0]);
+
+    bool has_ac_coefficients = false;
+    for (int k = 1; k < 64;) {
+        int32_t run_size = DecodeHuffmanSymbol(*component.ac_table);
+        if (run_size < 0) {
+            ERR("invalid AC coefficient!");
+            return false;
+        }
+        int32_t run = run_size >> 4;
+        size = run_size & 0x0F;
+        if (size == 0) {
+            if (run != 15) {
+                // End of block
+                break;
+            }
+            k += 16;
+            continue;
+        }
+        k += run;
+        if (k > 63) {
+            ERR("invalid AC coefficient!");
+            return false;
+        }
+        int32_t value = static_cast<int32_t>(GetBits(size));
+        if (value < (1 << (size - 1))) {
+            value -= (1 << size) - 1;
+        }
+        coefficients[kZigzagToNatural[k]] = static_cast<float>(value * quantization_table[k]);
+        has_ac_coefficients = true;
+        k++;
+    }
+
+    uint32_t stride = component.plane_stride;
+    if (!has_ac_coefficients) {
+        // The block is flat, the inverse DCT reduces to the DC term
+        uint8_t value = ClampToByte(static_cast<int32_t>(std::lround(coefficients[0] / 8.0f)) + 128);
+        for (int y = 0; y < 8; y++) {
+            std::memset(output + y * stride, value, 8);
+        }
+        return true;
+    }
+
+    // Separable inverse DCT: rows first, then columns
+    const float (&idct_basis)[8][8] = GetIdctBasis();
+    float temp[64];
+    for (int v = 0; v < 8; v++) {
+        const float *row = coefficients + v * 8;
+        for (int x = 0; x < 8; x++) {
+            float sum = 0.0f;
+            for (int u = 0; u < 8; u++) {
+                sum += idct_basis[x][u] * row[u];
+            }
+            temp[v * 8 + x] = sum;
+        }
+    }
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            float sum = 0.0f;
+            for (int v = 0; v < 8; v++) {
+                sum += idct_basis[y][v] * temp[v * 8 + x];
+            }
+            output[y * stride + x] = ClampToByte(static_cast<int32_t>(std::lround(sum)) + 128);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Decodes the next Huffman-coded symbol.
+ *
+ * The next HUFFMAN_LOOKUP_BITS bits are looked up in the fast lookup table, which resolves all the codes of up to
+ * that length. Longer codes are resolved by comparing the next bits against the largest code of each length
+ * (see Figure F.16 of ITU-T T.81).
+ *
+ * @param table The Huffman lookup table to use.
+ * @return The decoded symbol, or -1 if the code is invalid.
+ */
+int32_t RocJpegCpuDecoder::DecodeHuffmanSymbol(const JpegHuffmanLookupTable &table) {
+    if (num_buffered_bits_ < 16) {
+        FillBitBuffer();
+    }
+    uint16_t entry = table.fast_lookup[bit_buffer_ >> (32 - HUFFMAN_LOOKUP_BITS)];
+    if (entry != 0) {
+        uint32_t length = entry >> 8;
+        bit_buffer_ <<= length;
+        num_buffered_bits_ -= length;
+        return entry & 0xFF;
+    }
+    for (uint32_t length = HUFFMAN_LOOKUP_BITS + 1; length <= 16; length++) {
+        int32_t code = static_cast<int32_t>(bit_buffer_ >> (32 - length));
+        if (code <= table.max_code[length]) {
+            bit_buffer_ <<= length;
+            num_buffered_bits_ -= length;
+            return table.values[code + table.value_offset[length]];
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Reads the next bits of the entropy-coded data.
+ *
+ * @param num_bits The number of bits to read (0 to 16).
+ * @return The bits read.
+ */
+uint32_t RocJpegCpuDecoder::GetBits(uint32_t num_bits) {
+    if (num_bits == 0) {
+        return 0;
+    }
+    if (num_buffered_bits_ < num_bits) {
+        FillBitBuffer();
+    }
+    uint32_t bits = bit_buffer_ >> (32 - num_bits);
+    bit_buffer_ <<= num_bits;
+    num_buffered_bits_ -= num_bits;
+    return bits;
+}
+
+/**
+ * @brief Refills the bit buffer with the next bytes of the unstuffed entropy-coded data.
+ *
+ * The data contains no stuffed bytes or markers. Past the end of the current restart interval, the buffer is
+ * padded with zero bits.
+ */
+void RocJpegCpuDecoder::FillBitBuffer() {
+    while (num_buffered_bits_ <= 24) {
+        uint32_t byte = bit_stream_ < bit_stream_end_ ? *bit_stream_++ : 0;
+        bit_buffer_ |= byte << (24 - num_buffered_bits_);
+        num_buffered_bits_ += 8;
+    }
+}
+
+/**
+ * @brief Moves to the start of the next restart interval.
+ *
+ * The buffered bits are discarded, as the data before a restart marker is padded to a byte boundary, and the DC
+ * predictors of all the components are reset. If the stream has fewer restart markers than restart intervals,
+ * the remaining intervals decode from zero bits.
+ */
+void RocJpegCpuDecoder::ProcessRestartMarker() {
+    bit_buffer_ = 0;
+    num_buffered_bits_ = 0;
+    const std::vector<uint32_t> &restart_offsets = entropy_data_.restart_offsets;
+    const uint8_t *entropy_data_end = entropy_data_.data.get() + entropy_data_.size;
+    if (next_restart_index_ < restart_offsets.size()) {
+        bit_stream_ = entropy_data_.data.get() + restart_offsets[next_restart_index_];
+        next_restart_index_++;
+        bit_stream_end_ = next_restart_index_ < restart_offsets.size() ? entropy_data_.data.get() + restart_offsets[next_restart_index_] : entropy_data_end;
+    } else {
+        bit_stream_ = entropy_data_end;
+        bit_stream_end_ = entropy_data_end;
+    }
+    for (uint32_t c = 0; c < num_components_; c++) {
+        components_[c].dc_predictor = 0;
+    }
+}
+
+/**
+ * @brief Writes the decoded planes of the components to the destination image in the requested format.
+ *
+ * The layout of each output format is the same as for the VCN JPEG decoder (see RocJpegOutputFormat). The chroma
+ * planes are upsampled by sample replication for the RGB output formats.
+ *
+ * @param jpeg_stream_params The parameters of the parsed JPEG stream.
+ * @param output_format The output format.
+ * @param destination The destination image, whose channels must point to host memory.
+ * @return The status of the operation.
+ */
+RocJpegStatus RocJpegCpuDecoder::WriteOutput(const JpegStreamParameters *jpeg_stream_params, RocJpegOutputFormat output_format, RocJpegImage *destination) {
+    uint32_t width = jpeg_stream_params->picture_parameters.picture_width;
+    uint32_t height = jpeg_stream_params->picture_parameters.picture_height;
+    ChromaSubsampling chroma_subsampling = jpeg_stream_params->chroma_subsampling;
+    uint32_t chroma_width = (chroma_subsampling == CSS_422 || chroma_subsampling == CSS_420) ? width >> 1 : width;
+    uint32_t chroma_height = (chroma_subsampling == CSS_440 || chroma_subsampling == CSS_420) ? height >> 1 : height;
+    const ComponentInfo &luma = components_[0];
+
+    auto copy_plane = [](const ComponentInfo &component, uint32_t plane_width, uint32_t plane_height, uint8_t *channel, uint32_t pitch) {
+        for (uint32_t y = 0; y < plane_height; y++) {
+            std::memcpy(channel + y * pitch, component.plane.data() + y * component.plane_stride, plane_width);
+        }
+    };
+    auto required_channels = [&](uint32_t count) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (destination->channel[i] == nullptr) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    switch (output_format) {
+        case ROCJPEG_OUTPUT_Y:
+            if (!required_channels(1)) {
+                return ROCJPEG_STATUS_INVALID_PARAMETER;
+            }
+            copy_plane(luma, width, height, destination->channel[0], destination->pitch[0]);
+            break;
+        case ROCJPEG_OUTPUT_NATIVE:
+        case ROCJPEG_OUTPUT_YUV_PLANAR:
+            if (num_components_ == 1) {
+                if (!required_channels(1)) {
+                    return ROCJPEG_STATUS_INVALID_PARAMETER;
+                }
+                copy_plane(luma, width, height, destination->channel[0], destination->pitch[0]);
+            } else if (output_format == ROCJPEG_OUTPUT_NATIVE && chroma_subsampling == CSS_422) {
+                // YUYV packed into the first channel
+                if (!required_channels(1)) {
+                    return ROCJPEG_STATUS_INVALID_PARAMETER;
+                }
+                for (uint32_t y = 0; y < height; y++) {
+                    uint8_t *row = destination->channel[0] + y * destination->pitch[0];
+                    const uint8_t *y_row = luma.plane.data() + y * luma.plane_stride;
+                    const uint8_t *u_row = components_[1].plane.data() + y * components_[1].plane_stride;
+                    const uint8_t *v_row = components_[2].plane.data() + y * components_[2].plane_stride;
+                    for (uint32_t x = 0; x + 1 < width; x += 2) {
+                        row[2 * x] = y_row[x];
+                        row[2 * x + 1] = u_row[x >> 1];
+                        row[2 * x + 2] = y_row[x + 1];
+                        row[2 * x + 3] = v_row[x >> 1];
+                    }
+                    if (width & 1) {
+                        // The last column of an odd width has no pair; it keeps its own chroma sample.
+                        uint32_t x = width - 1;
+                        row[2 * x] = y_row[x];
+                        row[2 * x + 1] = u_row[x >> 1];
+                    }
+                }
+            } else if (output_format == ROCJPEG_OUTPUT_NATIVE && chroma_subsampling == CSS_420) {
+                // Y in the first channel and interleaved UV in the second channel
+                if (!required_channels(2)) {
+                    return ROCJPEG_STATUS_INVALID_PARAMETER;
+                }
+                copy_plane(luma, width, height, destination->channel[0], destination->pitch[0]);
+                for (uint32_t y = 0; y < chroma_height; y++) {
+                    uint8_t *row = destination->channel[1] + y * destination->pitch[1];
+                    const uint8_t *u_row = components_[1].plane.data() + y * components_[1].plane_stride;
+                    const uint8_t *v_row = components_[2].plane.data() + y * components_[2].plane_stride;
+                    for (uint32_t x = 0; x < chroma_width; x++) {
+                        row[2 * x] = u_row[x];
+                        row[2 * x + 1] = v_row[x];
+                    }
+                }
+            } else {
+                if (!required_channels(3)) {
+                    return ROCJPEG_STATUS_INVALID_PARAMETER;
+                }
+                copy_plane(luma, width, height, destination->channel[0], destination->pitch[0]);
+                copy_plane(components_[1], chroma_width, chroma_height, destination->channel[1], destination->pitch[1]);
+                copy_plane(components_[2], chroma_width, chroma_height, destination->channel[2], destination->pitch[2]);
+            }
+            break;
+        case ROCJPEG_OUTPUT_RGB:
+        case ROCJPEG_OUTPUT_RGB_PLANAR: {
+            bool is_planar = output_format == ROCJPEG_OUTPUT_RGB_PLANAR;
+            if (!required_channels(is_planar ? 3 : 1)) {
+                return ROCJPEG_STATUS_INVALID_PARAMETER;
+            }
+            for (uint32_t y = 0; y < height; y++) {
+                const uint8_t *y_row = luma.plane.data() + y * luma.plane_stride;
+                const uint8_t *cb_row = nullptr;
+                const uint8_t *cr_row = nullptr;
+                if (num_components_ == 3) {
+                    cb_row = components_[1].plane.data() + (y * components_[1].v_sampling_factor / max_v_sampling_factor_) * components_[1].plane_stride;
+                    cr_row = components_[2].plane.data() + (y * components_[2].v_sampling_factor / max_v_sampling_factor_) * components_[2].plane_stride;
+                }
+                for (uint32_t x = 0; x < width; x++) {
+                    uint8_t r, g, b;
+                    if (num_components_ == 3) {
+                        YCbCrToRgb(y_row[x], cb_row[x * components_[1].h_sampling_factor / max_h_sampling_factor_],
+                                   cr_row[x * components_[2].h_sampling_factor / max_h_sampling_factor_], r, g, b);
+                    } else {
+                        r = g = b = y_row[x];
+                    }
+                    if (is_planar) {
+                        destination->channel[0][y * destination->pitch[0] + x] = r;
+                        destination->channel[1][y * destination->pitch[1] + x] = g;
+                        destination->channel[2][y * destination->pitch[2] + x] = b;
+                    } else {
+                        uint8_t *pixel = destination->channel[0] + y * destination->pitch[0] + 3 * x;
+                        pixel[0] = r;
+                        pixel[1] = g;
+                        pixel[2] = b;
+                    }
+                }
+            }
+            break;
+        }
+        default:
+            return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    return ROCJPEG_STATUS_SUCCESS;
+}
@@ -0,0 +1,140 @@
+/*
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef ROC_JPEG_CPU_DECODER_H_
+#define ROC_JPEG_CPU_DECODER_H_
+
+#pragma once
+
+#include <vector>
+#include "../api/rocjpeg.h"
+#include "rocjpeg_parser.h"
+#include "rocjpeg_commons.h"
+
+/**
+ * @class RocJpegCpuDecoder
+ * @brief A compact baseline JPEG decoder running on the CPU.
+ *
+ * The RocJpegCpuDecoder class decodes small baseline JPEG streams, such as the thumbnails embedded in EXIF data,
+ * which are below the minimum picture size of the VCN JPEG decoder. The decoded image is written to host memory.
+ * Only 8-bit baseline streams with a single interleaved scan are supported, which is what the parser extracts.
+ */
+class RocJpegCpuDecoder {
+    public:
+        /**
+         * @brief Constructs a RocJpegCpuDecoder object.
+         */
+        RocJpegCpuDecoder();
+
+        /**
+         * @brief Destroys the RocJpegCpuDecoder object.
+         */
+        ~RocJpegCpuDecoder();
+
+        /**
+         * @brief Decodes a parsed JPEG stream into host memory.
+         * @param jpeg_stream_params The parameters of the parsed JPEG stream.
+         * @param decode_params The decode parameters; only the output format is used.
+         * @param destination The destination image, whose channels must point to host memory.
+         * @return The status of the decoding.
+         */
+        RocJpegStatus Decode(const JpegStreamParameters *jpeg_stream_params, const RocJpegDecodeParams *decode_params, RocJpegImage *destination);
+
+    private:
+        /**
+         * @brief Structure representing a component of the frame being decoded.
+         */
+        struct ComponentInfo {
+            uint32_t h_sampling_factor; /**< The horizontal sampling factor. */
+            uint32_t v_sampling_factor; /**< The vertical sampling factor. */
+            uint32_t width; /**< The width of the component in samples. */
+            uint32_t height; /**< The height of the component in samples. */
+            uint32_t plane_stride; /**< The stride of the decoded plane of the component. */
+            const uint8_t *quantization_table; /**< The quantization table, in zigzag order. */
+            const JpegHuffmanLookupTable *dc_table; /**< The DC Huffman table. */
+            const JpegHuffmanLookupTable *ac_table; /**< The AC Huffman table. */
+            int32_t dc_predictor; /**< The DC predictor. */
+            std::vector<uint8_t> plane; /**< The decoded samples of the component. */
+        };
+
+        /**
+         * @brief Decodes the entropy-coded data of the scan into the planes of the components.
+         * @param jpeg_stream_params The parameters of the parsed JPEG stream.
+         * @return The status of the decoding.
+         */
+        RocJpegStatus DecodeScan(const JpegStreamParameters *jpeg_stream_params);
+
+        /**
+         * @brief Decodes and reconstructs an 8x8 block of a component.
+         * @param component The component of the block.
+         * @param output The top-left sample of the block in the plane of the component.
+         * @return True if the block is decoded successfully, false otherwise.
+         */
+        bool DecodeBlock(ComponentInfo &component, uint8_t *output);
+
+        /**
+         * @brief Decodes the next Huffman-coded symbol.
+         * @param table The Huffman lookup table to use.
+         * @return The decoded symbol, or -1 if the code is invalid.
+         */
+        int32_t DecodeHuffmanSymbol(const JpegHuffmanLookupTable &table);
+
+        /**
+         * @brief Reads the next bits of the entropy-coded data.
+         * @param num_bits The number of bits to read (0 to 16).
+         * @return The bits read.
+         */
+        uint32_t GetBits(uint32_t num_bits);
+
+        /**
+         * @brief Refills the bit buffer with the next bytes of the unstuffed entropy-coded data.
+         */
+        void FillBitBuffer();
+
+        /**
+         * @brief Moves to the start of the next restart interval and resets the decoder state.
+         */
+        void ProcessRestartMarker();
+
+        /**
+         * @brief Writes the decoded planes of the components to the destination image in the requested format.
+         * @param jpeg_stream_params The parameters of the parsed JPEG stream.
+         * @param output_format The output format.
+         * @param destination The destination image.
+         * @return The status of the operation.
+         */
+        RocJpegStatus WriteOutput(const JpegStreamParameters *jpeg_stream_params, RocJpegOutputFormat output_format, RocJpegImage *destination);
+
+        ComponentInfo components_[NUM_COMPONENTS - 1]; ///< The components of the frame.
+        uint32_t num_components_; ///< The number of components of the frame.
+        uint32_t max_h_sampling_factor_; ///< The largest horizontal sampling factor of the components.
+        uint32_t max_v_sampling_factor_; ///< The largest vertical sampling factor of the components.
+        std::vector<uint8_t> scan_data_; ///< The entropy-coded data of a scattered stream, gathered before unstuffing.
+        JpegEntropyData entropy_data_; ///< The unstuffed entropy-coded data of the scan.
+        uint32_t next_restart_index_; ///< The index in entropy_data_.restart_offsets of the next restart interval.
+        const uint8_t *bit_stream_; ///< Pointer to the next byte of the unstuffed entropy-coded data.
+        const uint8_t *bit_stream_end_; ///< Pointer to the end of the current restart interval.
+        uint32_t bit_buffer_; ///< The buffered bits, MSB first.
+        uint32_t num_buffered_bits_; ///< The number of valid bits in bit_buffer_.
+};
+
+#endif //ROC_JPEG_CPU_DECODER_H_
@@ -23,9 +23,37 @@ THE SOFTWARE.
 #include "rocjpeg_decoder.h"
 
 RocJpegDecoder::RocJpegDecoder(RocJpegBackend backend, int device_id) :
-    num_devices_{0}, device_id_ {device_id}, hip_stream_ {0}, backend_{backend} {}
+    num_devices_{0}, device_id_ {device_id}, hip_stream_ {0}, backend_{backend}, next_job_id_{1}, completion_fd_{-1}, stop_completion_thread_{false},
+    idle_timeout_ms_{0}, surface_acquire_mode_{ROCJPEG_SURFACE_ACQUIRE_GROW}, surface_acquire_timeout_ms_{0} {}
 
 RocJpegDecoder::~RocJpegDecoder() {
+    {
+        // The jobs still in flight are completed, so the VCN and the HIP stream no longer write to their destinations.
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!pending_jobs_.empty()) {
+            if (CompleteJob(lock, pending_jobs_.front().job_id) != ROCJPEG_STATUS_SUCCESS) {
+                break;
+            }
+        }
+        stop_completion_thread_ = true;
+    }
+    // The completion thread delivers the remaining callbacks before it exits.
+    completion_cv_.notify_all();
+    if (completion_thread_.joinable()) {
+        completion_thread_.join();
+    }
+    if (completion_fd_ >= 0) {
+        close(completion_fd_);
+    }
+    for (hipEvent_t group_event : batch_group_events_) {
+        hipError_t hip_status = hipEventDestroy(group_event);
+    }
+    for (hipEvent_t job_event : idle_job_events_) {
+        hipError_t hip_status = hipEventDestroy(job_event);
+    }
+    for (auto &job : pending_jobs_) {
+        hipError_t hip_status = hipEventDestroy(job.post_processed_event);
+    }
     if (hip_stream_) {
         hipError_t hip_status = hipStreamDestroy(hip_stream_);
     }
@@ -102,20 +130,694 @@ RocJpegStatus RocJpegDecoder::InitializeDecoder() {
  * @return The status of the JPEG decoding operation.
  */
 RocJpegStatus RocJpegDecoder::Decode(RocJpegStreamHandle jpeg_stream_handle, const RocJpegDecodeParams *decode_params, RocJpegImage *destination) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
     RocJpegStatus rocjpeg_status = ROCJPEG_STATUS_SUCCESS;
     if (jpeg_stream_handle == nullptr || decode_params == nullptr || destination == nullptr) {
         return ROCJPEG_STATUS_INVALID_PARAMETER;
     }
     auto rocjpeg_stream_handle = static_cast<RocJpegStreamParserHandle*>(jpeg_stream_handle);
     const JpegStreamParameters *jpeg_stream_params = rocjpeg_stream_handle->rocjpeg_stream->GetJpegStreamParameters();
+    if (jpeg_stream_params->slice_data_buffer == nullptr) {
+        ERR("the JPEG stream has not been completely parsed!");
+        return ROCJPEG_STATUS_BAD_JPEG;
+    }
 
     VASurfaceID current_surface_id;
-    CHECK_ROCJPEG(jpeg_vaapi_decoder_.SubmitDecode(jpeg_stream_params, current_surface_id, decode_params));
+    CHECK_ROCJPEG(SubmitWithBackpressure(lock, [&](bool enforce_memory_budget) {
+        return jpeg_vaapi_decoder_.SubmitDecode(jpeg_stream_params, current_surface_id, decode_params, enforce_memory_budget);
+    }, true));
+    CHECK_ROCJPEG(jpeg_vaapi_decoder_.SyncSurface(current_surface_id));
+    CHECK_ROCJPEG(PostProcessSurface(current_surface_id, jpeg_stream_params->picture_parameters.picture_width, jpeg_stream_params->picture_parameters.picture_height, decode_params, destination));
+    CHECK_ROCJPEG(jpeg_vaapi_decoder_.SetSurfaceAsIdle(current_surface_id));
+    CHECK_HIP(hipStreamSynchronize(hip_stream_));
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * Decodes a batch of JPEG streams using the specified decode parameters and stores the decoded images in the provided destinations.
+ *
+ * @param jpeg_streams An array of RocJpegStreamHandle objects representing the JPEG streams to be decoded.
+ * @param batch_size The number of JPEG streams in the batch.
+ * @param decode_params A pointer to RocJpegDecodeParams object containing the decode parameters.
+ * @param destinations An array of RocJpegImage objects where the decoded images will be stored.
+ * @return A RocJpegStatus value indicating the success or failure of the decoding operation.
+ */
+RocJpegStatus RocJpegDecoder::DecodeBatched(RocJpegStreamHandle *jpeg_streams, int batch_size, const RocJpegDecodeParams *decode_params, RocJpegImage *destinations) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (jpeg_streams == nullptr || decode_params == nullptr || destinations == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+
+    // The parameters and surfaces are kept in storage of this call, since the lock is released while waiting for
+    // surfaces when the memory budget is exhausted.
+    std::vector<const JpegStreamParameters*> batch_streams_params;
+    CHECK_ROCJPEG(GetBatchStreamParameters(jpeg_streams, batch_size, batch_streams_params));
+    std::vector<VASurfaceID> batch_surface_ids(batch_size);
+    const JpegStreamParameters **jpeg_streams_params = batch_streams_params.data();
+    VASurfaceID *current_surface_ids = batch_surface_ids.data();
+    VcnJpegSpec current_vcn_jpeg_spec = jpeg_vaapi_decoder_.GetCurrentVcnJpegSpec();
+    int group_size = std::max(static_cast<int>(current_vcn_jpeg_spec.num_jpeg_cores), 1);
+    int num_groups = (batch_size + group_size - 1) / group_size;
+    if (batch_group_events_.empty()) {
+        batch_group_events_.resize(2);
+        for (auto &group_event : batch_group_events_) {
+            CHECK_HIP(hipEventCreateWithFlags(&group_event, hipEventDisableTiming));
+        }
+    }
+
+    // The whole batch is checked before the first stream is submitted, so an unsupported stream does not fail the
+    // batch halfway through the pipeline.
+    CHECK_ROCJPEG(jpeg_vaapi_decoder_.CheckJpegStreamsSupported(jpeg_streams_params, batch_size, decode_params));
+    std::fill(current_surface_ids, current_surface_ids + batch_size, VA_INVALID_SURFACE);
+
+    // The streams are decoded in groups of one stream per JPEG core, in a software pipeline: the next group is
+    // submitted before the current one is synced and post-processed, so the VCN decodes it while the HIP kernels run.
+    // The surfaces of a group are released once the event recorded after its post-processing has been reached,
+    // which is waited for just before the group after next is submitted, so at most two groups hold surfaces.
+    // The surfaces [num_released, num_acquired) are held, and are released if the pipeline fails.
+    int num_released = 0;
+    int num_acquired = 0;
+    auto decode_groups = [&]() -> RocJpegStatus {
+        if (num_groups > 0) {
+            num_acquired = std::min(group_size, batch_size);
+            CHECK_ROCJPEG(SubmitWithBackpressure(lock, [&](bool enforce_memory_budget) {
+                return jpeg_vaapi_decoder_.SubmitDecodeBatched(jpeg_streams_params, num_acquired, decode_params, current_surface_ids, enforce_memory_budget);
+            }, true));
+        }
+        for (int group = 0; group < num_groups; group++) {
+            int group_start = group * group_size;
+            int group_end = std::min(group_start + group_size, batch_size);
+            if (group + 1 < num_groups) {
+                if (group > 0) {
+                    CHECK_HIP(hipEventSynchronize(batch_group_events_[(group - 1) % 2]));
+                    for (; num_released < group_start; num_released++) {
+                        CHECK_ROCJPEG(jpeg_vaapi_decoder_.SetSurfaceAsIdle(current_surface_ids[num_released]));
+                    }
+                }
+                int next_group_size = std::min(group_size, batch_size - group_end);
+                num_acquired = group_end + next_group_size;
+                CHECK_ROCJPEG(SubmitWithBackpressure(lock, [&](bool enforce_memory_budget) {
+                    return jpeg_vaapi_decoder_.SubmitDecodeBatched(jpeg_streams_params + group_end, next_group_size, decode_params, current_surface_ids + group_end, enforce_memory_budget);
+                }, false));
+            }
+
+            for (int k = group_start; k < group_end; k++) {
+                CHECK_ROCJPEG(jpeg_vaapi_decoder_.SyncSurface(current_surface_ids[k]));
+                CHECK_ROCJPEG(PostProcessSurface(current_surface_ids[k], jpeg_streams_params[k]->picture_parameters.picture_width,
+                                                 jpeg_streams_params[k]->picture_parameters.picture_height, decode_params, &destinations[k]));
+            }
+            CHECK_HIP(hipEventRecord(batch_group_events_[group % 2], hip_stream_));
+        }
+
+        CHECK_HIP(hipStreamSynchronize(hip_stream_));
+        // Release the surfaces of the last two groups, whose events have not been waited for in the loop.
+        for (; num_released < batch_size; num_released++) {
+            CHECK_ROCJPEG(jpeg_vaapi_decoder_.SetSurfaceAsIdle(current_surface_ids[num_released]));
+        }
+        return ROCJPEG_STATUS_SUCCESS;
+    };
+
+    RocJpegStatus rocjpeg_status = decode_groups();
+    if (rocjpeg_status != ROCJPEG_STATUS_SUCCESS) {
+        // Wait for the VCN and the HIP stream to be done with the surfaces that are still held, then release them.
+        // The surfaces are released even if a wait fails, so the pool does not lose them; the failures are logged
+        // and the status of the failed decode is returned.
+        hipError_t hip_status = hipStreamSynchronize(hip_stream_);
+        if (hip_status != hipSuccess) {
+            ERR("hipStreamSynchronize failed with status " + STR(hipGetErrorName(hip_status)));
+        }
+        for (int k = num_released; k < num_acquired; k++) {
+            if (current_surface_ids[k] != VA_INVALID_SURFACE) {
+                RocJpegStatus cleanup_status = jpeg_vaapi_decoder_.SyncSurface(current_surface_ids[k]);
+                if (cleanup_status != ROCJPEG_STATUS_SUCCESS) {
+                    ERR("failed to sync surface " + TOSTR(current_surface_ids[k]) + " with status " + TOSTR(cleanup_status));
+                }
+                cleanup_status = jpeg_vaapi_decoder_.SetSurfaceAsIdle(current_surface_ids[k]);
+                if (cleanup_status != ROCJPEG_STATUS_SUCCESS) {
+                    ERR("failed to release surface " + TOSTR(current_surface_ids[k]) + " with status " + TOSTR(cleanup_status));
+                }
+            }
+        }
+    }
+    return rocjpeg_status;
+}
+
+/**
+ * @brief Submits a JPEG stream for decoding and returns without waiting for the decoded image.
+ *
+ * @param jpeg_stream_handle The handle to the JPEG stream.
+ * @param decode_params The decode parameters for the JPEG image.
+ * @param destination The destination buffer to store the decoded image.
+ * @param job_id Receives the ID of the decode job.
+ * @return The status of the submission.
+ */
+RocJpegStatus RocJpegDecoder::DecodeAsync(RocJpegStreamHandle jpeg_stream_handle, const RocJpegDecodeParams *decode_params, RocJpegImage *destination, uint64_t *job_id) {
+    return DecodeBatchedAsync(&jpeg_stream_handle, 1, decode_params, destination, job_id);
+}
+
+/**
+ * @brief Submits a batch of JPEG streams for decoding and returns without waiting for the decoded images.
+ *
+ * The streams are submitted to the VCN in groups of as many streams as there are JPEG cores, as in DecodeBatched,
+ * but the decoded surfaces are not waited for. The job is then advanced by the following calls of DecodeAsync,
+ * DecodeBatchedAsync, Query, and Wait on this decoder: the surfaces that are decoded are post-processed on the HIP
+ * stream, and the surfaces are released once the post-processing has completed. If the maximum number of jobs is
+ * already in flight, the oldest one is completed first.
+ *
+ * @param jpeg_streams The array of JPEG stream handles.
+ * @param batch_size The number of JPEG streams in the batch.
+ * @param decode_params The decode parameters.
+ * @param destinations The array of destination images.
+ * @param job_id Receives the ID of the decode job.
+ * @return The status of the submission.
+ */
+RocJpegStatus RocJpegDecoder::DecodeBatchedAsync(RocJpegStreamHandle *jpeg_streams, int batch_size, const RocJpegDecodeParams *decode_params, RocJpegImage *destinations, uint64_t *job_id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (jpeg_streams == nullptr || batch_size <= 0 || decode_params == nullptr || destinations == nullptr || job_id == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    // The parameters are kept in storage of this call, since the lock is released while the oldest jobs complete
+    // or while waiting for surfaces.
+    std::vector<const JpegStreamParameters*> jpeg_streams_params;
+    CHECK_ROCJPEG(GetBatchStreamParameters(jpeg_streams, batch_size, jpeg_streams_params));
+
+    ProgressJobs();
+    VcnJpegSpec current_vcn_jpeg_spec = jpeg_vaapi_decoder_.GetCurrentVcnJpegSpec();
+    size_t max_pending_jobs = 2 * std::max(current_vcn_jpeg_spec.num_jpeg_cores, 1u);
+    while (pending_jobs_.size() >= max_pending_jobs) {
+        CHECK_ROCJPEG(CompleteJob(lock, pending_jobs_.front().job_id));
+    }
+
+    RocJpegDecodeJob job = {};
+    job.job_id = next_job_id_++;
+    job.is_aborted = false;
+    job.callback = nullptr;
+    job.callback_user_data = nullptr;
+    job.state = kJobDecoding;
+    job.status = ROCJPEG_STATUS_SUCCESS;
+    job.decode_params = *decode_params;
+    job.destinations.assign(destinations, destinations + batch_size);
+    job.surface_ids.resize(batch_size);
+    job.picture_widths.resize(batch_size);
+    job.picture_heights.resize(batch_size);
+    for (int i = 0; i < batch_size; i++) {
+        job.picture_widths[i] = jpeg_streams_params[i]->picture_parameters.picture_width;
+        job.picture_heights[i] = jpeg_streams_params[i]->picture_parameters.picture_height;
+    }
+    if (idle_job_events_.empty()) {
+        hipEvent_t job_event;
+        CHECK_HIP(hipEventCreateWithFlags(&job_event, hipEventDisableTiming));
+        idle_job_events_.push_back(job_event);
+    }
+    job.post_processed_event = idle_job_events_.back();
+    idle_job_events_.pop_back();
+
+    for (int i = 0; i < batch_size; i += current_vcn_jpeg_spec.num_jpeg_cores) {
+        int current_batch_size = std::min(static_cast<int>(current_vcn_jpeg_spec.num_jpeg_cores), batch_size - i);
+        RocJpegStatus rocjpeg_status = SubmitWithBackpressure(lock, [&](bool enforce_memory_budget) {
+            return jpeg_vaapi_decoder_.SubmitDecodeBatched(jpeg_streams_params.data() + i, current_batch_size, &job.decode_params, job.surface_ids.data() + i, enforce_memory_budget);
+        }, i == 0);
+        if (rocjpeg_status != ROCJPEG_STATUS_SUCCESS) {
+            // The streams submitted so far, and the surfaces the failed group had acquired, are completed before the
+            // error is returned, so no surface is left busy. The aborted job is not published to the caller.
+            job.surface_ids.resize(i + current_batch_size);
+            auto first_unused = std::remove(job.surface_ids.begin() + i, job.surface_ids.end(), VA_INVALID_SURFACE);
+            job.surface_ids.erase(first_unused, job.surface_ids.end());
+            job.status = rocjpeg_status;
+            job.is_aborted = true;
+            uint64_t aborted_job_id = job.job_id;
+            pending_jobs_.push_back(std::move(job));
+            CompleteJob(lock, aborted_job_id);
+            return rocjpeg_status;
+        }
+    }
+    *job_id = job.job_id;
+    pending_jobs_.push_back(std::move(job));
+    completion_cv_.notify_one();
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Queries the status of an asynchronous decode job without blocking.
+ *
+ * @param job_id The ID of the decode job.
+ * @return ROCJPEG_STATUS_NOT_READY if the job is in flight, the status of the job once it has completed, or
+ *         ROCJPEG_STATUS_INVALID_PARAMETER if no job with this ID has been submitted.
+ */
+RocJpegStatus RocJpegDecoder::Query(uint64_t job_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (job_id == 0 || job_id >= next_job_id_) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    ProgressJobs();
+    if (FindPendingJob(job_id) != pending_jobs_.end()) {
+        return ROCJPEG_STATUS_NOT_READY;
+    }
+    return GetCompletedJobStatus(job_id);
+}
+
+/**
+ * @brief Waits for an asynchronous decode job to complete.
+ *
+ * @param job_id The ID of the decode job.
+ * @return The status of the job, or ROCJPEG_STATUS_INVALID_PARAMETER if no job with this ID has been submitted or
+ *         its status is no longer kept.
+ */
+RocJpegStatus RocJpegDecoder::Wait(uint64_t job_id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (job_id == 0 || job_id >= next_job_id_) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    CHECK_ROCJPEG(CompleteJob(lock, job_id));
+    return GetCompletedJobStatus(job_id);
+}
+
+/**
+ * @brief Retrieves the status of an asynchronous decode job that has completed.
+ *
+ * The statuses of the failed jobs are kept for the kJobStatusWindow most recent jobs, whichever channel reports
+ * them, so a failed job is never reported as successful; the older jobs are reported as unknown.
+ *
+ * @param job_id The ID of the decode job, which must not be in flight.
+ * @return The status of the job, or ROCJPEG_STATUS_INVALID_PARAMETER if it is older than the window.
+ */
+RocJpegStatus RocJpegDecoder::GetCompletedJobStatus(uint64_t job_id) {
+    if (job_id + kJobStatusWindow < next_job_id_) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    auto failed_job = failed_job_statuses_.find(job_id);
+    return failed_job != failed_job_statuses_.end() ? failed_job->second : ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Retrieves the parameters of a batch of parsed JPEG streams.
+ *
+ * The parameters are referenced in place, since the stream handles outlive the call.
+ *
+ * @param jpeg_streams The array of JPEG stream handles.
+ * @param batch_size The number of JPEG streams in the batch.
+ * @param streams_params Receives the parameters of the streams; it is only grown, so it can be reused across calls.
+ * @return ROCJPEG_STATUS_SUCCESS, or ROCJPEG_STATUS_BAD_JPEG if a stream has not been completely parsed.
+ */
+RocJpegStatus RocJpegDecoder::GetBatchStreamParameters(RocJpegStreamHandle *jpeg_streams, int batch_size, std::vector<const JpegStreamParameters*> &streams_params) {
+    if (streams_params.size() < batch_size) {
+        streams_params.resize(batch_size);
+    }
+    for (int i = 0; i < batch_size; i++) {
+        auto rocjpeg_stream_handle = static_cast<RocJpegStreamParserHandle*>(jpeg_streams[i]);
+        if (rocjpeg_stream_handle == nullptr) {
+            return ROCJPEG_STATUS_INVALID_PARAMETER;
+        }
+        const JpegStreamParameters *jpeg_stream_params = rocjpeg_stream_handle->rocjpeg_stream->GetJpegStreamParameters();
+        if (jpeg_stream_params->slice_data_buffer == nullptr) {
+            ERR("the JPEG stream has not been completely parsed!");
+            return ROCJPEG_STATUS_BAD_JPEG;
+        }
+        streams_params[i] = jpeg_stream_params;
+    }
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Finds an asynchronous decode job that is in flight.
+ * @param job_id The ID of the decode job.
+ * @return The iterator to the job in pending_jobs_, or pending_jobs_.end() if it is not in flight.
+ */
+std::deque<RocJpegDecodeJob>::iterator RocJpegDecoder::FindPendingJob(uint64_t job_id) {
+    return std::find_if(pending_jobs_.begin(), pending_jobs_.end(), [job_id](const RocJpegDecodeJob &job) { return job.job_id == job_id; });
+}
+
+/**
+ * @brief Advances the asynchronous decode jobs without blocking.
+ *
+ * The surfaces of each job are post-processed in order as soon as the VCN has decoded them. Once all the surfaces
+ * of a job have been post-processed, an event is recorded on the HIP stream, and the job is completed when the
+ * event has been reached: its surfaces are released to the memory pool, and its status is recorded if it failed.
+ * The mutex must be held by the caller.
+ */
+void RocJpegDecoder::ProgressJobs() {
+    for (auto job = pending_jobs_.begin(); job != pending_jobs_.end();) {
+        while (job->state == kJobDecoding && job->num_post_processed < job->surface_ids.size()) {
+            uint32_t index = job->num_post_processed;
+            bool is_ready = false;
+            RocJpegStatus rocjpeg_status = jpeg_vaapi_decoder_.QuerySurfaceReady(job->surface_ids[index], is_ready);
+            if (rocjpeg_status == ROCJPEG_STATUS_SUCCESS && !is_ready) {
+                break;
+            }
+            if (rocjpeg_status == ROCJPEG_STATUS_SUCCESS && job->status == ROCJPEG_STATUS_SUCCESS) {
+                rocjpeg_status = PostProcessSurface(job->surface_ids[index], job->picture_widths[index], job->picture_heights[index], &job->decode_params, &job->destinations[index]);
+            }
+            if (rocjpeg_status != ROCJPEG_STATUS_SUCCESS && job->status == ROCJPEG_STATUS_SUCCESS) {
+                job->status = rocjpeg_status;
+            }
+            job->num_post_processed++;
+        }
+        if (job->state == kJobDecoding && job->num_post_processed == job->surface_ids.size()) {
+            if (hipEventRecord(job->post_processed_event, hip_stream_) != hipSuccess && job->status == ROCJPEG_STATUS_SUCCESS) {
+                job->status = ROCJPEG_STATUS_RUNTIME_ERROR;
+            }
+            job->state = kJobPostProcessing;
+        }
+        if (job->state == kJobPostProcessing && hipEventQuery(job->post_processed_event) != hipErrorNotReady) {
+            for (VASurfaceID surface_id : job->surface_ids) {
+                jpeg_vaapi_decoder_.SetSurfaceAsIdle(surface_id);
+            }
+            if (job->status != ROCJPEG_STATUS_SUCCESS && !job->is_aborted) {
+                failed_job_statuses_[job->job_id] = job->status;
+                if (next_job_id_ > kJobStatusWindow) {
+                    failed_job_statuses_.erase(failed_job_statuses_.begin(), failed_job_statuses_.lower_bound(next_job_id_ - kJobStatusWindow));
+                }
+            }
+            if (job->callback != nullptr && !job->is_aborted) {
+                job_callbacks_.push_back({job->job_id, job->status, job->callback, job->callback_user_data});
+                completion_cv_.notify_one();
+            }
+            if (completion_fd_ >= 0 && !job->is_aborted) {
+                completed_jobs_.push_back({job->job_id, job->status});
+                uint64_t num_completed = 1;
+                if (write(completion_fd_, &num_completed, sizeof(num_completed)) != sizeof(num_completed)) {
+                    ERR("write() to the completion eventfd failed with errno " + TOSTR(errno));
+                }
+            }
+            idle_job_events_.push_back(job->post_processed_event);
+            job = pending_jobs_.erase(job);
+            surfaces_released_cv_.notify_all();
+        } else {
+            ++job;
+        }
+    }
+}
+
+/**
+ * @brief Blocks until an asynchronous decode job has completed.
+ *
+ * The mutex is released while waiting for the VCN or the HIP stream, so the other threads can submit and query
+ * jobs in the meantime.
+ *
+ * @param lock The lock on the mutex, held by the caller.
+ * @param job_id The ID of the decode job.
+ * @return ROCJPEG_STATUS_SUCCESS once the job is no longer in flight, or an error if waiting failed.
+ */
+RocJpegStatus RocJpegDecoder::CompleteJob(std::unique_lock<std::mutex> &lock, uint64_t job_id) {
+    while (true) {
+        ProgressJobs();
+        auto job = FindPendingJob(job_id);
+        if (job == pending_jobs_.end()) {
+            return ROCJPEG_STATUS_SUCCESS;
+        }
+        CHECK_ROCJPEG(WaitForJobProgress(lock, *job));
+    }
+}
+
+/**
+ * @brief Blocks until the next step of an asynchronous decode job can be taken.
+ *
+ * Waits, with the mutex released, for the next surface of the job to be decoded if it is still decoding, or for its
+ * post-processing to complete otherwise. The job may have been completed by another thread when this returns.
+ *
+ * @param lock The lock on the mutex, held by the caller.
+ * @param job The decode job, which must be in flight.
+ * @return The status of the wait, or ROCJPEG_STATUS_SUCCESS if the wait failed after the job had completed.
+ */
+RocJpegStatus RocJpegDecoder::WaitForJobProgress(std::unique_lock<std::mutex> &lock, const RocJpegDecodeJob &job) {
+    // While the mutex is released, another thread may complete the job and release its surfaces, which the memory
+    // pool may then destroy (TrimMemory, the idle timeout or the memory budget), so the wait may fail although the
+    // job has succeeded. A failed wait is only reported if the job is still in flight; the surfaces of a job in
+    // flight are never evicted. The job may not be accessed after the mutex is released.
+    uint64_t job_id = job.job_id;
+    RocJpegStatus rocjpeg_status;
+    if (job.state == kJobDecoding) {
+        VASurfaceID surface_id = job.surface_ids[job.num_post_processed];
+        lock.unlock();
+        rocjpeg_status = jpeg_vaapi_decoder_.WaitSurface(surface_id);
+        lock.lock();
+    } else {
+        hipEvent_t post_processed_event = job.post_processed_event;
+        lock.unlock();
+        hipError_t hip_status = hipEventSynchronize(post_processed_event);
+        lock.lock();
+        rocjpeg_status = hip_status == hipSuccess ? ROCJPEG_STATUS_SUCCESS : ROCJPEG_STATUS_RUNTIME_ERROR;
+    }
+    if (rocjpeg_status != ROCJPEG_STATUS_SUCCESS) {
+        ProgressJobs();
+        if (FindPendingJob(job_id) == pending_jobs_.end()) {
+            return ROCJPEG_STATUS_SUCCESS;
+        }
+    }
+    return rocjpeg_status;
+}
+
+/**
+ * @brief Sets the function called when an asynchronous decode job completes.
+ *
+ * The callback is called from the completion thread, which is started on the first call. If the job has already
+ * completed, the callback is called before this function returns, from the calling thread.
+ *
+ * @param job_id The ID of the decode job.
+ * @param callback The function to call, or nullptr to remove the callback of the job.
+ * @param user_data The pointer passed to the callback.
+ * @return ROCJPEG_STATUS_SUCCESS, or ROCJPEG_STATUS_INVALID_PARAMETER if no job with this ID has been submitted.
+ */
+RocJpegStatus RocJpegDecoder::SetJobCallback(uint64_t job_id, RocJpegJobCallback callback, void *user_data) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (job_id == 0 || job_id >= next_job_id_) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    CHECK_ROCJPEG(StartCompletionThread());
+    ProgressJobs();
+    auto job = FindPendingJob(job_id);
+    if (job != pending_jobs_.end()) {
+        job->callback = callback;
+        job->callback_user_data = user_data;
+        return ROCJPEG_STATUS_SUCCESS;
+    }
+    RocJpegStatus job_status = GetCompletedJobStatus(job_id);
+    if (job_status == ROCJPEG_STATUS_INVALID_PARAMETER) {
+        return job_status;
+    }
+    lock.unlock();
+    if (callback != nullptr) {
+        callback(job_id, job_status, user_data);
+    }
+    return ROCJPEG_STATUS_SUCCESS;
+}
 
+/**
+ * @brief Retrieves the eventfd that is signaled when asynchronous decode jobs complete.
+ *
+ * The eventfd and the completion thread are created on the first call. From then on, each completed job increments
+ * the counter of the eventfd and is appended to the queue drained by GetCompletedJobs.
+ *
+ * @param fd Receives the file descriptor, which remains owned by the decoder.
+ * @return The status of the operation.
+ */
+RocJpegStatus RocJpegDecoder::GetCompletionFd(int *fd) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    if (completion_fd_ < 0) {
+        completion_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (completion_fd_ < 0) {
+            ERR("eventfd() failed with errno " + TOSTR(errno));
+            return ROCJPEG_STATUS_RUNTIME_ERROR;
+        }
+    }
+    CHECK_ROCJPEG(StartCompletionThread());
+    *fd = completion_fd_;
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Removes the completed jobs from the queue of completions published on the eventfd.
+ *
+ * @param completions The array that receives the completed jobs, oldest first.
+ * @param num_completions On input, the capacity of the array; on output, the number of completed jobs returned.
+ * @return The status of the operation.
+ */
+RocJpegStatus RocJpegDecoder::GetCompletedJobs(RocJpegJobCompletion *completions, uint32_t *num_completions) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (completions == nullptr || num_completions == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    ProgressJobs();
+    uint32_t count = std::min(*num_completions, static_cast<uint32_t>(completed_jobs_.size()));
+    for (uint32_t i = 0; i < count; i++) {
+        completions[i] = completed_jobs_.front();
+        completed_jobs_.pop_front();
+    }
+    *num_completions = count;
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Sets the memory budget and idle timeout of the surfaces of the decoder.
+ *
+ * The idle surfaces are released to fit in the new budget right away. An idle timeout starts the completion thread,
+ * which releases the surfaces that stay idle for longer than the timeout.
+ *
+ * @param memory_limits The memory limits.
+ * @return The status of the operation.
+ */
+RocJpegStatus RocJpegDecoder::SetMemoryLimits(const RocJpegMemoryLimits *memory_limits) {
+    if (memory_limits == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    if (memory_limits->surface_acquire_mode != ROCJPEG_SURFACE_ACQUIRE_GROW &&
+        memory_limits->surface_acquire_mode != ROCJPEG_SURFACE_ACQUIRE_WAIT &&
+        memory_limits->surface_acquire_mode != ROCJPEG_SURFACE_ACQUIRE_TRY) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    jpeg_vaapi_decoder_.SetMemoryLimits(memory_limits->max_pool_bytes, memory_limits->idle_timeout_ms);
+    idle_timeout_ms_ = memory_limits->idle_timeout_ms;
+    surface_acquire_mode_ = memory_limits->surface_acquire_mode;
+    surface_acquire_timeout_ms_ = memory_limits->surface_acquire_timeout_ms;
+    surfaces_released_cv_.notify_all();
+    if (idle_timeout_ms_ > 0) {
+        CHECK_ROCJPEG(StartCompletionThread());
+        completion_cv_.notify_one();
+    }
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Releases the surfaces of the decoder that are not in use.
+ *
+ * The surfaces of the jobs that have completed are released first, so only the surfaces of the jobs in flight remain.
+ *
+ * @return The status of the operation.
+ */
+RocJpegStatus RocJpegDecoder::TrimMemory() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ProgressJobs();
+    jpeg_vaapi_decoder_.TrimMemory();
+    surfaces_released_cv_.notify_all();
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Submits streams to the VAAPI decoder, applying the surface acquire mode when the memory budget is exhausted.
+ *
+ * The budget is only enforced while asynchronous decode jobs are in flight, since the surfaces they hold are the
+ * only ones that can be released while the caller waits; otherwise, as in the ROCJPEG_SURFACE_ACQUIRE_GROW mode,
+ * the pool grows past its budget. In the ROCJPEG_SURFACE_ACQUIRE_TRY mode, the first streams of a decode call fail
+ * with ROCJPEG_STATUS_NOT_READY, and the following streams of a call that has been admitted are submitted anyway,
+ * so a call never fails halfway. In the ROCJPEG_SURFACE_ACQUIRE_WAIT mode, the jobs in flight are advanced until
+ * they release enough surfaces or until the timeout, after which only the first streams of a call fail.
+ *
+ * The waiting thread sleeps on surfaces_released_cv_ with the mutex released, so the other threads can keep using
+ * the decoder; the completion thread, which is started if it is not running, advances the jobs in flight and
+ * notifies the condition variable as they release their surfaces.
+ *
+ * @param lock The lock on the mutex, held by the caller.
+ * @param submit Submits the streams, enforcing the memory budget or not.
+ * @param is_admission Whether these are the first streams of a decode call.
+ * @return The status of the submission.
+ */
+RocJpegStatus RocJpegDecoder::SubmitWithBackpressure(std::unique_lock<std::mutex> &lock, const std::function<RocJpegStatus(bool)> &submit, bool is_admission) {
+    if (surface_acquire_mode_ == ROCJPEG_SURFACE_ACQUIRE_GROW) {
+        return submit(false);
+    }
+    if (surface_acquire_mode_ == ROCJPEG_SURFACE_ACQUIRE_TRY && !is_admission) {
+        return submit(false);
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(surface_acquire_timeout_ms_);
+    bool is_timed_out = false;
+    while (true) {
+        ProgressJobs();
+        if (pending_jobs_.empty()) {
+            return submit(false);
+        }
+        RocJpegStatus rocjpeg_status = submit(true);
+        if (rocjpeg_status != ROCJPEG_STATUS_NOT_READY || surface_acquire_mode_ == ROCJPEG_SURFACE_ACQUIRE_TRY) {
+            return rocjpeg_status;
+        }
+        if (is_timed_out) {
+            return is_admission ? ROCJPEG_STATUS_NOT_READY : submit(false);
+        }
+        CHECK_ROCJPEG(StartCompletionThread());
+        if (surface_acquire_timeout_ms_ > 0) {
+            is_timed_out = surfaces_released_cv_.wait_until(lock, deadline) == std::cv_status::timeout;
+        } else {
+            surfaces_released_cv_.wait(lock);
+        }
+    }
+}
+
+/**
+ * @brief Starts the completion thread if it is not running. The mutex must be held by the caller.
+ * @return The status of the operation.
+ */
+RocJpegStatus RocJpegDecoder::StartCompletionThread() {
+    if (!completion_thread_.joinable()) {
+        try {
+            completion_thread_ = std::thread(&RocJpegDecoder::RunCompletionThread, this);
+        } catch (const std::system_error &e) {
+            ERR(e.what());
+            return ROCJPEG_STATUS_RUNTIME_ERROR;
+        }
+    }
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief The body of the completion thread.
+ *
+ * The thread advances the jobs in flight, blocking with the mutex released on the oldest one, so the completions
+ * are published on the eventfd and the callbacks are called without a thread waiting per job. The callbacks are
+ * called with the mutex released, so they can submit new jobs. If an idle timeout is set, the thread also releases
+ * the surfaces that have been idle for longer than the timeout.
+ */
+void RocJpegDecoder::RunCompletionThread() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::vector<RocJpegJobCallbackRecord> callbacks;
+    while (true) {
+        ProgressJobs();
+        if (!job_callbacks_.empty()) {
+            callbacks.swap(job_callbacks_);
+            lock.unlock();
+            for (auto &record : callbacks) {
+                record.callback(record.job_id, record.status, record.user_data);
+            }
+            callbacks.clear();
+            lock.lock();
+            continue;
+        }
+        if (stop_completion_thread_) {
+            break;
+        }
+        jpeg_vaapi_decoder_.ReleaseExpiredSurfaces();
+        if (pending_jobs_.empty()) {
+            if (idle_timeout_ms_ > 0) {
+                // Wake up to release the surfaces that reach the idle timeout while no job is in flight.
+                completion_cv_.wait_for(lock, std::chrono::milliseconds(idle_timeout_ms_));
+            } else {
+                completion_cv_.wait(lock);
+            }
+        } else if (WaitForJobProgress(lock, pending_jobs_.front()) != ROCJPEG_STATUS_SUCCESS) {
+            // Avoid spinning on a surface or an event that cannot be waited for.
+            completion_cv_.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+}
+
+/**
+ * @brief Post-processes a decoded surface into the destination image.
+ *
+ * The decoded surface is copied, or converted to the requested output format, into the destination image on the
+ * HIP stream. The crop rectangle is applied here unless the VCN has already decoded only the region of interest.
+ *
+ * @param surface_id The decoded surface.
+ * @param image_width The width of the image.
+ * @param image_height The height of the image.
+ * @param decode_params The decode parameters.
+ * @param destination The destination image.
+ * @return The status of the operation.
+ */
+RocJpegStatus RocJpegDecoder::PostProcessSurface(VASurfaceID surface_id, uint16_t image_width, uint16_t image_height, const RocJpegDecodeParams *decode_params, RocJpegImage *destination) {
     HipInteropDeviceMem hip_interop_dev_mem = {};
-    CHECK_ROCJPEG(jpeg_vaapi_decoder_.SyncSurface(current_surface_id));
-    CHECK_ROCJPEG(jpeg_vaapi_decoder_.GetHipInteropMem(current_surface_id, hip_interop_dev_mem));
+    CHECK_ROCJPEG(jpeg_vaapi_decoder_.GetHipInteropMem(surface_id, hip_interop_dev_mem));
 
     uint16_t chroma_height = 0;
     uint16_t picture_width = 0;
@@ -126,12 +828,12 @@ RocJpegStatus RocJpegDecoder::Decode(RocJpegStreamHandle jpeg_stream_handle, con
     roi_width = decode_params->crop_rectangle.right - decode_params->crop_rectangle.left;
     roi_height = decode_params->crop_rectangle.bottom - decode_params->crop_rectangle.top;
 
-    if (roi_width > 0 && roi_height > 0 && roi_width <= jpeg_stream_params->picture_parameter_buffer.picture_width && roi_height <= jpeg_stream_params->picture_parameter_buffer.picture_height) {
+    if (roi_width > 0 && roi_height > 0 && roi_width <= image_width && roi_height <= image_height) {
         is_roi_valid = true;
     }
 
-    picture_width = is_roi_valid ? roi_width : jpeg_stream_params->picture_parameter_buffer.picture_width;
-    picture_height = is_roi_valid ? roi_height : jpeg_stream_params->picture_parameter_buffer.picture_height;
+    picture_width = is_roi_valid ? roi_width : image_width;
+    picture_height = is_roi_valid ? roi_height : image_height;
 
     VcnJpegSpec current_vcn_jpeg_spec = jpeg_vaapi_decoder_.GetCurrentVcnJpegSpec();
     if (is_roi_valid && current_vcn_jpeg_spec.can_roi_decode) {
@@ -178,118 +880,9 @@ RocJpegStatus RocJpegDecoder::Decode(RocJpegStreamHandle jpeg_stream_handle, con
         default:
             break;
     }
-
-    CHECK_ROCJPEG(jpeg_vaapi_decoder_.SetSurfaceAsIdle(current_surface_id));
-    CHECK_HIP(hipStreamSynchronize(hip_stream_));
     return ROCJPEG_STATUS_SUCCESS;
 }
 
-/**
- * Decodes a batch of JPEG streams using the specified decode parameters and stores the decoded images in the provided destinations.
- *
- * @param jpeg_streams An array of RocJpegStreamHandle objects representing the JPEG streams to be decoded.
- * @param batch_size The number of JPEG streams in the batch.
- * @param decode_params A pointer to RocJpegDecodeParams object containing the decode parameters.
- * @param destinations An array of RocJpegImage objects where the decoded images will be stored.
- * @return A RocJpegStatus value indicating the success or failure of the decoding operation.
- */
-RocJpegStatus RocJpegDecoder::DecodeBatched(RocJpegStreamHandle *jpeg_streams, int batch_size, const RocJpegDecodeParams *decode_params, RocJpegImage *destinations) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (jpeg_streams == nullptr || decode_params == nullptr || destinations == nullptr) {
-        return ROCJPEG_STATUS_INVALID_PARAMETER;
-    }
-
-    std::vector<VASurfaceID> current_surface_ids;
-    std::vector<JpegStreamParameters> jpeg_streams_params;
-    current_surface_ids.resize(batch_size);
-    jpeg_streams_params.resize(batch_size);
-    VcnJpegSpec current_vcn_jpeg_spec = jpeg_vaapi_decoder_.GetCurrentVcnJpegSpec();
-
-    for (int i = 0; i < batch_size; i += current_vcn_jpeg_spec.num_jpeg_cores) {
-        int batch_end = std::min(i + static_cast<int>(current_vcn_jpeg_spec.num_jpeg_cores), batch_size);
-        int current_batch_size = batch_end - i;
-
-        for (int j = i; j < batch_end; j++) {
-            auto rocjpeg_stream_handle = static_cast<RocJpegStreamParserHandle*>(jpeg_streams[j]);
-            const JpegStreamParameters *jpeg_stream_params = rocjpeg_stream_handle->rocjpeg_stream->GetJpegStreamParameters();
-            jpeg_streams_params[j] = std::move(*jpeg_stream_params);
-        }
-
-        CHECK_ROCJPEG(jpeg_vaapi_decoder_.SubmitDecodeBatched(jpeg_streams_params.data() + i, current_batch_size, decode_params, current_surface_ids.data() + i));
-
-        for (int k = 0; k < current_batch_size; k++) {
-            HipInteropDeviceMem hip_interop_dev_mem = {};
-            VASurfaceID current_surface_id = *(current_surface_ids.data() + k + i);
-            const JpegStreamParameters *jpeg_stream_params = jpeg_streams_params.data() + k + i;
-            CHECK_ROCJPEG(jpeg_vaapi_decoder_.SyncSurface(current_surface_id));
-            CHECK_ROCJPEG(jpeg_vaapi_decoder_.GetHipInteropMem(current_surface_id, hip_interop_dev_mem));
-
-            uint16_t chroma_height = 0;
-            uint16_t picture_width = 0;
-            uint16_t picture_height = 0;
-            bool is_roi_valid = false;
-            uint32_t roi_width;
-            uint32_t roi_height;
-            roi_width = decode_params->crop_rectangle.right - decode_params->crop_rectangle.left;
-            roi_height = decode_params->crop_rectangle.bottom - decode_params->crop_rectangle.top;
-    
-            if (roi_width > 0 && roi_height > 0 && roi_width <= jpeg_stream_params->picture_parameter_buffer.picture_width && roi_height <= jpeg_stream_params->picture_parameter_buffer.picture_height) {
-                is_roi_valid = true;
-            }
-
-            picture_width = is_roi_valid ? roi_width : jpeg_stream_params->picture_parameter_buffer.picture_width;
-            picture_height = is_roi_valid ? roi_height : jpeg_stream_params->picture_parameter_buffer.picture_height;
-
-            if (is_roi_valid && current_vcn_jpeg_spec.can_roi_decode) {
-                // Set is_roi_valid to false because in this case, the hardware handles the ROI decode and we don't need to calculate the roi_offset
-                // later in the following functions (e.g., CopyChannel, GetPlanarYUVOutputFormat, etc) to copy the crop rectangle
-                is_roi_valid = false;
-            }
-
-            switch (decode_params->output_format) {
-                case ROCJPEG_OUTPUT_NATIVE:
-                    // Copy the native decoded output buffers from interop memory directly to the destination buffers
-                    CHECK_ROCJPEG(GetChromaHeight(hip_interop_dev_mem.surface_format, picture_height, chroma_height));
-                    // Copy Luma (first channel) for any surface format
-                    CHECK_ROCJPEG(CopyChannel(hip_interop_dev_mem, picture_height, 0, &destinations[k + i], decode_params, is_roi_valid));
-                    if (hip_interop_dev_mem.surface_format == VA_FOURCC_NV12) {
-                        // Copy the second channel (UV interleaved) for NV12
-                        CHECK_ROCJPEG(CopyChannel(hip_interop_dev_mem, chroma_height, 1, &destinations[k + i], decode_params, is_roi_valid));
-                    } else if (hip_interop_dev_mem.surface_format == VA_FOURCC_444P ||
-                            hip_interop_dev_mem.surface_format == VA_FOURCC_422V) {
-                        // Copy the second and third channels for YUV444 and YUV440 (i.e., YUV422V)
-                        CHECK_ROCJPEG(CopyChannel(hip_interop_dev_mem, chroma_height, 1, &destinations[k + i], decode_params, is_roi_valid));
-                        CHECK_ROCJPEG(CopyChannel(hip_interop_dev_mem, chroma_height, 2, &destinations[k + i], decode_params, is_roi_valid));
-                    }
-                    break;
-                case ROCJPEG_OUTPUT_YUV_PLANAR:
-                    CHECK_ROCJPEG(GetChromaHeight(hip_interop_dev_mem.surface_format, picture_height, chroma_height));
-                    CHECK_ROCJPEG(GetPlanarYUVOutputFormat(hip_interop_dev_mem, picture_width,
-                                                        picture_height, chroma_height, &destinations[k + i], decode_params, is_roi_valid));
-                    break;
-                case ROCJPEG_OUTPUT_Y:
-                    CHECK_ROCJPEG(GetYOutputFormat(hip_interop_dev_mem, picture_width,
-                                                picture_height, &destinations[k + i], decode_params, is_roi_valid));
-                    break;
-                case ROCJPEG_OUTPUT_RGB:
-                    CHECK_ROCJPEG(ColorConvertToRGB(hip_interop_dev_mem, picture_width,
-                                                            picture_height, &destinations[k + i], decode_params, is_roi_valid));
-                    break;
-                case ROCJPEG_OUTPUT_RGB_PLANAR:
-                    CHECK_ROCJPEG(ColorConvertToRGBPlanar(hip_interop_dev_mem, picture_width,
-                                                            picture_height, &destinations[k + i], decode_params, is_roi_valid));
-                    break;
-                default:
-                    break;
-            }
-            CHECK_ROCJPEG(jpeg_vaapi_decoder_.SetSurfaceAsIdle(current_surface_id));
-        }
-
-    }
-
-    CHECK_HIP(hipStreamSynchronize(hip_stream_));
-    return ROCJPEG_STATUS_SUCCESS;
-}
 /**
  * @brief Retrieves the image information from the JPEG stream.
  *
@@ -312,9 +905,9 @@ RocJpegStatus RocJpegDecoder::GetImageInfo(RocJpegStreamHandle jpeg_stream_handl
     auto rocjpeg_stream_handle = static_cast<RocJpegStreamParserHandle*>(jpeg_stream_handle);
     const JpegStreamParameters *jpeg_stream_params = rocjpeg_stream_handle->rocjpeg_stream->GetJpegStreamParameters();
 
-    *num_components = jpeg_stream_params->picture_parameter_buffer.num_components;
-    widths[0] = jpeg_stream_params->picture_parameter_buffer.picture_width;
-    heights[0] = jpeg_stream_params->picture_parameter_buffer.picture_height;
+    *num_components = jpeg_stream_params->picture_parameters.num_components;
+    widths[0] = jpeg_stream_params->picture_parameters.picture_width;
+    heights[0] = jpeg_stream_params->picture_parameters.picture_height;
     widths[3] = 0;
     heights[3] = 0;
 
@@ -24,9 +24,17 @@ THE SOFTWARE.
 #define ROC_JPEG_DECODER_H_
 
 #include <unistd.h>
+#include <sys/eventfd.h>
 #include <vector>
 #include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
 #include <queue>
+#include <deque>
+#include <map>
+#include <algorithm>
+#include <functional>
 #include "../api/rocjpeg.h"
 #include "rocjpeg_api_stream_handle.h"
 #include "rocjpeg_parser.h"
@@ -34,6 +42,43 @@ THE SOFTWARE.
 #include "rocjpeg_vaapi_decoder.h"
 #include "rocjpeg_hip_kernels.h"
 
+/**
+ * @brief The progress of an asynchronous decode job.
+ */
+typedef enum {
+    kJobDecoding = 0, /**< Some surfaces are still being decoded by the VCN; the decoded ones are post-processed in order. */
+    kJobPostProcessing = 1, /**< All the surfaces are decoded; the post-processing on the HIP stream has not completed yet. */
+} RocJpegDecodeJobState;
+
+/**
+ * @brief An asynchronous decode job submitted by DecodeAsync or DecodeBatchedAsync.
+ */
+struct RocJpegDecodeJob {
+    uint64_t job_id; // ID of the job returned to the caller
+    bool is_aborted; // Set if the submission failed, so the job is completed without being reported
+    RocJpegDecodeJobState state; // Progress of the job
+    RocJpegStatus status; // First error of the job, or ROCJPEG_STATUS_SUCCESS
+    RocJpegDecodeParams decode_params; // Copy of the decode parameters
+    std::vector<VASurfaceID> surface_ids; // Output surfaces of the streams of the job
+    std::vector<RocJpegImage> destinations; // Copy of the destination images
+    std::vector<uint16_t> picture_widths; // Widths of the images of the job
+    std::vector<uint16_t> picture_heights; // Heights of the images of the job
+    uint32_t num_post_processed; // Number of surfaces whose post-processing has been enqueued
+    hipEvent_t post_processed_event; // Recorded on the HIP stream after the post-processing of the last surface
+    RocJpegJobCallback callback; // Called by the completion thread when the job completes, or nullptr
+    void *callback_user_data; // Passed to the callback
+};
+
+/**
+ * @brief A completed job whose callback is to be called by the completion thread.
+ */
+struct RocJpegJobCallbackRecord {
+    uint64_t job_id;
+    RocJpegStatus status;
+    RocJpegJobCallback callback;
+    void *user_data;
+};
+
 /**
  * @class RocJpegDecoder
  * @brief The RocJpegDecoder class represents a JPEG decoder.
@@ -99,6 +144,78 @@ public:
     */
    RocJpegStatus DecodeBatched(RocJpegStreamHandle *jpeg_streams, int batch_size, const RocJpegDecodeParams *decode_params, RocJpegImage *destinations);
 
+   /**
+    * @brief Submits a JPEG stream for decoding without waiting for the decoded image.
+    * @param jpeg_stream The handle to the JPEG stream.
+    * @param decode_params The decoding parameters.
+    * @param destination Pointer to the destination image.
+    * @param job_id Pointer to store the ID of the decode job.
+    * @return The status of the submission.
+    */
+   RocJpegStatus DecodeAsync(RocJpegStreamHandle jpeg_stream, const RocJpegDecodeParams *decode_params, RocJpegImage *destination, uint64_t *job_id);
+
+   /**
+    * @brief Submits a batch of JPEG streams for decoding without waiting for the decoded images.
+    * @param jpeg_streams The array of JPEG stream handles.
+    * @param batch_size The number of JPEG streams in the batch.
+    * @param decode_params The decoding parameters.
+    * @param destinations The array of destination images.
+    * @param job_id Pointer to store the ID of the decode job.
+    * @return The status of the submission.
+    */
+   RocJpegStatus DecodeBatchedAsync(RocJpegStreamHandle *jpeg_streams, int batch_size, const RocJpegDecodeParams *decode_params, RocJpegImage *destinations, uint64_t *job_id);
+
+   /**
+    * @brief Queries the status of a decode job without blocking.
+    * @param job_id The ID of the decode job.
+    * @return ROCJPEG_STATUS_NOT_READY while the job is in flight, otherwise the status of the job.
+    */
+   RocJpegStatus Query(uint64_t job_id);
+
+   /**
+    * @brief Waits for a decode job to complete.
+    * @param job_id The ID of the decode job.
+    * @return The status of the job.
+    */
+   RocJpegStatus Wait(uint64_t job_id);
+
+   /**
+    * @brief Sets the function called when a decode job completes.
+    * @param job_id The ID of the decode job.
+    * @param callback The function to call, or nullptr.
+    * @param user_data The pointer passed to the callback.
+    * @return The status of the operation.
+    */
+   RocJpegStatus SetJobCallback(uint64_t job_id, RocJpegJobCallback callback, void *user_data);
+
+   /**
+    * @brief Retrieves the eventfd signaled when decode jobs complete.
+    * @param fd Pointer to store the file descriptor.
+    * @return The status of the operation.
+    */
+   RocJpegStatus GetCompletionFd(int *fd);
+
+   /**
+    * @brief Removes the completed jobs from the queue of completions published on the eventfd.
+    * @param completions The array that receives the completed jobs.
+    * @param num_completions The capacity of the array on input, the number of completed jobs on output.
+    * @return The status of the operation.
+    */
+   RocJpegStatus GetCompletedJobs(RocJpegJobCompletion *completions, uint32_t *num_completions);
+
+   /**
+    * @brief Sets the memory budget and idle timeout of the surfaces of the decoder.
+    * @param memory_limits The memory limits.
+    * @return The status of the operation.
+    */
+   RocJpegStatus SetMemoryLimits(const RocJpegMemoryLimits *memory_limits);
+
+   /**
+    * @brief Releases the surfaces of the decoder that are not in use.
+    * @return The status of the operation.
+    */
+   RocJpegStatus TrimMemory();
+
 private:
    /**
     * @brief Initializes the HIP framework.
@@ -167,6 +284,89 @@ private:
     */
    RocJpegStatus GetYOutputFormat(HipInteropDeviceMem& hip_interop, uint32_t picture_width, uint32_t picture_height, RocJpegImage *destination, const RocJpegDecodeParams *decode_params, bool is_roi_valid);
 
+   /**
+    * @brief Retrieves the parameters of a batch of parsed JPEG streams.
+    * @param jpeg_streams The array of JPEG stream handles.
+    * @param batch_size The number of JPEG streams in the batch.
+    * @param streams_params Receives the parameters of the streams.
+    * @return The status of the operation.
+    */
+   RocJpegStatus GetBatchStreamParameters(RocJpegStreamHandle *jpeg_streams, int batch_size, std::vector<const JpegStreamParameters*> &streams_params);
+
+   /**
+    * @brief Post-processes a decoded surface into the destination image on the HIP stream.
+    * @param surface_id The decoded surface.
+    * @param image_width The width of the image.
+    * @param image_height The height of the image.
+    * @param decode_params The decoding parameters.
+    * @param destination Pointer to the destination image.
+    * @return The status of the operation.
+    */
+   RocJpegStatus PostProcessSurface(VASurfaceID surface_id, uint16_t image_width, uint16_t image_height, const RocJpegDecodeParams *decode_params, RocJpegImage *destination);
+
+   /**
+    * @brief Finds a decode job that is in flight.
+    * @param job_id The ID of the decode job.
+    * @return The iterator to the job, or pending_jobs_.end() if it is not in flight.
+    */
+   std::deque<RocJpegDecodeJob>::iterator FindPendingJob(uint64_t job_id);
+
+   /**
+    * @brief Retrieves the status of a decode job that is no longer in flight. The mutex must be held.
+    * @param job_id The ID of the decode job.
+    * @return The status of the job, or ROCJPEG_STATUS_INVALID_PARAMETER if it is no longer kept.
+    */
+   RocJpegStatus GetCompletedJobStatus(uint64_t job_id);
+
+   /**
+    * @brief Advances the decode jobs in flight without blocking. The mutex must be held.
+    */
+   void ProgressJobs();
+
+   /**
+    * @brief Blocks until a decode job is no longer in flight, releasing the mutex while waiting.
+    * @param lock The lock on the mutex, held by the caller.
+    * @param job_id The ID of the decode job.
+    * @return The status of the wait.
+    */
+   RocJpegStatus CompleteJob(std::unique_lock<std::mutex> &lock, uint64_t job_id);
+
+   /**
+    * @brief Blocks, with the mutex released, until the next step of a decode job can be taken.
+    * @param lock The lock on the mutex, held by the caller.
+    * @param job The decode job.
+    * @return The status of the wait.
+    */
+   RocJpegStatus WaitForJobProgress(std::unique_lock<std::mutex> &lock, const RocJpegDecodeJob &job);
+
+   /**
+    * @brief Submits streams to the VAAPI decoder, applying the surface acquire mode when the memory budget is exhausted.
+    *
+    * The mutex is released while waiting for the jobs in flight to release surfaces, so the streams and the surfaces
+    * the submission refers to must be owned by the calling thread.
+    *
+    * @param lock The lock on the mutex, held by the caller.
+    * @param submit Submits the streams, failing with ROCJPEG_STATUS_NOT_READY if it is told to enforce the budget
+    *        and the new surfaces do not fit in it.
+    * @param is_admission Whether these are the first streams of a decode call, which are not submitted at all in the
+    *        ROCJPEG_SURFACE_ACQUIRE_TRY mode if the budget is exhausted.
+    * @return The status of the submission, or ROCJPEG_STATUS_NOT_READY if no surface could be acquired in time.
+    */
+   RocJpegStatus SubmitWithBackpressure(std::unique_lock<std::mutex> &lock, const std::function<RocJpegStatus(bool)> &submit, bool is_admission);
+
+   /**
+    * @brief Starts the completion thread if it is not running. The mutex must be held.
+    * @return The status of the operation.
+    */
+   RocJpegStatus StartCompletionThread();
+
+   /**
+    * @brief The body of the completion thread.
+    */
+   void RunCompletionThread();
+
+   static constexpr uint64_t kJobStatusWindow = 4096; // Number of most recent jobs whose status is kept
+
    int num_devices_; // Number of available devices
    int device_id_; // ID of the device to be used
    hipDeviceProp_t hip_dev_prop_; // HIP device properties
@@ -174,6 +374,21 @@ private:
    std::mutex mutex_; // Mutex for thread safety
    RocJpegBackend backend_; // RocJpeg backend
    RocJpegVappiDecoder jpeg_vaapi_decoder_; // RocJpeg VAAPI decoder object
+   std::vector<hipEvent_t> batch_group_events_; // Events recorded after the post-processing of the groups of DecodeBatched, alternately
+   uint64_t next_job_id_; // ID of the next decode job; IDs start at 1
+   std::deque<RocJpegDecodeJob> pending_jobs_; // Decode jobs in flight, in submission order
+   std::map<uint64_t, RocJpegStatus> failed_job_statuses_; // Statuses of the failed jobs among the kJobStatusWindow most recent ones
+   std::vector<hipEvent_t> idle_job_events_; // Events of the completed jobs, reused by the following jobs
+   int completion_fd_; // eventfd signaled for each completed job once requested, or -1
+   std::deque<RocJpegJobCompletion> completed_jobs_; // Completed jobs published on completion_fd_, not yet retrieved
+   std::vector<RocJpegJobCallbackRecord> job_callbacks_; // Callbacks of the completed jobs, not yet called
+   std::thread completion_thread_; // Advances the jobs and calls the callbacks once started
+   std::condition_variable completion_cv_; // Wakes up the completion thread
+   std::condition_variable surfaces_released_cv_; // Notified when jobs release their surfaces, for the decodes waiting for surfaces
+   bool stop_completion_thread_; // Set when the decoder is destroyed
+   uint32_t idle_timeout_ms_; // Time after which the completion thread releases an idle surface, or 0
+   RocJpegSurfaceAcquireMode surface_acquire_mode_; // What a decode does when the memory budget is exhausted
+   uint32_t surface_acquire_timeout_ms_; // Maximum wait of ROCJPEG_SURFACE_ACQUIRE_WAIT, or 0 for no limit
 };
 
 #endif //ROC_JPEG_DECODER_H_
\ No newline at end of file
@@ -19,10 +19,264 @@ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
+#include <cstdlib>
 #include "rocjpeg_parser.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+// The luminance and chrominance quantization tables of Annex K of ITU-T T.81, in zigzag order, which the IJG
+// library scales by the quality factor.
+const uint8_t kStdLuminanceQuantTable[64] = {
+    16,  11,  12,  14,  12,  10,  16,  14,  13,  14,  18,  17,  16,  19,  24,  40,
+    26,  24,  22,  22,  24,  49,  35,  37,  29,  40,  58,  51,  61,  60,  57,  51,
+    56,  55,  64,  72,  92,  78,  64,  68,  87,  69,  55,  56,  80, 109,  81,  87,
+    95,  98, 103, 104, 103,  62,  77, 113, 121, 112, 100, 120,  92, 101, 103,  99,
+};
+const uint8_t kStdChrominanceQuantTable[64] = {
+    17,  18,  18,  24,  21,  24,  47,  26,  26,  47,  99,  66,  56,  66,  99,  99,
+    99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,
+    99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,
+    99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,
+};
+
+// The typical Huffman tables of Annex K.3 of the JPEG specification, which are used by Motion-JPEG frames that omit
+// their DHT segments: table 0 for the luminance and table 1 for the chrominance components.
+const HuffmanTableBuffer kStdHuffmanTables = {
+    {1, 1},
+    {
+        {
+            {0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0},
+            {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11},
+            {0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7D},
+            {
+                0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+                0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08, 0x23, 0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1, 0xF0,
+                0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x25, 0x26, 0x27, 0x28,
+                0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+                0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+                0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+                0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7,
+                0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5,
+                0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1, 0xE2,
+                0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+                0xF9, 0xFA,
+            },
+            {0, 0},
+        },
+        {
+            {0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0},
+            {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11},
+            {0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77},
+            {
+                0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+                0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0,
+                0x15, 0x62, 0x72, 0xD1, 0x0A, 0x16, 0x24, 0x34, 0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26,
+                0x27, 0x28, 0x29, 0x2A, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+                0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+                0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+                0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5,
+                0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3,
+                0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA,
+                0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+                0xF9, 0xFA,
+            },
+            {0, 0},
+        },
+    },
+    {0, 0, 0, 0},
+};
+
+// The primes of the XXH64 hash function.
+const uint64_t kXxhPrime1 = 0x9E3779B185EBCA87ULL;
+const uint64_t kXxhPrime2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t kXxhPrime3 = 0x165667B19E3779F9ULL;
+const uint64_t kXxhPrime4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t kXxhPrime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t XxhRotl(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t XxhRead64(const uint8_t *data) {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
 
-RocJpegStreamParser::RocJpegStreamParser() : stream_{nullptr}, stream_end_{nullptr}, stream_length_{0},
-    jpeg_stream_parameters_{{}} {
+inline uint64_t XxhRound(uint64_t acc, uint64_t input) {
+    return XxhRotl(acc + input * kXxhPrime2, 31) * kXxhPrime1;
+}
+
+inline uint64_t XxhMerge(uint64_t acc, uint64_t lane) {
+    return (acc ^ XxhRound(0, lane)) * kXxhPrime1 + kXxhPrime4;
+}
+
+/**
+ * @brief Completes an XXH64 hash with the bytes that do not fill a 32-byte stripe.
+ * @param hash The hash of the stripes, with the total length added.
+ * @param data The remaining bytes.
+ * @param size The number of remaining bytes (less than 32).
+ * @return The final hash.
+ */
+uint64_t XxhFinalize(uint64_t hash, const uint8_t *data, size_t size) {
+    for (; size >= 8; data += 8, size -= 8) {
+        hash = XxhRotl(hash ^ XxhRound(0, XxhRead64(data)), 27) * kXxhPrime1 + kXxhPrime4;
+    }
+    if (size >= 4) {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        hash = XxhRotl(hash ^ (value * kXxhPrime1), 23) * kXxhPrime2 + kXxhPrime3;
+        data += 4;
+        size -= 4;
+    }
+    for (; size > 0; data++, size--) {
+        hash = XxhRotl(hash ^ (*data * kXxhPrime5), 11) * kXxhPrime1;
+    }
+    hash ^= hash >> 33;
+    hash *= kXxhPrime2;
+    hash ^= hash >> 29;
+    hash *= kXxhPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+inline void XxhConsumeStripe(JpegContentHashState &state, const uint8_t *stripe) {
+    for (int i = 0; i < 4; i++) {
+        state.lanes[i] = XxhRound(state.lanes[i], XxhRead64(stripe + i * 8));
+    }
+}
+
+void XxhReset(JpegContentHashState &state, uint64_t seed) {
+    state.lanes[0] = seed + kXxhPrime1 + kXxhPrime2;
+    state.lanes[1] = seed + kXxhPrime2;
+    state.lanes[2] = seed;
+    state.lanes[3] = seed - kXxhPrime1;
+    state.buffer_size = 0;
+    state.total_size = 0;
+    state.seed = seed;
+}
+
+void XxhUpdate(JpegContentHashState &state, const uint8_t *data, size_t size) {
+    state.total_size += size;
+    if (state.buffer_size + size < 32) {
+        std::memcpy(state.buffer + state.buffer_size, data, size);
+        state.buffer_size += size;
+        return;
+    }
+    if (state.buffer_size > 0) {
+        size_t fill_size = 32 - state.buffer_size;
+        std::memcpy(state.buffer + state.buffer_size, data, fill_size);
+        XxhConsumeStripe(state, state.buffer);
+        data += fill_size;
+        size -= fill_size;
+    }
+    for (; size >= 32; data += 32, size -= 32) {
+        XxhConsumeStripe(state, data);
+    }
+    std::memcpy(state.buffer, data, size);
+    state.buffer_size = size;
+}
+
+uint64_t XxhDigest(const JpegContentHashState &state) {
+    uint64_t hash;
+    if (state.total_size >= 32) {
+        hash = XxhRotl(state.lanes[0], 1) + XxhRotl(state.lanes[1], 7) + XxhRotl(state.lanes[2], 12) + XxhRotl(state.lanes[3], 18);
+        for (int i = 0; i < 4; i++) {
+            hash = XxhMerge(hash, state.lanes[i]);
+        }
+    } else {
+        hash = state.seed + kXxhPrime5;
+    }
+    return XxhFinalize(hash + state.total_size, state.buffer, state.buffer_size);
+}
+
+/**
+ * @brief Finds the first EOI marker in a buffer.
+ * @return The position of the EOI marker, or data_end if there is none.
+ */
+const uint8_t *FindEoi(const uint8_t *data, const uint8_t *data_end) {
+    while (data + 1 < data_end) {
+        const uint8_t *marker_prefix = static_cast<const uint8_t*>(std::memchr(data, 0xFF, data_end - 1 - data));
+        if (marker_prefix == nullptr) {
+            break;
+        }
+        if (marker_prefix[1] == EOI) {
+            return marker_prefix;
+        }
+        data = marker_prefix + 1;
+    }
+    return data_end;
+}
+
+/**
+ * @brief Finds the EOI marker that ends the entropy-coded data and hashes the data in the same pass.
+ *
+ * The data is consumed in 32-byte stripes. Each stripe is first checked for an 0xFFD9 sequence (16 bytes at a time
+ * with SSE2), and is then folded into the four lanes of the XXH64 hash while it is still in the L1 cache, so the
+ * entropy-coded data is only read once. The stripe that contains the EOI marker and the bytes that follow the last
+ * stripe are searched and hashed separately. An EOI marker split between two buffers is not detected.
+ *
+ * @param scan_data The start of the entropy-coded data.
+ * @param scan_data_end The end of the buffer that contains the entropy-coded data.
+ * @param hash_state The state of the hash, which is updated with the data that precedes the EOI marker.
+ * @return The position of the EOI marker, or scan_data_end if there is none.
+ */
+const uint8_t *FindEoiAndHashScanData(const uint8_t *scan_data, const uint8_t *scan_data_end, JpegContentHashState &hash_state) {
+    const uint8_t *stripe = scan_data;
+    // Complete the stripe left over by the previous buffer of a scattered stream, so the others are hashed in place.
+    if (hash_state.buffer_size > 0) {
+        size_t fill_size = std::min<size_t>(32 - hash_state.buffer_size, scan_data_end - scan_data);
+        const uint8_t *search_end = std::min(scan_data + fill_size + 1, scan_data_end);
+        const uint8_t *eoi = FindEoi(scan_data, search_end);
+        if (eoi != search_end) {
+            XxhUpdate(hash_state, scan_data, eoi - scan_data);
+            return eoi;
+        }
+        XxhUpdate(hash_state, scan_data, fill_size);
+        stripe += fill_size;
+    }
+#if defined(__SSE2__)
+    const __m128i marker_prefix = _mm_set1_epi8(static_cast<char>(0xFF));
+    const __m128i eoi_marker = _mm_set1_epi8(static_cast<char>(EOI));
+#endif
+    // A stripe is only consumed if the byte that follows it can be read, to catch an EOI marker across two stripes.
+    while (scan_data_end - stripe > 32) {
+#if defined(__SSE2__)
+        __m128i eoi_low = _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(stripe)), marker_prefix),
+                                        _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(stripe + 1)), eoi_marker));
+        __m128i eoi_high = _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(stripe + 16)), marker_prefix),
+                                         _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(stripe + 17)), eoi_marker));
+        if (_mm_movemask_epi8(_mm_or_si128(eoi_low, eoi_high)) != 0) {
+            break;
+        }
+#else
+        bool eoi_marker_found = false;
+        for (int i = 0; i < 32 && !eoi_marker_found; i++) {
+            eoi_marker_found = stripe[i] == 0xFF && stripe[i + 1] == EOI;
+        }
+        if (eoi_marker_found) {
+            break;
+        }
+#endif
+        XxhConsumeStripe(hash_state, stripe);
+        hash_state.total_size += 32;
+        stripe += 32;
+    }
+
+    const uint8_t *eoi = FindEoi(stripe, scan_data_end);
+    XxhUpdate(hash_state, stripe, eoi - stripe);
+    return eoi;
+}
+} // namespace
+
+RocJpegStreamParser::RocJpegStreamParser() : stream_start_{nullptr}, stream_{nullptr}, stream_end_{nullptr}, stream_length_{0},
+    jpeg_stream_parameters_{{}}, table_set_{}, jpeg_stream_metadata_{}, sof_marker_found_{false}, dht_marker_found_{false}, dqt_marker_found_{false},
+    sos_marker_found_{false}, chunk_parse_offset_{0}, chunk_scan_data_offset_{0}, chunk_eoi_search_offset_{0},
+    chunk_parse_state_{CHUNK_PARSE_NEED_MORE_DATA}, chunk_hash_state_{}, content_hash_{0} {
+    jpeg_stream_metadata_.adobe_transform = -1;
+    jpeg_stream_metadata_.app_segments.reserve(8);
 }
 
 RocJpegStreamParser::~RocJpegStreamParser() {
@@ -41,21 +295,18 @@ RocJpegStreamParser::~RocJpegStreamParser() {
  * @return True if the JPEG stream was successfully parsed, false otherwise.
  */
 bool RocJpegStreamParser::ParseJpegStream(const uint8_t *jpeg_stream, uint32_t jpeg_stream_size) {
-    std::lock_guard<std::mutex> lock(mutex_);
     if (jpeg_stream == nullptr) {
         ERR("invalid argument!");
         return false;
     }
 
+    ResetParseState();
+    stream_start_ = jpeg_stream;
     stream_ = jpeg_stream;
     stream_length_ = jpeg_stream_size;
     stream_end_ = stream_ + stream_length_;
 
-    jpeg_stream_parameters_ = {};
     bool soi_marker_found = false;
-    bool sos_marker_found = false;
-    bool dht_marker_found = false;
-    bool dqt_marker_found = false;
     uint8_t marker;
     const uint8_t *next_chunck;
     int32_t chuck_len;
@@ -71,58 +322,900 @@ bool RocJpegStreamParser::ParseJpegStream(const uint8_t *jpeg_stream, uint32_t j
         ERR("failed to find the SOI marker!");
     }
 
-    while (!sos_marker_found  && stream_ <= stream_end_) {
+    while (!sos_marker_found_  && stream_ <= stream_end_) {
         while ((*stream_ == 0xFF))
             stream_++;
         marker = *stream_++;
         chuck_len = swap_bytes(stream_);
         next_chunck = stream_ + chuck_len;
 
-        switch (marker) {
-            case SOF:
-                if (!ParseSOF())
-                    return false;
-                break;
-            case DHT:
-                if (!ParseDHT())
-                    return false;
-                dht_marker_found = true;
-                break;
-            case DQT:
-                if (!ParseDQT())
-                    return false;
-                dqt_marker_found = true;
-                break;
-            case DRI:
-                if (!ParseDRI())
-                    return false;
-                break;
-            case SOS:
-                if (!ParseSOS())
-                    return false;
-                sos_marker_found = true;
-                break;
-            default:
-                break;
-        }
+        if (!ParseMarkerSegment(marker))
+            return false;
         stream_ = next_chunck;
     }
 
-    if (!dht_marker_found) {
-        ERR("didn't find any Huffman table!");
+    if (!dqt_marker_found_) {
+        ERR("didn't find any quantization table!");
+        return false;
+    }
+
+    if (!ParseEOI())
+        return false;
+
+    return true;
+}
+
+/**
+ * @brief Parses the next chunk of a JPEG stream.
+ *
+ * This function appends the chunk to the parser's buffer and parses all the marker segments that are complete,
+ * up to and including the SOS marker. The entropy-coded data that follows the SOS marker is not parsed; it is
+ * only searched for the EOI marker, which completes the stream together with `is_last_chunk`. The image
+ * dimensions are available as soon as the state reaches CHUNK_PARSE_FRAME_HEADER_READY.
+ *
+ * @param chunk A pointer to the chunk of the JPEG stream.
+ * @param chunk_size The size of the chunk in bytes.
+ * @param is_last_chunk True if this is the last chunk of the JPEG stream.
+ * @param parse_state Receives the progress of the parse after consuming the chunk.
+ * @return True if the chunk was successfully parsed, false otherwise.
+ */
+bool RocJpegStreamParser::ParseJpegStreamChunk(const uint8_t *chunk, uint32_t chunk_size, bool is_last_chunk, JpegChunkParseState *parse_state) {
+    if ((chunk == nullptr && chunk_size > 0) || parse_state == nullptr) {
+        ERR("invalid argument!");
+        return false;
+    }
+
+    // A new stream starts after the previous one has been completely parsed, or after a stream parsed at once
+    if (chunk_parse_state_ == CHUNK_PARSE_COMPLETE || chunk_buffer_.empty()) {
+        ResetParseState();
+    }
+    if (chunk_size > 0) {
+        chunk_buffer_.insert(chunk_buffer_.end(), chunk, chunk + chunk_size);
+    }
+
+    if (!ParseBufferedMarkerSegments()) {
+        ResetParseState();
+        return false;
+    }
+
+    const uint8_t *buffer = chunk_buffer_.data();
+    size_t buffer_size = chunk_buffer_.size();
+    if (sos_marker_found_) {
+        // Look for the EOI marker in the newly received entropy-coded data only, hashing it in the same pass.
+        // A trailing 0xFF byte is left for the next chunk, since it may be the prefix of the EOI marker.
+        size_t search_end = buffer_size;
+        if (!is_last_chunk && search_end > chunk_eoi_search_offset_ && buffer[search_end - 1] == 0xFF) {
+            search_end--;
+        }
+        const uint8_t *eoi = FindEoiAndHashScanData(buffer + chunk_eoi_search_offset_, buffer + search_end, chunk_hash_state_);
+        bool eoi_marker_found = eoi != buffer + search_end;
+        size_t offset = eoi - buffer;
+        chunk_eoi_search_offset_ = offset;
+
+        if (eoi_marker_found || is_last_chunk) {
+            if (!dqt_marker_found_) {
+                ERR("didn't find any quantization table!");
+                ResetParseState();
+                return false;
+            }
+            size_t scan_data_end = eoi_marker_found ? offset : buffer_size;
+            jpeg_stream_parameters_.slice_parameter_buffer.slice_data_size = scan_data_end - chunk_scan_data_offset_;
+            jpeg_stream_parameters_.slice_data_buffer = buffer + chunk_scan_data_offset_;
+            content_hash_ = XxhDigest(chunk_hash_state_);
+            chunk_parse_state_ = CHUNK_PARSE_COMPLETE;
+        } else {
+            chunk_parse_state_ = CHUNK_PARSE_SCAN_HEADER_READY;
+        }
+    } else if (is_last_chunk) {
+        ERR("the JPEG stream ended before the SOS marker!");
+        ResetParseState();
+        return false;
+    } else {
+        chunk_parse_state_ = sof_marker_found_ ? CHUNK_PARSE_FRAME_HEADER_READY : CHUNK_PARSE_NEED_MORE_DATA;
+    }
+
+    *parse_state = chunk_parse_state_;
+    return true;
+}
+
+/**
+ * @brief Parses a JPEG stream that is scattered over several buffers.
+ *
+ * The buffers are copied into the chunk buffer a piece at a time, and the marker segments are parsed as they
+ * become complete, until the SOS marker is found. At most the headers and the first piece of the entropy-coded
+ * data are copied. The rest of the entropy-coded data is searched for the EOI marker and hashed in place, and is
+ * recorded as a list of segments.
+ *
+ * @param iov The buffers of the JPEG stream, in order.
+ * @param iov_count The number of buffers.
+ * @return True if the parsing is successful, false otherwise.
+ */
+bool RocJpegStreamParser::ParseJpegStreamV(const struct iovec *iov, int iov_count) {
+    if (iov == nullptr || iov_count <= 0) {
+        ERR("invalid argument!");
+        return false;
+    }
+    if (iov_count == 1) {
+        return ParseJpegStream(static_cast<const uint8_t*>(iov[0].iov_base), static_cast<uint32_t>(iov[0].iov_len));
+    }
+
+    const size_t header_piece_size = 4096;
+    ResetParseState();
+    int index = 0;
+    size_t offset = 0;
+    while (!sos_marker_found_ && index < iov_count) {
+        const uint8_t *data = static_cast<const uint8_t*>(iov[index].iov_base);
+        if (data == nullptr && iov[index].iov_len > 0) {
+            ERR("invalid argument!");
+            ResetParseState();
+            return false;
+        }
+        size_t piece_size = std::min(iov[index].iov_len - offset, header_piece_size);
+        chunk_buffer_.insert(chunk_buffer_.end(), data + offset, data + offset + piece_size);
+        offset += piece_size;
+        if (!ParseBufferedMarkerSegments()) {
+            ResetParseState();
+            return false;
+        }
+        if (!sos_marker_found_ && offset == iov[index].iov_len) {
+            index++;
+            offset = 0;
+        }
+    }
+    if (!sos_marker_found_) {
+        ERR("the JPEG stream ended before the SOS marker!");
+        ResetParseState();
         return false;
     }
-    if (!dqt_marker_found) {
+    if (!dqt_marker_found_) {
         ERR("didn't find any quantization table!");
+        ResetParseState();
         return false;
     }
 
-    if (!ParseEOI())
+    // The entropy-coded data starts in the last piece copied into the chunk buffer
+    offset -= chunk_buffer_.size() - chunk_scan_data_offset_;
+    JpegContentHashState hash_state;
+    XxhReset(hash_state, GetContentHashSeed());
+    size_t scan_data_size = 0;
+    bool eoi_marker_found = false;
+    for (; index < iov_count && !eoi_marker_found; index++, offset = 0) {
+        const uint8_t *data = static_cast<const uint8_t*>(iov[index].iov_base) + offset;
+        const uint8_t *data_end = static_cast<const uint8_t*>(iov[index].iov_base) + iov[index].iov_len;
+        if (data == data_end) {
+            continue;
+        }
+        if (data_end[-1] == 0xFF) {
+            // The EOI marker may be split between this buffer and the next non-empty one
+            int next_index = index + 1;
+            while (next_index < iov_count && iov[next_index].iov_len == 0) {
+                next_index++;
+            }
+            if (next_index < iov_count && *static_cast<const uint8_t*>(iov[next_index].iov_base) == EOI) {
+                data_end--;
+                eoi_marker_found = true;
+            }
+        }
+        const uint8_t *eoi = FindEoiAndHashScanData(data, data_end, hash_state);
+        eoi_marker_found = eoi_marker_found || eoi != data_end;
+        if (eoi != data) {
+            scan_data_segments_.push_back({data, static_cast<size_t>(eoi - data)});
+            scan_data_size += eoi - data;
+        }
+    }
+    content_hash_ = XxhDigest(hash_state);
+
+    jpeg_stream_parameters_.slice_parameter_buffer.slice_data_size = static_cast<uint32_t>(scan_data_size);
+    jpeg_stream_parameters_.slice_data_buffer = scan_data_segments_.empty() ? chunk_buffer_.data() + chunk_scan_data_offset_ : scan_data_segments_[0].data;
+    if (scan_data_segments_.size() > 1) {
+        jpeg_stream_parameters_.slice_data_segments = scan_data_segments_.data();
+        jpeg_stream_parameters_.num_slice_data_segments = static_cast<uint32_t>(scan_data_segments_.size());
+    }
+    chunk_parse_state_ = CHUNK_PARSE_COMPLETE;
+    return true;
+}
+
+/**
+ * @brief Parses all the complete marker segments accumulated in the chunk buffer.
+ *
+ * This function resumes from where the previous call stopped and parses the marker segments whose payload has
+ * been fully received, stopping at the first incomplete segment or after the SOS marker.
+ *
+ * @return true if the buffered marker segments are successfully parsed, false otherwise.
+ */
+bool RocJpegStreamParser::ParseBufferedMarkerSegments() {
+    const uint8_t *buffer = chunk_buffer_.data();
+    size_t buffer_size = chunk_buffer_.size();
+
+    while (!sos_marker_found_) {
+        if (chunk_parse_offset_ == 0) {
+            // The first two bytes of a JPEG must be 0XFFD8
+            if (buffer_size < 2) {
+                break;
+            }
+            if (buffer[0] != 0xFF || buffer[1] != SOI) {
+                ERR("Invalid JPEG!");
+                return false;
+            }
+            chunk_parse_offset_ = 2;
+            continue;
+        }
+
+        size_t offset = chunk_parse_offset_;
+        while (offset < buffer_size && buffer[offset] == 0xFF) {
+            offset++;
+        }
+        // Wait for the marker and the length field of the segment
+        if (offset + 3 > buffer_size) {
+            break;
+        }
+        uint8_t marker = buffer[offset++];
+        size_t segment_length = swap_bytes(buffer + offset);
+        if (segment_length < 2) {
+            ERR("invalid length of the marker segment!");
+            return false;
+        }
+        // Wait for the whole segment
+        if (offset + segment_length > buffer_size) {
+            break;
+        }
+
+        stream_ = buffer + offset;
+        stream_length_ = buffer_size;
+        stream_end_ = buffer + buffer_size;
+        if (!ParseMarkerSegment(marker)) {
+            return false;
+        }
+        chunk_parse_offset_ = offset + segment_length;
+        if (sos_marker_found_) {
+            chunk_scan_data_offset_ = chunk_parse_offset_;
+            chunk_eoi_search_offset_ = chunk_parse_offset_;
+            XxhReset(chunk_hash_state_, GetContentHashSeed());
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Parses a marker segment of the JPEG stream.
+ *
+ * This function dispatches the marker segment to its parsing function and records which of the markers
+ * required for decoding have been found. Marker segments that are not needed for decoding are skipped.
+ *
+ * @param marker The marker of the segment.
+ * @return true if the marker segment is successfully parsed, false otherwise.
+ */
+bool RocJpegStreamParser::ParseMarkerSegment(uint8_t marker) {
+    switch (marker) {
+        case SOF:
+            if (!ParseSOF())
+                return false;
+            sof_marker_found_ = true;
+            break;
+        case DHT:
+            if (!ParseDHT())
+                return false;
+            dht_marker_found_ = true;
+            break;
+        case DQT:
+            if (!ParseDQT())
+                return false;
+            dqt_marker_found_ = true;
+            break;
+        case DRI:
+            if (!ParseDRI())
+                return false;
+            break;
+        case SOS:
+            if (!ParseSOS())
+                return false;
+            sos_marker_found_ = true;
+            // Motion-JPEG frames usually omit the DHT segments and rely on the typical tables of Annex K.3. They are
+            // interned like tables read from the stream, so all the frames of such a stream share a single copy.
+            if (!dht_marker_found_) {
+                std::memcpy(&table_set_.huffman_table_buffer, &kStdHuffmanTables, sizeof(HuffmanTableBuffer));
+            }
+            // The tables are complete once the scan starts; share them with the other streams that use the same tables.
+            // A handle that is reused for images from the same encoder keeps its tables without a cache lookup.
+            if (interned_table_set_ == nullptr || !JpegTableCache::IsEqual(interned_table_set_->table_set, table_set_)) {
+                interned_table_set_ = JpegTableCache::GetInstance().Intern(table_set_);
+            }
+            jpeg_stream_parameters_.quantization_matrix_buffer = &interned_table_set_->table_set.quantization_matrix_buffer;
+            jpeg_stream_parameters_.huffman_table_buffer = &interned_table_set_->table_set.huffman_table_buffer;
+            jpeg_stream_parameters_.huffman_lookup_tables = &interned_table_set_->huffman_lookup_tables;
+            // The APP2 segments precede the scan, so the ICC profile is complete as well. It is assembled here rather than
+            // when it is queried, so the parsed stream is not modified afterwards.
+            AssembleIccProfile();
+            break;
+        default:
+            if (marker >= APP0 && marker <= APP0 + 15) {
+                if (!ParseAPP(marker))
+                    return false;
+            }
+            break;
+    }
+    return true;
+}
+
+/**
+ * @brief Parses an application (APPn) segment of the JPEG stream.
+ *
+ * This function records the location of the APP0 (JFIF), APP1 (EXIF), APP2 (ICC profile), and APP14 (Adobe)
+ * segments and extracts the metadata they carry: the JFIF pixel density, the EXIF orientation, the location of
+ * the ICC profile chunks, and the Adobe color transform. Other APPn segments are skipped. A segment whose
+ * payload is truncated is ignored, as the metadata is not needed for decoding.
+ *
+ * @param marker The APPn marker of the segment.
+ * @return true if the APPn segment is successfully parsed, false otherwise.
+ */
+bool RocJpegStreamParser::ParseAPP(uint8_t marker) {
+    if (stream_ == nullptr) {
         return false;
+    }
+    if (marker != APP0 && marker != APP1 && marker != APP2 && marker != APP14) {
+        return true;
+    }
+
+    uint32_t length = swap_bytes(stream_);
+    const uint8_t *payload = stream_ + 2;
+    if (length < 2 || payload + length - 2 > stream_end_) {
+        return true;
+    }
+    uint32_t payload_length = length - 2;
+    uint32_t payload_offset = static_cast<uint32_t>(payload - GetStreamStart());
+    jpeg_stream_metadata_.app_segments.push_back({marker, payload_offset, payload_length});
+
+    switch (marker) {
+        case APP0:
+            // "JFIF\0", version (2 bytes), density unit, X density, Y density
+            if (payload_length >= 12 && std::memcmp(payload, "JFIF", 5) == 0) {
+                jpeg_stream_metadata_.jfif_density_unit = payload[7];
+                jpeg_stream_metadata_.jfif_x_density = swap_bytes(payload + 8);
+                jpeg_stream_metadata_.jfif_y_density = swap_bytes(payload + 10);
+            }
+            break;
+        case APP1:
+            // "Exif\0\0" followed by the TIFF header
+            if (jpeg_stream_metadata_.exif_orientation == 0 && payload_length >= 14 && std::memcmp(payload, "Exif\0", 6) == 0) {
+                ParseExif(payload + 6, payload_length - 6);
+            }
+            break;
+        case APP2:
+            // "ICC_PROFILE\0", sequence number (1-based), number of chunks, profile data
+            if (payload_length > 14 && std::memcmp(payload, "ICC_PROFILE", 12) == 0) {
+                uint8_t sequence_number = payload[12];
+                uint8_t num_chunks = payload[13];
+                if (sequence_number >= 1 && sequence_number <= num_chunks) {
+                    if (jpeg_stream_metadata_.icc_profile_chunks.size() < num_chunks) {
+                        jpeg_stream_metadata_.icc_profile_chunks.resize(num_chunks, {0, 0, 0});
+                    }
+                    jpeg_stream_metadata_.icc_profile_chunks[sequence_number - 1] = {marker, payload_offset + 14, payload_length - 14};
+                }
+            }
+            break;
+        case APP14:
+            // "Adobe", version (2 bytes), flags0 (2 bytes), flags1 (2 bytes), transform
+            if (payload_length >= 12 && std::memcmp(payload, "Adobe", 5) == 0) {
+                jpeg_stream_metadata_.adobe_transform = payload[11];
+            }
+            break;
+        default:
+            break;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Parses the EXIF data of an APP1 segment.
+ *
+ * This function reads the orientation tag (0x0112) of the 0th IFD and follows the link to the 1st IFD, which
+ * describes the thumbnail image. A JPEG thumbnail is located by its JPEGInterchangeFormat (0x0201) and
+ * JPEGInterchangeFormatLength (0x0202) tags; it is only recorded if it lies within the EXIF data and starts
+ * with an SOI marker.
+ *
+ * @param tiff_header The pointer to the TIFF header of the EXIF data.
+ * @param tiff_size The size of the EXIF data from the TIFF header.
+ */
+void RocJpegStreamParser::ParseExif(const uint8_t *tiff_header, uint32_t tiff_size) {
+    if (tiff_size < 8) {
+        return;
+    }
+    bool is_little_endian;
+    if (tiff_header[0] == 'I' && tiff_header[1] == 'I') {
+        is_little_endian = true;
+    } else if (tiff_header[0] == 'M' && tiff_header[1] == 'M') {
+        is_little_endian = false;
+    } else {
+        return;
+    }
+    auto read_u16 = [is_little_endian](const uint8_t *p) -> uint16_t {
+        return is_little_endian ? (p[0] | (p[1] << 8)) : ((p[0] << 8) | p[1]);
+    };
+    auto read_u32 = [is_little_endian](const uint8_t *p) -> uint32_t {
+        return is_little_endian ? (p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24)) :
+                                  ((static_cast<uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3]);
+    };
+    if (read_u16(tiff_header + 2) != 42) {
+        return;
+    }
+    uint64_t ifd_offset = read_u32(tiff_header + 4);
+    if (ifd_offset < 8 || ifd_offset + 2 > tiff_size) {
+        return;
+    }
+    uint32_t num_entries = read_u16(tiff_header + ifd_offset);
+    for (uint32_t i = 0; i < num_entries; i++) {
+        uint64_t entry_offset = ifd_offset + 2 + i * 12;
+        if (entry_offset + 12 > tiff_size) {
+            break;
+        }
+        const uint8_t *entry = tiff_header + entry_offset;
+        // The orientation is a single SHORT (type 3) stored in the value field of the entry
+        if (read_u16(entry) == 0x0112) {
+            uint16_t orientation = read_u16(entry + 8);
+            if (read_u16(entry + 2) == 3 && orientation >= 1 && orientation <= 8) {
+                jpeg_stream_metadata_.exif_orientation = orientation;
+            }
+        }
+    }
 
+    // The offset of the 1st IFD follows the entries of the 0th IFD
+    uint64_t next_ifd_link = ifd_offset + 2 + static_cast<uint64_t>(num_entries) * 12;
+    if (next_ifd_link + 4 > tiff_size) {
+        return;
+    }
+    ifd_offset = read_u32(tiff_header + next_ifd_link);
+    if (ifd_offset < 8 || ifd_offset + 2 > tiff_size) {
+        return;
+    }
+    num_entries = read_u16(tiff_header + ifd_offset);
+    uint64_t thumbnail_offset = 0;
+    uint64_t thumbnail_length = 0;
+    for (uint32_t i = 0; i < num_entries; i++) {
+        uint64_t entry_offset = ifd_offset + 2 + i * 12;
+        if (entry_offset + 12 > tiff_size) {
+            break;
+        }
+        const uint8_t *entry = tiff_header + entry_offset;
+        // Both tags are a single LONG (type 4) stored in the value field of the entry
+        uint16_t tag = read_u16(entry);
+        if (read_u16(entry + 2) != 4) {
+            continue;
+        }
+        if (tag == 0x0201) {
+            thumbnail_offset = read_u32(entry + 8);
+        } else if (tag == 0x0202) {
+            thumbnail_length = read_u32(entry + 8);
+        }
+    }
+    if (thumbnail_offset < 8 || thumbnail_length < 4 || thumbnail_offset + thumbnail_length > tiff_size) {
+        return;
+    }
+    const uint8_t *thumbnail = tiff_header + thumbnail_offset;
+    if (thumbnail[0] != 0xFF || thumbnail[1] != SOI) {
+        return;
+    }
+    jpeg_stream_metadata_.exif_thumbnail_offset = static_cast<uint32_t>(thumbnail - GetStreamStart());
+    jpeg_stream_metadata_.exif_thumbnail_length = static_cast<uint32_t>(thumbnail_length);
+}
+
+/**
+ * @brief Retrieves the ICC profile of the JPEG stream.
+ *
+ * A profile stored in a single APP2 segment is returned in place. A profile that is split over several APP2
+ * segments has been assembled into a buffer owned by the parser by AssembleIccProfile when the SOS marker was
+ * parsed, so this call does not copy it.
+ *
+ * @param icc_profile Receives a pointer to the ICC profile, or nullptr if the stream has no ICC profile.
+ * @param icc_profile_size Receives the size of the ICC profile.
+ * @return true if the ICC profile is retrieved successfully, false if a chunk of the ICC profile is missing.
+ */
+bool RocJpegStreamParser::GetIccProfile(const uint8_t **icc_profile, size_t *icc_profile_size) const {
+    *icc_profile = nullptr;
+    *icc_profile_size = 0;
+    const std::vector<JpegAppSegment> &icc_profile_chunks = jpeg_stream_metadata_.icc_profile_chunks;
+    if (icc_profile_chunks.empty()) {
+        return true;
+    }
+    for (const auto &chunk : icc_profile_chunks) {
+        if (chunk.marker != APP2) {
+            ERR("missing ICC profile chunk!");
+            return false;
+        }
+    }
+
+    const uint8_t *stream_start = GetStreamStart();
+    if (icc_profile_chunks.size() == 1) {
+        *icc_profile = stream_start + icc_profile_chunks[0].offset;
+        *icc_profile_size = icc_profile_chunks[0].length;
+        return true;
+    }
+    *icc_profile = icc_profile_buffer_.data();
+    *icc_profile_size = icc_profile_buffer_.size();
     return true;
 }
 
+/**
+ * @brief Retrieves the estimated IJG quality factor of the quantization table of the first component.
+ *
+ * The quality factor is estimated once per interned table set, see JpegTableCache::EstimateQualityFactor.
+ *
+ * @return The quality factor (1 to 100), or 0 if the stream has not been parsed up to the scan header.
+ */
+uint32_t RocJpegStreamParser::GetQualityFactor() const {
+    if (!sos_marker_found_ || interned_table_set_ == nullptr) {
+        return 0;
+    }
+    return interned_table_set_->quality_factors[jpeg_stream_parameters_.picture_parameters.components[0].quantiser_table_selector & (NUM_COMPONENTS - 1)];
+}
+
+/**
+ * @brief Computes the seed of the content hash from the tables and the headers of the stream.
+ *
+ * The seed combines the hash of the interned tables with the dimensions, the components, and the restart interval
+ * of the stream, so that the hash of the entropy-coded data identifies the decoded image.
+ *
+ * @return The seed of the content hash.
+ */
+uint64_t RocJpegStreamParser::GetContentHashSeed() const {
+    const JpegPictureParameters &picture_params = jpeg_stream_parameters_.picture_parameters;
+    const SliceParameterBuffer &slice_params = jpeg_stream_parameters_.slice_parameter_buffer;
+    uint64_t seed = interned_table_set_ != nullptr ? interned_table_set_->hash : 0;
+    seed = XxhRound(seed, static_cast<uint64_t>(picture_params.picture_width) << 48 | static_cast<uint64_t>(picture_params.picture_height) << 32 |
+                          static_cast<uint64_t>(picture_params.num_components) << 24 | slice_params.restart_interval);
+    for (int i = 0; i < picture_params.num_components && i < NUM_COMPONENTS; i++) {
+        seed = XxhRound(seed, static_cast<uint64_t>(picture_params.components[i].component_id) << 40 |
+                              static_cast<uint64_t>(picture_params.components[i].h_sampling_factor) << 32 |
+                              static_cast<uint64_t>(picture_params.components[i].v_sampling_factor) << 24 |
+                              static_cast<uint64_t>(picture_params.components[i].quantiser_table_selector) << 16 |
+                              static_cast<uint64_t>(slice_params.components[i].dc_table_selector) << 8 |
+                              slice_params.components[i].ac_table_selector);
+    }
+    return seed;
+}
+
+/**
+ * @brief Assembles an ICC profile split over several APP2 segments into a buffer owned by the parser.
+ *
+ * Nothing is assembled if the profile is stored in a single segment, since it is then returned in place, or if a
+ * chunk is missing, which GetIccProfile reports.
+ */
+void RocJpegStreamParser::AssembleIccProfile() {
+    const std::vector<JpegAppSegment> &icc_profile_chunks = jpeg_stream_metadata_.icc_profile_chunks;
+    icc_profile_buffer_.clear();
+    if (icc_profile_chunks.size() < 2) {
+        return;
+    }
+    for (const auto &chunk : icc_profile_chunks) {
+        if (chunk.marker != APP2) {
+            return;
+        }
+    }
+    const uint8_t *stream_start = GetStreamStart();
+    for (const auto &chunk : icc_profile_chunks) {
+        icc_profile_buffer_.insert(icc_profile_buffer_.end(), stream_start + chunk.offset, stream_start + chunk.offset + chunk.length);
+    }
+}
+
+/**
+ * @brief Removes the byte stuffing and the restart markers from the entropy-coded data of a scan.
+ *
+ * The data is copied 16 bytes at a time with SSE2 until a block contains a 0xFF byte; only the 0xFF sequences are
+ * handled one byte at a time. A stuffed 0xFF00 becomes 0xFF, fill bytes are dropped, the position of each RSTn
+ * marker is recorded, and any other marker ends the scan.
+ *
+ * @param scan_data The entropy-coded data.
+ * @param scan_data_size The size of the entropy-coded data.
+ * @param entropy_data Receives the unstuffed data and the restart offsets.
+ */
+void RocJpegStreamParser::UnstuffEntropyData(const uint8_t *scan_data, size_t scan_data_size, JpegEntropyData &entropy_data) {
+    // The unstuffed data is never larger than the scan data, so the 16-byte stores below stay within the buffer.
+    // The buffer is not initialized; only the bytes written below and the padding are ever read.
+    size_t required_capacity = scan_data_size + ENTROPY_DATA_PADDING;
+    if (entropy_data.capacity < required_capacity) {
+        entropy_data.data.reset(new uint8_t[required_capacity]);
+        entropy_data.capacity = required_capacity;
+    }
+    entropy_data.restart_offsets.clear();
+    uint8_t *output = entropy_data.data.get();
+    uint8_t *dst = output;
+    const uint8_t *src = scan_data;
+    const uint8_t *src_end = scan_data + scan_data_size;
+
+    while (src < src_end) {
+#if defined(__SSE2__)
+        const __m128i all_ones = _mm_set1_epi8(static_cast<char>(0xFF));
+        while (src_end - src >= 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, all_ones));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), block);
+            if (mask != 0) {
+                int num_bytes = __builtin_ctz(mask);
+                dst += num_bytes;
+                src += num_bytes;
+                break;
+            }
+            dst += 16;
+            src += 16;
+        }
+        if (src == src_end) {
+            break;
+        }
+#endif
+        if (*src != 0xFF) {
+            *dst++ = *src++;
+            continue;
+        }
+        uint8_t next_byte = (src + 1 < src_end) ? src[1] : static_cast<uint8_t>(EOI);
+        if (next_byte == 0x00) {
+            *dst++ = 0xFF;
+            src += 2;
+        } else if (next_byte == 0xFF) {
+            src++;
+        } else if (next_byte >= RST0 && next_byte <= RST7) {
+            entropy_data.restart_offsets.push_back(static_cast<uint32_t>(dst - output));
+            src += 2;
+        } else {
+            break;
+        }
+    }
+
+    entropy_data.size = dst - output;
+    std::memset(dst, 0, ENTROPY_DATA_PADDING);
+}
+
+/**
+ * @brief Locates the JPEG images of a buffer that contains several images.
+ *
+ * This function searches the buffer for SOI markers and walks the marker segments of each image to find its end,
+ * so the entropy-coded data is only scanned for markers, once. If the first image of an MPO file carries an MP
+ * index, the images it describes are returned in the order of the index, and the search resumes after the last
+ * of them. Bytes that do not belong to any image, such as padding between the frames of an MJPEG dump, are skipped.
+ *
+ * @param buffer The pointer to the buffer.
+ * @param buffer_size The size of the buffer.
+ * @param image_spans Receives the locations of the images.
+ */
+void RocJpegStreamParser::SplitJpegImages(const uint8_t *buffer, size_t buffer_size, std::vector<JpegImageSpan> &image_spans) {
+    image_spans.clear();
+    if (buffer == nullptr) {
+        return;
+    }
+    size_t offset = 0;
+    while (offset + 3 <= buffer_size) {
+        // An image starts with an SOI marker immediately followed by another marker
+        const uint8_t *marker_prefix = static_cast<const uint8_t*>(std::memchr(buffer + offset, 0xFF, buffer_size - offset));
+        if (marker_prefix == nullptr) {
+            break;
+        }
+        size_t image_offset = marker_prefix - buffer;
+        if (image_offset + 3 > buffer_size) {
+            break;
+        }
+        if (buffer[image_offset + 1] != SOI || buffer[image_offset + 2] != 0xFF) {
+            offset = image_offset + 1;
+            continue;
+        }
+
+        std::vector<JpegImageSpan> mp_image_spans;
+        size_t image_end = FindJpegImageEnd(buffer, buffer_size, image_offset, mp_image_spans);
+        if (image_end == 0) {
+            offset = image_offset + 2;
+            continue;
+        }
+        if (mp_image_spans.empty()) {
+            image_spans.push_back({image_offset, image_end - image_offset, 0});
+            offset = image_end;
+            continue;
+        }
+        size_t next_offset = image_end;
+        for (const auto &mp_image_span : mp_image_spans) {
+            if (mp_image_span.offset == image_offset) {
+                // The size of the first image is taken from its markers rather than from the MP index
+                image_spans.push_back({image_offset, image_end - image_offset, mp_image_span.mp_type});
+            } else if (mp_image_span.offset + mp_image_span.length <= buffer_size && mp_image_span.length >= 4 &&
+                       buffer[mp_image_span.offset] == 0xFF && buffer[mp_image_span.offset + 1] == SOI) {
+                image_spans.push_back(mp_image_span);
+                next_offset = std::max(next_offset, mp_image_span.offset + mp_image_span.length);
+            }
+        }
+        offset = next_offset;
+    }
+}
+
+/**
+ * @brief Finds the end of a JPEG image by walking its marker segments.
+ *
+ * The marker segments are skipped using their length fields, and the entropy-coded data following each SOS
+ * marker is searched for the next marker, ignoring stuffed bytes and restart markers. An APP2 "MPF" segment is
+ * parsed on the way to collect the images described by its MP index.
+ *
+ * @param buffer The pointer to the buffer.
+ * @param buffer_size The size of the buffer.
+ * @param image_offset The offset of the SOI marker of the image.
+ * @param mp_image_spans Receives the images described by the MP index of the image, if any.
+ * @return The offset following the EOI marker of the image, buffer_size if the buffer ends before the EOI marker,
+ *         or 0 if the data following the SOI marker is not a sequence of marker segments.
+ */
+size_t RocJpegStreamParser::FindJpegImageEnd(const uint8_t *buffer, size_t buffer_size, size_t image_offset, std::vector<JpegImageSpan> &mp_image_spans) {
+    size_t offset = image_offset + 2;
+    bool in_scan = false;
+    while (offset < buffer_size) {
+        if (in_scan) {
+            const uint8_t *marker_prefix = static_cast<const uint8_t*>(std::memchr(buffer + offset, 0xFF, buffer_size - offset));
+            if (marker_prefix == nullptr || marker_prefix + 1 >= buffer + buffer_size) {
+                break;
+            }
+            offset = marker_prefix - buffer;
+            uint8_t next_byte = buffer[offset + 1];
+            if (next_byte == 0x00 || (next_byte >= 0xD0 && next_byte <= 0xD7)) {
+                offset += 2;
+                continue;
+            }
+            if (next_byte == 0xFF) {
+                offset++;
+                continue;
+            }
+            in_scan = false;
+        }
+
+        if (buffer[offset] != 0xFF) {
+            return 0;
+        }
+        while (offset < buffer_size && buffer[offset] == 0xFF) {
+            offset++;
+        }
+        if (offset >= buffer_size) {
+            break;
+        }
+        uint8_t marker = buffer[offset++];
+        if (marker == EOI) {
+            return offset;
+        }
+        if (marker == SOI) {
+            return 0;
+        }
+        // Standalone markers without a length field
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+            continue;
+        }
+        if (offset + 2 > buffer_size) {
+            break;
+        }
+        size_t segment_length = swap_bytes(buffer + offset);
+        if (segment_length < 2) {
+            return 0;
+        }
+        // "MPF\0" followed by the MP header
+        if (marker == APP2 && segment_length >= 14 && offset + segment_length <= buffer_size && std::memcmp(buffer + offset + 2, "MPF", 4) == 0) {
+            ParseMpfIndex(buffer, buffer_size, image_offset, offset + 6, segment_length - 6, mp_image_spans);
+        }
+        offset += segment_length;
+        if (marker == SOS) {
+            in_scan = true;
+        }
+    }
+    return buffer_size;
+}
+
+/**
+ * @brief Parses the MP index IFD of an APP2 "MPF" segment (see CIPA DC-007).
+ *
+ * The MP header has the layout of a TIFF header. The MP index IFD gives the number of images (tag 0xB001) and
+ * the location of the MP entries (tag 0xB002). Each 16-byte MP entry holds the attribute of an image, its size,
+ * and its offset from the MP header; the first image, which contains the MP index, has an offset of 0.
+ *
+ * @param buffer The pointer to the buffer.
+ * @param buffer_size The size of the buffer.
+ * @param image_offset The offset of the SOI marker of the image containing the segment.
+ * @param mp_header_offset The offset of the MP header of the segment.
+ * @param mp_header_size The size of the segment from the MP header.
+ * @param mp_image_spans Receives the images described by the MP index.
+ */
+void RocJpegStreamParser::ParseMpfIndex(const uint8_t *buffer, size_t buffer_size, size_t image_offset, size_t mp_header_offset, size_t mp_header_size,
+                                        std::vector<JpegImageSpan> &mp_image_spans) {
+    const uint8_t *mp_header = buffer + mp_header_offset;
+    if (mp_header_size < 8 || mp_header_offset + mp_header_size > buffer_size) {
+        return;
+    }
+    bool is_little_endian;
+    if (mp_header[0] == 'I' && mp_header[1] == 'I') {
+        is_little_endian = true;
+    } else if (mp_header[0] == 'M' && mp_header[1] == 'M') {
+        is_little_endian = false;
+    } else {
+        return;
+    }
+    auto read_u16 = [is_little_endian](const uint8_t *p) -> uint16_t {
+        return is_little_endian ? (p[0] | (p[1] << 8)) : ((p[0] << 8) | p[1]);
+    };
+    auto read_u32 = [is_little_endian](const uint8_t *p) -> uint32_t {
+        return is_little_endian ? (p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24)) :
+                                  ((static_cast<uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3]);
+    };
+    if (read_u16(mp_header + 2) != 42) {
+        return;
+    }
+    uint64_t ifd_offset = read_u32(mp_header + 4);
+    if (ifd_offset < 8 || ifd_offset + 2 > mp_header_size) {
+        return;
+    }
+    uint32_t num_entries = read_u16(mp_header + ifd_offset);
+    uint32_t num_images = 0;
+    uint64_t mp_entries_offset = 0;
+    for (uint32_t i = 0; i < num_entries; i++) {
+        uint64_t entry_offset = ifd_offset + 2 + i * 12;
+        if (entry_offset + 12 > mp_header_size) {
+            break;
+        }
+        const uint8_t *entry = mp_header + entry_offset;
+        uint16_t tag = read_u16(entry);
+        if (tag == 0xB001) {
+            num_images = read_u32(entry + 8);
+        } else if (tag == 0xB002) {
+            mp_entries_offset = read_u32(entry + 8);
+        }
+    }
+    if (num_images == 0 || mp_entries_offset < 8 || mp_entries_offset + static_cast<uint64_t>(num_images) * 16 > mp_header_size) {
+        return;
+    }
+    for (uint32_t i = 0; i < num_images; i++) {
+        const uint8_t *mp_entry = mp_header + mp_entries_offset + i * 16;
+        uint32_t attribute = read_u32(mp_entry);
+        uint32_t size = read_u32(mp_entry + 4);
+        uint32_t data_offset = read_u32(mp_entry + 8);
+        size_t offset = data_offset == 0 ? image_offset : mp_header_offset + data_offset;
+        mp_image_spans.push_back({offset, size, attribute & 0x00FFFFFF});
+    }
+}
+
+/**
+ * @brief Discards the stream parsed last.
+ *
+ * The parse state is reset as for a new stream, which clears the stream parameters, including the pointer to the
+ * entropy-coded data, and the metadata, and the parser no longer references the buffer of the stream.
+ */
+void RocJpegStreamParser::Reset() {
+    ResetParseState();
+    stream_start_ = nullptr;
+    stream_ = nullptr;
+    stream_end_ = nullptr;
+}
+
+/**
+ * @brief Resets the parser to the start of a new stream.
+ *
+ * This function clears the parsed stream parameters and any chunks buffered by a previous incremental parse.
+ * The capacity of the buffers and the interned tables of the previous stream are kept so that parsing the next
+ * stream does not allocate memory.
+ */
+void RocJpegStreamParser::ResetParseState() {
+    jpeg_stream_parameters_ = {};
+    std::memset(&table_set_, 0, sizeof(table_set_));
+    jpeg_stream_metadata_.exif_orientation = 0;
+    jpeg_stream_metadata_.jfif_density_unit = 0;
+    jpeg_stream_metadata_.jfif_x_density = 0;
+    jpeg_stream_metadata_.jfif_y_density = 0;
+    jpeg_stream_metadata_.adobe_transform = -1;
+    jpeg_stream_metadata_.exif_thumbnail_offset = 0;
+    jpeg_stream_metadata_.exif_thumbnail_length = 0;
+    jpeg_stream_metadata_.app_segments.clear();
+    jpeg_stream_metadata_.icc_profile_chunks.clear();
+    icc_profile_buffer_.clear();
+    content_hash_ = 0;
+    sof_marker_found_ = false;
+    dht_marker_found_ = false;
+    dqt_marker_found_ = false;
+    sos_marker_found_ = false;
+    chunk_buffer_.clear();
+    scan_data_segments_.clear();
+    chunk_parse_offset_ = 0;
+    chunk_scan_data_offset_ = 0;
+    chunk_eoi_search_offset_ = 0;
+    chunk_parse_state_ = CHUNK_PARSE_NEED_MORE_DATA;
+}
+
 /**
  * @brief Parses the Start of Image (SOI) marker in the JPEG stream.
  *
@@ -165,44 +1258,44 @@ bool RocJpegStreamParser::ParseSOF() {
         return false;
     }
 
-    jpeg_stream_parameters_.picture_parameter_buffer.picture_height = swap_bytes(stream_ + 3);
-    jpeg_stream_parameters_.picture_parameter_buffer.picture_width = swap_bytes(stream_ + 5);
-    jpeg_stream_parameters_.picture_parameter_buffer.num_components = stream_[7];
+    jpeg_stream_parameters_.picture_parameters.picture_height = swap_bytes(stream_ + 3);
+    jpeg_stream_parameters_.picture_parameters.picture_width = swap_bytes(stream_ + 5);
+    jpeg_stream_parameters_.picture_parameters.num_components = stream_[7];
 
-    if (jpeg_stream_parameters_.picture_parameter_buffer.num_components > NUM_COMPONENTS - 1) {
+    if (jpeg_stream_parameters_.picture_parameters.num_components > NUM_COMPONENTS - 1) {
         ERR("invalid number of JPEG components!");
         return false;
     }
 
     stream_ += 8;
 
-    for (int32_t i = 0; i < jpeg_stream_parameters_.picture_parameter_buffer.num_components; i++) {
+    for (int32_t i = 0; i < jpeg_stream_parameters_.picture_parameters.num_components; i++) {
         component_id = *stream_++;
         sampling_factor = *stream_++;
         quantiser_table_selector = *stream_++;
 
-        jpeg_stream_parameters_.picture_parameter_buffer.components[i].component_id = component_id;
+        jpeg_stream_parameters_.picture_parameters.components[i].component_id = component_id;
         if (quantiser_table_selector >= NUM_COMPONENTS) {
             ERR("invalid number of the quantization table!");
             return false;
         }
-        jpeg_stream_parameters_.picture_parameter_buffer.components[i].v_sampling_factor = sampling_factor & 0xF;
-        jpeg_stream_parameters_.picture_parameter_buffer.components[i].h_sampling_factor = sampling_factor >> 4;
-        jpeg_stream_parameters_.picture_parameter_buffer.components[i].quantiser_table_selector = quantiser_table_selector;
+        jpeg_stream_parameters_.picture_parameters.components[i].v_sampling_factor = sampling_factor & 0xF;
+        jpeg_stream_parameters_.picture_parameters.components[i].h_sampling_factor = sampling_factor >> 4;
+        jpeg_stream_parameters_.picture_parameters.components[i].quantiser_table_selector = quantiser_table_selector;
     }
 
-    uint8_t max_h_factor = jpeg_stream_parameters_.picture_parameter_buffer.components[0].h_sampling_factor;
-    uint8_t max_v_factor = jpeg_stream_parameters_.picture_parameter_buffer.components[0].v_sampling_factor;
+    uint8_t max_h_factor = jpeg_stream_parameters_.picture_parameters.components[0].h_sampling_factor;
+    uint8_t max_v_factor = jpeg_stream_parameters_.picture_parameters.components[0].v_sampling_factor;
 
-    jpeg_stream_parameters_.slice_parameter_buffer.num_mcus = ((jpeg_stream_parameters_.picture_parameter_buffer.picture_width + max_h_factor * 8 - 1) / (max_h_factor * 8)) *
-                                       ((jpeg_stream_parameters_.picture_parameter_buffer.picture_height + max_v_factor * 8 - 1) / (max_v_factor * 8));
+    jpeg_stream_parameters_.slice_parameter_buffer.num_mcus = ((jpeg_stream_parameters_.picture_parameters.picture_width + max_h_factor * 8 - 1) / (max_h_factor * 8)) *
+                                       ((jpeg_stream_parameters_.picture_parameters.picture_height + max_v_factor * 8 - 1) / (max_v_factor * 8));
 
-    jpeg_stream_parameters_.chroma_subsampling = GetChromaSubsampling(jpeg_stream_parameters_.picture_parameter_buffer.components[0].h_sampling_factor,
-                                                                      jpeg_stream_parameters_.picture_parameter_buffer.components[1].h_sampling_factor,
-                                                                      jpeg_stream_parameters_.picture_parameter_buffer.components[2].h_sampling_factor,
-                                                                      jpeg_stream_parameters_.picture_parameter_buffer.components[0].v_sampling_factor,
-                                                                      jpeg_stream_parameters_.picture_parameter_buffer.components[1].v_sampling_factor,
-                                                                      jpeg_stream_parameters_.picture_parameter_buffer.components[2].v_sampling_factor);
+    jpeg_stream_parameters_.chroma_subsampling = GetChromaSubsampling(jpeg_stream_parameters_.picture_parameters.components[0].h_sampling_factor,
+                                                                      jpeg_stream_parameters_.picture_parameters.components[1].h_sampling_factor,
+                                                                      jpeg_stream_parameters_.picture_parameters.components[2].h_sampling_factor,
+                                                                      jpeg_stream_parameters_.picture_parameters.components[0].v_sampling_factor,
+                                                                      jpeg_stream_parameters_.picture_parameters.components[1].v_sampling_factor,
+                                                                      jpeg_stream_parameters_.picture_parameters.components[2].v_sampling_factor);
     return true;
 }
 
@@ -210,7 +1303,7 @@ bool RocJpegStreamParser::ParseSOF() {
  * @brief Parses the DQT (Define Quantization Table) segment of a JPEG stream.
  *
  * This function reads the quantization tables from the JPEG stream and stores them in the
- * `jpeg_stream_parameters_.quantization_matrix_buffer` data structure.
+ * `table_set_.quantization_matrix_buffer` data structure.
  *
  * @return `true` if the DQT segment is successfully parsed, `false` otherwise.
  */
@@ -236,8 +1329,8 @@ bool RocJpegStreamParser::ParseDQT() {
             return false;
         }
 
-        std::memcpy(jpeg_stream_parameters_.quantization_matrix_buffer.quantiser_table[quantization_table_index & 0x0F], stream_, 64);
-        jpeg_stream_parameters_.quantization_matrix_buffer.load_quantiser_table[quantization_table_index & 0x0F] = 1;
+        std::memcpy(table_set_.quantization_matrix_buffer.quantiser_table[quantization_table_index & 0x0F], stream_, 64);
+        table_set_.quantization_matrix_buffer.load_quantiser_table[quantization_table_index & 0x0F] = 1;
 
         stream_ += 64;
     }
@@ -249,7 +1342,7 @@ bool RocJpegStreamParser::ParseDQT() {
  * @brief Parses the Define Huffman Table (DHT) segment in the JPEG stream.
  *
  * This function reads and processes the DHT segment in the JPEG stream. It extracts the Huffman table
- * information and stores it in the `jpeg_stream_parameters_.huffman_table_buffer` data structure.
+ * information and stores it in the `table_set_.huffman_table_buffer` data structure.
  *
  * @return `true` if the DHT segment is successfully parsed, `false` otherwise.
  */
@@ -277,9 +1370,9 @@ bool RocJpegStreamParser::ParseDHT() {
         }
 
         if (ac_huffman_table) {
-            std::memcpy(jpeg_stream_parameters_.huffman_table_buffer.huffman_table[huffman_table_id].num_ac_codes, stream_, 16);
+            std::memcpy(table_set_.huffman_table_buffer.huffman_table[huffman_table_id].num_ac_codes, stream_, 16);
         } else {
-            std::memcpy(jpeg_stream_parameters_.huffman_table_buffer.huffman_table[huffman_table_id].num_dc_codes, stream_, 16);
+            std::memcpy(table_set_.huffman_table_buffer.huffman_table[huffman_table_id].num_dc_codes, stream_, 16);
         }
 
         count = 0;
@@ -292,15 +1385,15 @@ bool RocJpegStreamParser::ParseDHT() {
                 ERR("invalid AC Huffman table!");
                 return false;
             }
-            std::memcpy(jpeg_stream_parameters_.huffman_table_buffer.huffman_table[huffman_table_id].ac_values, stream_, count);
-            jpeg_stream_parameters_.huffman_table_buffer.load_huffman_table[huffman_table_id] = 1;
+            std::memcpy(table_set_.huffman_table_buffer.huffman_table[huffman_table_id].ac_values, stream_, count);
+            table_set_.huffman_table_buffer.load_huffman_table[huffman_table_id] = 1;
         } else {
             if (count > DC_HUFFMAN_TABLE_VALUES_SIZE) {
                 ERR("invlaid DC Huffman table!")
                 return false;
             }
-            std::memcpy(jpeg_stream_parameters_.huffman_table_buffer.huffman_table[huffman_table_id].dc_values, stream_, count);
-            jpeg_stream_parameters_.huffman_table_buffer.load_huffman_table[huffman_table_id] = 1;
+            std::memcpy(table_set_.huffman_table_buffer.huffman_table[huffman_table_id].dc_values, stream_, count);
+            table_set_.huffman_table_buffer.load_huffman_table[huffman_table_id] = 1;
         }
 
         length -= 1;
@@ -352,7 +1445,7 @@ bool RocJpegStreamParser::ParseSOS() {
             ERR("invalid number of DC Huffman table!");
             return false;
         }
-        if (component_id != jpeg_stream_parameters_.picture_parameter_buffer.components[i].component_id) {
+        if (component_id != jpeg_stream_parameters_.picture_parameters.components[i].component_id) {
             ERR("component id mismatch between SOS and SOF marker!");
             return false;
         }
@@ -403,13 +1496,11 @@ bool RocJpegStreamParser::ParseEOI() {
         return false;
     }
 
-    const uint8_t *stream_temp = stream_;
-    while (stream_temp <= stream_end_ && !(*stream_temp == 0xFF  && *(stream_temp + 1) == EOI)) {
-        stream_temp++;
-        continue;
-    }
-
-    jpeg_stream_parameters_.slice_parameter_buffer.slice_data_size = stream_temp - stream_;
+    JpegContentHashState hash_state;
+    XxhReset(hash_state, GetContentHashSeed());
+    const uint8_t *eoi = FindEoiAndHashScanData(stream_, stream_end_, hash_state);
+    content_hash_ = XxhDigest(hash_state);
+    jpeg_stream_parameters_.slice_parameter_buffer.slice_data_size = eoi - stream_;
     jpeg_stream_parameters_.slice_data_buffer = stream_;
 
     return true;
@@ -468,3 +1559,178 @@ ChromaSubsampling RocJpegStreamParser::GetChromaSubsampling(uint8_t c1_h_samplin
 
     return subsampling;
 }
+
+JpegTableCache::JpegTableCache() : sweep_threshold_{64} {
+}
+
+JpegTableCache& JpegTableCache::GetInstance() {
+    static JpegTableCache table_cache;
+    return table_cache;
+}
+
+/**
+ * @brief Returns the shared copy of a table set.
+ *
+ * This function looks up the table set by its hash and returns the cached copy if an identical table set is
+ * still in use by another stream. Otherwise it makes an immutable copy of the table set, expands its Huffman
+ * tables into lookup tables, and caches a weak reference to it. The entries of the table sets that are no longer
+ * in use are swept whenever the number of entries doubles, so the cache stays proportional to the number of
+ * distinct table sets in use.
+ *
+ * @param table_set The table set to intern.
+ * @return A shared pointer to the interned table set.
+ */
+std::shared_ptr<const JpegInternedTableSet> JpegTableCache::Intern(const JpegTableSet &table_set) {
+    uint64_t hash = Hash(table_set);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto range = table_sets_.equal_range(hash);
+    for (auto it = range.first; it != range.second;) {
+        std::shared_ptr<const JpegInternedTableSet> cached_table_set = it->second.lock();
+        if (cached_table_set == nullptr) {
+            it = table_sets_.erase(it);
+            continue;
+        }
+        if (IsEqual(cached_table_set->table_set, table_set)) {
+            return cached_table_set;
+        }
+        ++it;
+    }
+
+    std::shared_ptr<JpegInternedTableSet> interned_table_set = std::make_shared<JpegInternedTableSet>();
+    interned_table_set->table_set = table_set;
+    interned_table_set->hash = hash;
+    const HuffmanTableBuffer &huffman_tables = table_set.huffman_table_buffer;
+    JpegHuffmanLookupTables &huffman_lookup_tables = interned_table_set->huffman_lookup_tables;
+    for (int i = 0; i < HUFFMAN_TABLES; i++) {
+        huffman_lookup_tables.is_valid[i] = huffman_tables.load_huffman_table[i] &&
+            BuildHuffmanLookupTable(huffman_tables.huffman_table[i].num_dc_codes, huffman_tables.huffman_table[i].dc_values, DC_HUFFMAN_TABLE_VALUES_SIZE, huffman_lookup_tables.dc_tables[i]) &&
+            BuildHuffmanLookupTable(huffman_tables.huffman_table[i].num_ac_codes, huffman_tables.huffman_table[i].ac_values, AC_HUFFMAN_TABLE_VALUES_SIZE, huffman_lookup_tables.ac_tables[i]);
+    }
+    const QuantizationMatrixBuffer &quantization_tables = table_set.quantization_matrix_buffer;
+    for (int i = 0; i < NUM_COMPONENTS; i++) {
+        // By convention, table 0 holds the luminance table and the other tables the chrominance tables.
+        interned_table_set->quality_factors[i] = quantization_tables.load_quantiser_table[i] ? EstimateQualityFactor(quantization_tables.quantiser_table[i], i != 0) : 0;
+    }
+    table_sets_.emplace(hash, interned_table_set);
+    if (table_sets_.size() > sweep_threshold_) {
+        for (auto it = table_sets_.begin(); it != table_sets_.end();) {
+            it = it->second.expired() ? table_sets_.erase(it) : std::next(it);
+        }
+        sweep_threshold_ = std::max<size_t>(64, 2 * table_sets_.size());
+    }
+    return interned_table_set;
+}
+
+/**
+ * @brief Estimates the IJG quality factor that produces a quantization table.
+ *
+ * The IJG library scales the tables of Annex K by 5000 / quality percent below quality 50 and by 200 - 2 * quality
+ * percent above, rounds, and clamps the result to 1..255. Each quality factor is tried, and the one whose scaled
+ * table has the smallest sum of absolute differences with the quantization table is returned. The estimate is exact
+ * for the tables written by the IJG library and its derivatives, and a close equivalent for the others. It is
+ * computed once per interned table set, so it does not add to the cost of parsing a stream.
+ *
+ * @param quantiser_table The quantization table, in zigzag order.
+ * @param is_chroma True to compare with the chrominance table of Annex K, false for the luminance table.
+ * @return The estimated quality factor, from 1 to 100.
+ */
+uint8_t JpegTableCache::EstimateQualityFactor(const uint8_t *quantiser_table, bool is_chroma) {
+    const uint8_t *std_table = is_chroma ? kStdChrominanceQuantTable : kStdLuminanceQuantTable;
+    uint32_t best_quality = 1;
+    uint32_t best_distance = UINT32_MAX;
+    for (uint32_t quality = 1; quality <= 100; quality++) {
+        uint32_t scale = quality < 50 ? 5000 / quality : 200 - 2 * quality;
+        uint32_t distance = 0;
+        for (int i = 0; i < 64; i++) {
+            int32_t value = std::min<int32_t>(std::max<int32_t>((std_table[i] * scale + 50) / 100, 1), 255);
+            distance += std::abs(value - quantiser_table[i]);
+        }
+        if (distance < best_distance) {
+            best_distance = distance;
+            best_quality = quality;
+        }
+    }
+    return static_cast<uint8_t>(best_quality);
+}
+
+/**
+ * @brief Computes the 64-bit FNV-1a hash of the tables of a table set.
+ *
+ * Only the load flags and the tables are hashed; the reserved fields and the padding are ignored.
+ *
+ * @param table_set The table set.
+ * @return The hash of the table set.
+ */
+uint64_t JpegTableCache::Hash(const JpegTableSet &table_set) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    auto hash_bytes = [&hash](const void *data, size_t size) {
+        const uint8_t *bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+        }
+    };
+    hash_bytes(table_set.quantization_matrix_buffer.load_quantiser_table, sizeof(table_set.quantization_matrix_buffer.load_quantiser_table));
+    hash_bytes(table_set.quantization_matrix_buffer.quantiser_table, sizeof(table_set.quantization_matrix_buffer.quantiser_table));
+    hash_bytes(table_set.huffman_table_buffer.load_huffman_table, sizeof(table_set.huffman_table_buffer.load_huffman_table));
+    hash_bytes(table_set.huffman_table_buffer.huffman_table, sizeof(table_set.huffman_table_buffer.huffman_table));
+    return hash;
+}
+
+/**
+ * @brief Compares the load flags and the tables of two table sets.
+ *
+ * @param a The first table set.
+ * @param b The second table set.
+ * @return true if both table sets contain the same tables, false otherwise.
+ */
+bool JpegTableCache::IsEqual(const JpegTableSet &a, const JpegTableSet &b) {
+    return std::memcmp(a.quantization_matrix_buffer.load_quantiser_table, b.quantization_matrix_buffer.load_quantiser_table, sizeof(a.quantization_matrix_buffer.load_quantiser_table)) == 0 &&
+           std::memcmp(a.quantization_matrix_buffer.quantiser_table, b.quantization_matrix_buffer.quantiser_table, sizeof(a.quantization_matrix_buffer.quantiser_table)) == 0 &&
+           std::memcmp(a.huffman_table_buffer.load_huffman_table, b.huffman_table_buffer.load_huffman_table, sizeof(a.huffman_table_buffer.load_huffman_table)) == 0 &&
+           std::memcmp(a.huffman_table_buffer.huffman_table, b.huffman_table_buffer.huffman_table, sizeof(a.huffman_table_buffer.huffman_table)) == 0;
+}
+
+/**
+ * @brief Expands a Huffman table into a lookup table.
+ *
+ * This function generates the codes of the table in canonical order (see Annex C of ITU-T T.81). Each code of up
+ * to HUFFMAN_LOOKUP_BITS bits fills all the entries of the fast lookup table that start with it, and the largest
+ * code and the value offset of each code length are recorded for the longer codes.
+ *
+ * @param num_codes The number of codes of each code length (1 to 16).
+ * @param values The symbol values sorted by code.
+ * @param max_num_values The number of elements of the values array.
+ * @param lookup_table The lookup table to build.
+ * @return true if the table forms a valid prefix code, false otherwise.
+ */
+bool JpegTableCache::BuildHuffmanLookupTable(const uint8_t *num_codes, const uint8_t *values, uint32_t max_num_values, JpegHuffmanLookupTable &lookup_table) {
+    std::memset(&lookup_table, 0, sizeof(lookup_table));
+    int32_t code = 0;
+    uint32_t num_values = 0;
+    for (int length = 1; length <= 16; length++) {
+        uint32_t count = num_codes[length - 1];
+        // The codes of a given length must fit in that length
+        if (num_values + count > max_num_values || code + count > (1u << length)) {
+            return false;
+        }
+        lookup_table.value_offset[length] = static_cast<int32_t>(num_values) - code;
+        if (length <= HUFFMAN_LOOKUP_BITS) {
+            uint32_t shift = HUFFMAN_LOOKUP_BITS - length;
+            for (uint32_t i = 0; i < count; i++) {
+                uint16_t entry = static_cast<uint16_t>((length << 8) | values[num_values + i]);
+                uint32_t first_index = static_cast<uint32_t>(code + i) << shift;
+                for (uint32_t j = 0; j < (1u << shift); j++) {
+                    lookup_table.fast_lookup[first_index + j] = entry;
+                }
+            }
+        }
+        code += count;
+        num_values += count;
+        lookup_table.max_code[length] = count ? code - 1 : -1;
+        code <<= 1;
+    }
+    // Sentinel that terminates the code length search
+    lookup_table.max_code[17] = INT32_MAX;
+    std::memcpy(lookup_table.values, values, num_values);
+    return true;
+}
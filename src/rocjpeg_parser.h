@@ -25,9 +25,14 @@ THE SOFTWARE.
 #define ROC_JPEG_PARSER_H_
 
 #include <stdint.h>
+#include <sys/uio.h>
+#include <algorithm>
 #include <iostream>
 #include <cstring>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 #include "rocjpeg_commons.h"
 
 #pragma once
@@ -36,6 +41,8 @@ THE SOFTWARE.
 #define HUFFMAN_TABLES 2
 #define AC_HUFFMAN_TABLE_VALUES_SIZE 162
 #define DC_HUFFMAN_TABLE_VALUES_SIZE 12
+#define HUFFMAN_LOOKUP_BITS 9
+#define ENTROPY_DATA_PADDING 16
 #define swap_bytes(x) (((x)[0] << 8) | (x)[1])
 
 /**
@@ -51,6 +58,12 @@ enum JpegMarkers {
     DRI = 0xDD, /**< Define Restart Interval */
     SOS = 0xDA, /**< Start of Scan */
     EOI = 0xD9, /**< End Of Image */
+    RST0 = 0xD0, /**< First restart marker */
+    RST7 = 0xD7, /**< Last restart marker */
+    APP0 = 0xE0, /**< Application segment 0 (JFIF) */
+    APP1 = 0xE1, /**< Application segment 1 (EXIF) */
+    APP2 = 0xE2, /**< Application segment 2 (ICC profile) */
+    APP14 = 0xEE, /**< Application segment 14 (Adobe) */
 };
 
 /**
@@ -74,6 +87,25 @@ typedef struct PictureParameterBufferType {
     uint32_t reserved[7]; /**< Reserved fields. */
 } PictureParameterBuffer;
 
+/**
+ * @brief Structure representing the compact picture parameters of a parsed JPEG stream.
+ *
+ * This structure holds the fields of PictureParameterBuffer that the parser fills, with room for NUM_COMPONENTS
+ * components instead of the 255 of the VA-API structure. The VA-API picture parameter buffer is only filled from it
+ * when the stream is submitted to the hardware decoder.
+ */
+typedef struct JpegPictureParametersType {
+    uint16_t picture_width; /**< The width of the picture. */
+    uint16_t picture_height; /**< The height of the picture. */
+    struct {
+        uint8_t component_id; /**< The ID of the color component. */
+        uint8_t h_sampling_factor; /**< The horizontal sampling factor. */
+        uint8_t v_sampling_factor; /**< The vertical sampling factor. */
+        uint8_t quantiser_table_selector; /**< The quantiser table selector. */
+    } components[NUM_COMPONENTS]; /**< Array of color components. */
+    uint8_t num_components; /**< The number of color components. */
+} JpegPictureParameters;
+
 /**
  * @brief Structure representing the quantization matrix buffer.
  *
@@ -155,20 +187,217 @@ typedef enum {
     CSS_UNKNOWN = -1
 } ChromaSubsampling;
 
+/**
+ * @brief Structure representing the location of an application (APPn) segment in a JPEG stream.
+ */
+typedef struct JpegAppSegmentType {
+    uint8_t marker; /**< The APPn marker of the segment. */
+    uint32_t offset; /**< Offset of the segment payload (after the length field) from the start of the stream. */
+    uint32_t length; /**< Length of the segment payload. */
+} JpegAppSegment;
+
+/**
+ * @brief Structure representing the location of a JPEG image in a buffer that contains several images.
+ */
+typedef struct JpegImageSpanType {
+    size_t offset; /**< Offset of the SOI marker of the image from the start of the buffer. */
+    size_t length; /**< Length of the image. */
+    uint32_t mp_type; /**< MP type code of the image in the MP index, or 0 if not described by an MP index. */
+} JpegImageSpan;
+
+/**
+ * @brief Structure representing a contiguous piece of a JPEG stream that is scattered over several buffers.
+ */
+typedef struct JpegDataSegmentType {
+    const uint8_t *data; /**< The start of the segment. */
+    size_t size; /**< The size of the segment. */
+} JpegDataSegment;
+
+/**
+ * @brief Structure representing the state of the XXH64 hash of the entropy-coded data, see RocJpegStreamParser::GetContentHash.
+ *
+ * The state allows the entropy-coded data of a scattered stream to be hashed segment by segment with the same
+ * result as if it were contiguous.
+ */
+typedef struct JpegContentHashStateType {
+    uint64_t lanes[4]; /**< The accumulators of the 32-byte stripes. */
+    uint8_t buffer[32]; /**< The bytes that do not fill a stripe yet. */
+    uint32_t buffer_size; /**< The number of bytes in buffer. */
+    uint64_t total_size; /**< The number of bytes hashed. */
+    uint64_t seed; /**< The seed of the hash. */
+} JpegContentHashState;
+
+/**
+ * @brief Structure representing the entropy-coded data of a scan with the byte stuffing and the markers removed.
+ *
+ * The data is followed by ENTROPY_DATA_PADDING zero bytes, so a bit reader can load several bytes at a time past
+ * the end of the data without a bounds check. The restart markers are replaced by the offsets at which the
+ * following restart intervals start; each restart interval starts on a byte boundary.
+ */
+typedef struct JpegEntropyDataType {
+    std::unique_ptr<uint8_t[]> data; /**< The unstuffed data, followed by ENTROPY_DATA_PADDING zero bytes. */
+    size_t capacity; /**< The allocated size of data; the buffer only grows, and is not cleared when reused. */
+    size_t size; /**< The size of the unstuffed data, excluding the padding. */
+    std::vector<uint32_t> restart_offsets; /**< Offset in data of the start of each restart interval after the first. */
+} JpegEntropyData;
+
+/**
+ * @brief Structure representing the metadata found in the application segments of a JPEG stream.
+ *
+ * The metadata is collected during the marker walk; only the offsets of the segments are recorded, so no
+ * payload is copied while parsing.
+ */
+typedef struct JpegStreamMetadataType {
+    uint16_t exif_orientation; /**< EXIF orientation (1 to 8), or 0 if not present. */
+    uint8_t jfif_density_unit; /**< JFIF density unit (0: aspect ratio, 1: dots per inch, 2: dots per cm). */
+    uint16_t jfif_x_density; /**< JFIF horizontal pixel density, or 0 if not present. */
+    uint16_t jfif_y_density; /**< JFIF vertical pixel density, or 0 if not present. */
+    int16_t adobe_transform; /**< Adobe color transform (0: none, 1: YCbCr, 2: YCCK), or -1 if not present. */
+    uint32_t exif_thumbnail_offset; /**< Offset of the JPEG thumbnail of the 1st EXIF IFD from the start of the stream. */
+    uint32_t exif_thumbnail_length; /**< Length of the JPEG thumbnail of the 1st EXIF IFD, or 0 if not present. */
+    std::vector<JpegAppSegment> app_segments; /**< The APP0, APP1, APP2, and APP14 segments of the stream. */
+    std::vector<JpegAppSegment> icc_profile_chunks; /**< The ICC profile chunks, indexed by sequence number - 1. */
+} JpegStreamMetadata;
+
+/**
+ * @brief Enumeration representing the progress of an incremental (chunked) parse of a JPEG stream.
+ *
+ * The `JpegChunkParseState` enum mirrors the public `RocJpegStreamParseState` enum.
+ */
+typedef enum {
+    CHUNK_PARSE_NEED_MORE_DATA = 0, /**< No frame header has been parsed yet. */
+    CHUNK_PARSE_FRAME_HEADER_READY = 1, /**< The SOF marker has been parsed; the image dimensions are known. */
+    CHUNK_PARSE_SCAN_HEADER_READY = 2, /**< The SOS marker has been parsed; the rest of the stream is entropy-coded data. */
+    CHUNK_PARSE_COMPLETE = 3, /**< The whole stream has been parsed and is ready to be decoded. */
+} JpegChunkParseState;
+
+/**
+ * @brief Structure representing the quantization and Huffman tables of a JPEG stream.
+ */
+typedef struct JpegTableSetType {
+    QuantizationMatrixBuffer quantization_matrix_buffer; /**< The quantization tables. */
+    HuffmanTableBuffer huffman_table_buffer; /**< The Huffman tables. */
+} JpegTableSet;
+
+/**
+ * @brief Structure representing a Huffman table expanded for decoding.
+ *
+ * The codes of up to HUFFMAN_LOOKUP_BITS bits are resolved with a single lookup of the next HUFFMAN_LOOKUP_BITS
+ * bits of the stream. Longer codes are resolved by comparing the code against the largest code of each length
+ * (see Figure F.16 of ITU-T T.81). The structure contains no pointers, so it can be copied to device memory as is.
+ */
+typedef struct JpegHuffmanLookupTableType {
+    uint16_t fast_lookup[1 << HUFFMAN_LOOKUP_BITS]; /**< (code length << 8) | symbol for each prefix, or 0 if the code is longer. */
+    int32_t max_code[18]; /**< The largest code of each code length, or -1 if there is no code of that length. */
+    int32_t value_offset[17]; /**< The index in values of a code of each length, minus the code. */
+    uint8_t values[AC_HUFFMAN_TABLE_VALUES_SIZE]; /**< The symbol values sorted by code. */
+} JpegHuffmanLookupTable;
+
+/**
+ * @brief Structure representing the Huffman tables of a table set expanded for decoding.
+ */
+typedef struct JpegHuffmanLookupTablesType {
+    JpegHuffmanLookupTable dc_tables[HUFFMAN_TABLES]; /**< The DC Huffman tables. */
+    JpegHuffmanLookupTable ac_tables[HUFFMAN_TABLES]; /**< The AC Huffman tables. */
+    uint8_t is_valid[HUFFMAN_TABLES]; /**< Whether the DC and AC tables are loaded and form valid prefix codes. */
+} JpegHuffmanLookupTables;
+
+/**
+ * @brief Structure representing a table set interned in the JpegTableCache, with its derived lookup tables.
+ */
+typedef struct JpegInternedTableSetType {
+    JpegTableSet table_set; /**< The tables as defined by the DQT and DHT segments. */
+    JpegHuffmanLookupTables huffman_lookup_tables; /**< The Huffman tables expanded for decoding. */
+    uint8_t quality_factors[NUM_COMPONENTS]; /**< The estimated IJG quality factor of each quantization table, or 0 if not loaded. */
+    uint64_t hash; /**< The hash of the tables, see JpegTableCache::Hash. */
+} JpegInternedTableSet;
+
+/**
+ * @class JpegTableCache
+ * @brief A process-wide cache of the table sets of the parsed JPEG streams.
+ *
+ * Images produced by the same camera or encoder almost always carry identical DQT and DHT segments. The parser
+ * interns the table set of each stream in this cache, so that all the streams with the same tables share a single
+ * immutable copy, along with the Huffman lookup tables derived from it, which are therefore built once per
+ * distinct table set rather than once per image. The cache only holds weak references; a table set is released when the last stream using it is
+ * reparsed or destroyed, and the expired entries are swept as the cache grows.
+ */
+class JpegTableCache {
+    public:
+        /**
+         * @brief Returns the process-wide table cache.
+         * @return A reference to the table cache.
+         */
+        static JpegTableCache& GetInstance();
+
+        /**
+         * @brief Returns the shared copy of a table set, adding it to the cache if no identical table set is cached.
+         * @param table_set The table set to intern.
+         * @return A shared pointer to the immutable interned table set.
+         */
+        std::shared_ptr<const JpegInternedTableSet> Intern(const JpegTableSet &table_set);
+
+        /**
+         * @brief Compares the tables of two table sets.
+         * @param a The first table set.
+         * @param b The second table set.
+         * @return True if both table sets contain the same tables, false otherwise.
+         */
+        static bool IsEqual(const JpegTableSet &a, const JpegTableSet &b);
+
+    private:
+        JpegTableCache();
+
+        /**
+         * @brief Computes the hash of the tables loaded in a table set.
+         * @param table_set The table set.
+         * @return The 64-bit FNV-1a hash of the table set.
+         */
+        static uint64_t Hash(const JpegTableSet &table_set);
+
+        /**
+         * @brief Expands a Huffman table for decoding.
+         * @param num_codes The number of codes of each code length (1 to 16).
+         * @param values The symbol values sorted by code.
+         * @param max_num_values The number of elements of the values array.
+         * @param lookup_table The lookup table to build.
+         * @return True if the table forms a valid prefix code, false otherwise.
+         */
+        static bool BuildHuffmanLookupTable(const uint8_t *num_codes, const uint8_t *values, uint32_t max_num_values, JpegHuffmanLookupTable &lookup_table);
+
+        /**
+         * @brief Estimates the IJG quality factor that produces a quantization table.
+         * @param quantiser_table The quantization table, in zigzag order.
+         * @param is_chroma True to compare with the chrominance table of Annex K, false for the luminance table.
+         * @return The quality factor (1 to 100) whose scaled table is the closest to the quantization table.
+         */
+        static uint8_t EstimateQualityFactor(const uint8_t *quantiser_table, bool is_chroma);
+
+        std::unordered_multimap<uint64_t, std::weak_ptr<const JpegInternedTableSet>> table_sets_; ///< The interned table sets, by hash.
+        size_t sweep_threshold_; ///< Number of entries above which the expired entries are swept.
+        std::mutex mutex_; ///< Mutex for thread safety.
+};
+
 /**
  * @brief Structure representing the parameters for a JPEG stream.
  *
  * This structure contains various buffers and data required for processing a JPEG stream.
- * It includes the picture parameter buffer, quantization matrix buffer, Huffman table buffer,
- * slice parameter buffer, chroma subsampling information, and the slice data buffer.
+ * It includes the compact picture parameters, the quantization matrix and Huffman table buffers (which point to
+ * the table set interned by the parser), the slice parameter buffer, chroma subsampling information, and the
+ * slice data buffer. It is kept small so that a batch of streams can be passed around by pointer without
+ * touching more than a couple of cache lines per stream; the VA-API picture parameter buffer is filled from
+ * the picture parameters at submit time, see RocJpegVappiDecoder.
  */
 typedef struct JpegParameterBuffersType {
-    PictureParameterBuffer picture_parameter_buffer;
-    QuantizationMatrixBuffer quantization_matrix_buffer;
-    HuffmanTableBuffer huffman_table_buffer;
+    JpegPictureParameters picture_parameters; /**< The compact picture parameters. */
+    const QuantizationMatrixBuffer* quantization_matrix_buffer; /**< Interned quantization tables, see JpegTableCache. */
+    const HuffmanTableBuffer* huffman_table_buffer; /**< Interned Huffman tables, see JpegTableCache. */
+    const JpegHuffmanLookupTables* huffman_lookup_tables; /**< Interned Huffman lookup tables, see JpegTableCache. */
     SliceParameterBuffer slice_parameter_buffer;
     ChromaSubsampling chroma_subsampling;
     const uint8_t* slice_data_buffer;
+    const JpegDataSegment* slice_data_segments; /**< The segments of the slice data if it is not contiguous (see ParseJpegStreamV), or nullptr. */
+    uint32_t num_slice_data_segments; /**< The number of slice data segments. */
 } JpegStreamParameters;
 
 /**
@@ -179,6 +408,9 @@ typedef struct JpegParameterBuffersType {
  * such as Start of Image (SOI), Start of Frame (SOF), Quantization Tables (DQT), Start of Scan (SOS),
  * Huffman Tables (DHT), Define Restart Interval (DRI), and End of Image (EOI). It also provides a method to
  * retrieve the parsed JPEG stream parameters.
+ *
+ * A parser is not synchronized: like its stream handle, it must not be used by several threads at the same time.
+ * The parser keeps its buffers across streams, so that reparsing with the same handle does not allocate memory.
  */
 class RocJpegStreamParser {
     public:
@@ -192,6 +424,14 @@ class RocJpegStreamParser {
          */
         ~RocJpegStreamParser();
 
+        /**
+         * @brief Discards the stream parsed last, so that it can no longer be decoded or queried.
+         *
+         * The capacity of the buffers of the parser is kept. Called when the handle of the parser is returned to the
+         * pool of stream handles, so that the next user of the handle does not see the previous stream.
+         */
+        void Reset();
+
         /**
          * @brief Parses a JPEG stream and extracts stream parameters.
          * @param jpeg_stream The pointer to the JPEG stream.
@@ -200,13 +440,163 @@ class RocJpegStreamParser {
          */
         bool ParseJpegStream(const uint8_t* jpeg_stream, uint32_t jpeg_stream_size);
 
+        /**
+         * @brief Parses a JPEG stream that is scattered over several buffers.
+         *
+         * Only the marker segments that precede the scan are copied into a buffer owned by the parser. The
+         * entropy-coded data is referenced in place; if it spans several buffers, the slice data segments of the
+         * stream parameters list them, and they must remain valid until the stream has been decoded.
+         *
+         * @param iov The buffers of the JPEG stream, in order.
+         * @param iov_count The number of buffers.
+         * @return True if the parsing is successful, false otherwise.
+         */
+        bool ParseJpegStreamV(const struct iovec *iov, int iov_count);
+
+        /**
+         * @brief Parses the next chunk of a JPEG stream that is received in several pieces.
+         *
+         * The chunks are copied into a buffer owned by the parser, and the marker segments are parsed as soon as
+         * they are complete, so the frame header is available before the whole stream has been received.
+         * Once the state reaches CHUNK_PARSE_COMPLETE, the next call starts parsing a new stream.
+         *
+         * @param chunk The pointer to the chunk of the JPEG stream.
+         * @param chunk_size The size of the chunk.
+         * @param is_last_chunk True if this is the last chunk of the JPEG stream.
+         * @param parse_state Receives the progress of the parse after consuming the chunk.
+         * @return True if the chunk is successfully parsed, false otherwise.
+         */
+        bool ParseJpegStreamChunk(const uint8_t* chunk, uint32_t chunk_size, bool is_last_chunk, JpegChunkParseState *parse_state);
+
         /**
          * @brief Retrieves the JPEG stream parameters.
          * @return A pointer to the JpegStreamParameters object.
          */
         const JpegStreamParameters* GetJpegStreamParameters() const { return &jpeg_stream_parameters_; };
 
+        /**
+         * @brief Retrieves the metadata found in the application segments of the JPEG stream.
+         * @return A pointer to the JpegStreamMetadata object.
+         */
+        const JpegStreamMetadata* GetJpegStreamMetadata() const { return &jpeg_stream_metadata_; };
+
+        /**
+         * @brief Retrieves the content hash of the JPEG stream, computed while searching for the EOI marker.
+         *
+         * The hash covers the quantization and Huffman tables, the frame and scan headers, the restart interval, and
+         * the entropy-coded data, but not the application segments, so streams that only differ by their metadata
+         * have the same hash.
+         *
+         * @return The 64-bit content hash, or 0 if the stream has not been completely parsed.
+         */
+        uint64_t GetContentHash() const { return content_hash_; };
+
+        /**
+         * @brief Retrieves the start of the parsed JPEG stream, to which the offsets of the metadata are relative.
+         * @return A pointer to the first byte of the JPEG stream.
+         */
+        const uint8_t* GetStreamStart() const { return chunk_buffer_.empty() ? stream_start_ : chunk_buffer_.data(); };
+
+        /**
+         * @brief Retrieves the ICC profile of the JPEG stream.
+         *
+         * If the profile is stored in a single APP2 segment, the returned pointer points into the JPEG stream.
+         * Otherwise the chunks have been assembled into a buffer owned by the parser when the scan header was parsed.
+         *
+         * @param icc_profile Receives a pointer to the ICC profile, or nullptr if the stream has no ICC profile.
+         * @param icc_profile_size Receives the size of the ICC profile.
+         * @return True if the ICC profile is retrieved successfully, false if the ICC profile chunks are inconsistent.
+         */
+        bool GetIccProfile(const uint8_t **icc_profile, size_t *icc_profile_size) const;
+
+        /**
+         * @brief Retrieves the estimated IJG quality factor of the quantization table of the first component.
+         * @return The quality factor (1 to 100), or 0 if the stream has not been parsed up to the scan header.
+         */
+        uint32_t GetQualityFactor() const;
+
+        /**
+         * @brief Locates the JPEG images of a buffer that contains several images back to back or an MPO file.
+         * @param buffer The pointer to the buffer.
+         * @param buffer_size The size of the buffer.
+         * @param image_spans Receives the locations of the images, in the order in which they are found.
+         */
+        static void SplitJpegImages(const uint8_t *buffer, size_t buffer_size, std::vector<JpegImageSpan> &image_spans);
+
+        /**
+         * @brief Removes the byte stuffing and the restart markers from the entropy-coded data of a scan.
+         * @param scan_data The entropy-coded data, as returned in the slice data buffer of the stream parameters.
+         * @param scan_data_size The size of the entropy-coded data.
+         * @param entropy_data Receives the unstuffed data and the restart offsets. Its buffers are reused.
+         */
+        static void UnstuffEntropyData(const uint8_t *scan_data, size_t scan_data_size, JpegEntropyData &entropy_data);
+
     private:
+        /**
+         * @brief Finds the end of the JPEG image that starts at the given offset by walking its marker segments.
+         * @param buffer The pointer to the buffer.
+         * @param buffer_size The size of the buffer.
+         * @param image_offset The offset of the SOI marker of the image.
+         * @param mp_image_spans Receives the images described by the MP index of the image, if any.
+         * @return The offset following the EOI marker of the image, or buffer_size if the image is not terminated.
+         */
+        static size_t FindJpegImageEnd(const uint8_t *buffer, size_t buffer_size, size_t image_offset, std::vector<JpegImageSpan> &mp_image_spans);
+
+        /**
+         * @brief Parses the MP index of an APP2 "MPF" segment.
+         * @param buffer The pointer to the buffer.
+         * @param buffer_size The size of the buffer.
+         * @param image_offset The offset of the SOI marker of the image containing the segment.
+         * @param mp_header_offset The offset of the MP header (the endianness field) of the segment.
+         * @param mp_header_size The size of the segment from the MP header.
+         * @param mp_image_spans Receives the images described by the MP index.
+         */
+        static void ParseMpfIndex(const uint8_t *buffer, size_t buffer_size, size_t image_offset, size_t mp_header_offset, size_t mp_header_size,
+                                  std::vector<JpegImageSpan> &mp_image_spans);
+
+        /**
+         * @brief Parses a marker segment; `stream_` must point at the length field of the segment.
+         * @param marker The marker of the segment.
+         * @return True if the marker segment is successfully parsed, false otherwise.
+         */
+        bool ParseMarkerSegment(uint8_t marker);
+
+        /**
+         * @brief Computes the seed of the content hash from the tables and the headers of the stream.
+         * @return The seed of the content hash.
+         */
+        uint64_t GetContentHashSeed() const;
+
+        /**
+         * @brief Assembles an ICC profile that is split over several APP2 segments into icc_profile_buffer_.
+         */
+        void AssembleIccProfile();
+
+        /**
+         * @brief Parses an application (APPn) segment and records its location and the metadata it carries.
+         * @param marker The APPn marker of the segment.
+         * @return True if the APPn segment is successfully parsed, false otherwise.
+         */
+        bool ParseAPP(uint8_t marker);
+
+        /**
+         * @brief Parses the orientation tag of the 0th IFD and the JPEG thumbnail of the 1st IFD of an EXIF APP1 segment.
+         * @param tiff_header The pointer to the TIFF header of the EXIF data.
+         * @param tiff_size The size of the EXIF data from the TIFF header.
+         */
+        void ParseExif(const uint8_t *tiff_header, uint32_t tiff_size);
+
+        /**
+         * @brief Parses all the complete marker segments buffered by ParseJpegStreamChunk up to the SOS marker.
+         * @return True if the buffered marker segments are successfully parsed, false otherwise.
+         */
+        bool ParseBufferedMarkerSegments();
+
+        /**
+         * @brief Resets the parser to the start of a new stream and discards any buffered chunks.
+         */
+        void ResetParseState();
+
         /**
          * @brief Parses the Start of Image (SOI) marker.
          * @return True if the SOI marker is successfully parsed, false otherwise.
@@ -262,11 +652,27 @@ class RocJpegStreamParser {
         ChromaSubsampling GetChromaSubsampling(uint8_t c1_h_sampling_factor, uint8_t c2_h_sampling_factor, uint8_t c3_h_sampling_factor,
                                                uint8_t c1_v_sampling_factor, uint8_t c2_v_sampling_factor, uint8_t c3_v_sampling_factor);
 
+        const uint8_t *stream_start_; ///< Pointer to the start of the JPEG stream.
         const uint8_t *stream_; ///< Pointer to the JPEG stream.
         const uint8_t *stream_end_; ///< Pointer to the end of the JPEG stream.
         uint32_t stream_length_; ///< Length of the JPEG stream.
         JpegStreamParameters jpeg_stream_parameters_; ///< JPEG stream parameters.
-        std::mutex mutex_; ///< Mutex for thread safety.
+        JpegTableSet table_set_; ///< The tables defined by the DQT and DHT segments parsed so far.
+        std::shared_ptr<const JpegInternedTableSet> interned_table_set_; ///< The interned tables referenced by jpeg_stream_parameters_.
+        JpegStreamMetadata jpeg_stream_metadata_; ///< Metadata of the JPEG stream.
+        std::vector<uint8_t> icc_profile_buffer_; ///< Buffer for an ICC profile split over several APP2 segments.
+        bool sof_marker_found_; ///< True if the SOF marker has been parsed.
+        bool dht_marker_found_; ///< True if at least one DHT marker has been parsed.
+        bool dqt_marker_found_; ///< True if at least one DQT marker has been parsed.
+        bool sos_marker_found_; ///< True if the SOS marker has been parsed.
+        std::vector<uint8_t> chunk_buffer_; ///< Buffer accumulating the chunks passed to ParseJpegStreamChunk, or the headers passed to ParseJpegStreamV.
+        std::vector<JpegDataSegment> scan_data_segments_; ///< The segments of the entropy-coded data passed to ParseJpegStreamV.
+        size_t chunk_parse_offset_; ///< Offset in chunk_buffer_ of the next marker segment to parse.
+        size_t chunk_scan_data_offset_; ///< Offset in chunk_buffer_ of the entropy-coded data of the scan.
+        size_t chunk_eoi_search_offset_; ///< Offset in chunk_buffer_ from where to resume searching for the EOI marker.
+        JpegChunkParseState chunk_parse_state_; ///< Progress of the chunked parse.
+        JpegContentHashState chunk_hash_state_; ///< The hash of the entropy-coded data searched so far by ParseJpegStreamChunk.
+        uint64_t content_hash_; ///< The content hash of the stream, see GetContentHash.
 };
 
 #endif  // ROC_JPEG_PARSER_H_
\ No newline at end of file
@@ -0,0 +1,134 @@
+/*
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "rocjpeg_stream_handle_pool.h"
+
+RocJpegStreamHandlePool::RocJpegStreamHandlePool() : num_blocks_{0}, free_head_{0} {
+    Grow();
+}
+
+RocJpegStreamHandlePool& RocJpegStreamHandlePool::GetInstance() {
+    static RocJpegStreamHandlePool stream_handle_pool;
+    return stream_handle_pool;
+}
+
+/**
+ * @brief Takes a free handle from the pool.
+ *
+ * The fast path is a single compare-and-swap on the head of the free stack. If the stack is empty, a new block of
+ * handles is constructed; another thread may have grown the pool or released a handle in the meantime, so the
+ * stack is popped again before growing.
+ *
+ * @return A pointer to the handle, or nullptr if the pool has reached its maximum size and all handles are in use.
+ */
+RocJpegStreamParserHandle* RocJpegStreamHandlePool::Acquire() {
+    RocJpegStreamParserHandle *handle = Pop();
+    while (handle == nullptr) {
+        {
+            std::lock_guard<std::mutex> lock(grow_mutex_);
+            handle = Pop();
+            if (handle != nullptr) {
+                break;
+            }
+            if (!Grow()) {
+                return nullptr;
+            }
+        }
+        handle = Pop();
+    }
+    return handle;
+}
+
+/**
+ * @brief Returns a handle to the pool.
+ *
+ * The error message of the handle is cleared; the parser keeps its buffers and its interned tables, so the next
+ * parse with the handle does not need to allocate memory. A handle that is already in the pool is left alone, since
+ * pushing it twice would link it into the free stack twice and hand it out to two threads.
+ *
+ * @param handle The handle.
+ * @return true if the handle was returned, false if it had already been released.
+ */
+bool RocJpegStreamHandlePool::Release(RocJpegStreamParserHandle *handle) {
+    if (handle->in_pool.load(std::memory_order_acquire)) {
+        return false;
+    }
+    handle->Recycle();
+    return Push(handle);
+}
+
+RocJpegStreamParserHandle* RocJpegStreamHandlePool::GetHandle(uint32_t pool_index) const {
+    uint32_t index = pool_index - 1;
+    return &blocks_[index / kBlockSize][index % kBlockSize];
+}
+
+bool RocJpegStreamHandlePool::Push(RocJpegStreamParserHandle *handle) {
+    if (handle->in_pool.exchange(true, std::memory_order_acq_rel)) {
+        return false;
+    }
+    uint64_t head = free_head_.load(std::memory_order_relaxed);
+    uint64_t new_head;
+    do {
+        handle->pool_next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        new_head = (((head >> 32) + 1) << 32) | handle->pool_index;
+    } while (!free_head_.compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed));
+    return true;
+}
+
+RocJpegStreamParserHandle* RocJpegStreamHandlePool::Pop() {
+    uint64_t head = free_head_.load(std::memory_order_acquire);
+    while (static_cast<uint32_t>(head) != 0) {
+        // The handle may be popped by another thread before the compare-and-swap below; the handles are never
+        // freed, so reading its link is safe, and the update counter makes the compare-and-swap fail in that case
+        RocJpegStreamParserHandle *handle = GetHandle(static_cast<uint32_t>(head));
+        uint64_t new_head = (((head >> 32) + 1) << 32) | handle->pool_next.load(std::memory_order_relaxed);
+        if (free_head_.compare_exchange_weak(head, new_head, std::memory_order_acquire, std::memory_order_acquire)) {
+            handle->in_pool.store(false, std::memory_order_release);
+            return handle;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Constructs a new block of handles and pushes them on the free stack.
+ *
+ * The caller must hold grow_mutex_, except in the constructor.
+ *
+ * @return true if a block was added, false if the pool has reached its maximum size.
+ */
+bool RocJpegStreamHandlePool::Grow() {
+    uint32_t block_index = num_blocks_.load(std::memory_order_relaxed);
+    if (block_index == kMaxBlocks) {
+        ERR("the stream handle pool has reached its maximum size!");
+        return false;
+    }
+    blocks_[block_index] = std::make_unique<RocJpegStreamParserHandle[]>(kBlockSize);
+    num_blocks_.store(block_index + 1, std::memory_order_release);
+    for (uint32_t i = kBlockSize; i > 0; i--) {
+        RocJpegStreamParserHandle *handle = &blocks_[block_index][i - 1];
+        handle->pool_index = block_index * kBlockSize + i;
+        Push(handle);
+    }
+    return true;
+}
@@ -0,0 +1,102 @@
+/*
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef ROC_JPEG_STREAM_HANDLE_POOL_H_
+#define ROC_JPEG_STREAM_HANDLE_POOL_H_
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include "rocjpeg_api_stream_handle.h"
+
+/**
+ * @class RocJpegStreamHandlePool
+ * @brief A process-wide, lock-free pool of pre-constructed stream handles.
+ *
+ * The handles are constructed in blocks of kBlockSize and are never freed while the process runs, so a handle can
+ * be handed out and returned without any heap allocation. The free handles form a singly linked stack (a Treiber
+ * stack) whose links are pool indices; the head of the stack packs the index of the top handle with a counter that
+ * is incremented on every update, which protects the compare-and-swap loops against the ABA problem. A new block is
+ * only constructed, under a mutex, when all the handles are in use.
+ */
+class RocJpegStreamHandlePool {
+    public:
+        /**
+         * @brief Returns the process-wide stream handle pool.
+         * @return A reference to the stream handle pool.
+         */
+        static RocJpegStreamHandlePool& GetInstance();
+
+        /**
+         * @brief Takes a free handle from the pool, growing the pool if all the handles are in use.
+         * @return A pointer to the handle, or nullptr if the pool cannot grow any further.
+         */
+        RocJpegStreamParserHandle* Acquire();
+
+        /**
+         * @brief Returns a handle to the pool.
+         * @param handle The handle, which must have been taken from the pool with Acquire.
+         * @return True if the handle was returned, false if it is already in the pool.
+         */
+        bool Release(RocJpegStreamParserHandle *handle);
+
+    private:
+        static constexpr uint32_t kBlockSize = 64; ///< The number of handles constructed at a time.
+        static constexpr uint32_t kMaxBlocks = 256; ///< The maximum number of blocks of handles.
+
+        RocJpegStreamHandlePool();
+
+        /**
+         * @brief Returns the handle with the given pool index.
+         * @param pool_index The 1-based pool index of the handle.
+         * @return A pointer to the handle.
+         */
+        RocJpegStreamParserHandle* GetHandle(uint32_t pool_index) const;
+
+        /**
+         * @brief Pushes a handle on the free stack.
+         * @param handle The handle.
+         * @return True if the handle was pushed, false if it is already on the free stack.
+         */
+        bool Push(RocJpegStreamParserHandle *handle);
+
+        /**
+         * @brief Pops a handle from the free stack.
+         * @return A pointer to the handle, or nullptr if the free stack is empty.
+         */
+        RocJpegStreamParserHandle* Pop();
+
+        /**
+         * @brief Constructs a new block of handles and pushes them on the free stack.
+         * @return True if a block was added, false if the pool has reached its maximum size.
+         */
+        bool Grow();
+
+        std::unique_ptr<RocJpegStreamParserHandle[]> blocks_[kMaxBlocks]; ///< The blocks of handles.
+        std::atomic<uint32_t> num_blocks_; ///< The number of blocks constructed so far.
+        std::atomic<uint64_t> free_head_; ///< (update counter << 32) | pool index of the top free handle, or 0 if none.
+        std::mutex grow_mutex_; ///< Mutex serializing the construction of new blocks.
+};
+
+#endif // ROC_JPEG_STREAM_HANDLE_POOL_H_
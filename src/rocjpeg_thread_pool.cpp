@@ -0,0 +1,144 @@
+/*
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <memory>
+#include "rocjpeg_thread_pool.h"
+
+RocJpegThreadPool::RocJpegThreadPool(uint32_t num_threads) : shutdown_{false} {
+    threads_.reserve(num_threads);
+    for (uint32_t i = 0; i < num_threads; i++) {
+        threads_.emplace_back(&RocJpegThreadPool::ThreadEntry, this);
+    }
+}
+
+RocJpegThreadPool::~RocJpegThreadPool() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        shutdown_ = true;
+        cond_var_.notify_all();
+    }
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void RocJpegThreadPool::ExecuteJob(std::function<void()> job) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    jobs_queue_.emplace(std::move(job));
+    cond_var_.notify_one();
+}
+
+void RocJpegThreadPool::ThreadEntry() {
+    std::function<void()> job;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_var_.wait(lock, [&] {return shutdown_ || !jobs_queue_.empty();});
+            if (jobs_queue_.empty()) {
+                // No jobs to do; shutting down
+                return;
+            }
+            job = std::move(jobs_queue_.front());
+            jobs_queue_.pop();
+        }
+        // Execute the job without holding any locks
+        job();
+    }
+}
+
+/**
+ * @brief Runs `func(i)` for every i in [0, count) using the worker threads and the calling thread.
+ *
+ * The shared state is reference counted so that a helper job which only gets to run after all the indices
+ * have been processed (e.g., because the pool is busy with another batch) can still safely find out that
+ * there is nothing left to do. The calling thread only waits for the indices to be completed, not for
+ * the helper jobs to be scheduled.
+ *
+ * @param count The number of indices to process.
+ * @param func The function to call for each index.
+ */
+void RocJpegThreadPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)> &func) {
+    if (count == 0) {
+        return;
+    }
+    uint32_t num_helpers = std::min(GetNumThreads(), count - 1);
+    if (num_helpers == 0) {
+        for (uint32_t i = 0; i < count; i++) {
+            func(i);
+        }
+        return;
+    }
+
+    struct ParallelForState {
+        std::atomic<uint32_t> next_index{0};
+        uint32_t num_completed{0};
+        uint32_t count;
+        const std::function<void(uint32_t)> *func;
+        std::mutex mutex;
+        std::condition_variable cond_var;
+    };
+    auto state = std::make_shared<ParallelForState>();
+    state->count = count;
+    state->func = &func;
+
+    auto run = [](ParallelForState &s) {
+        uint32_t num_processed = 0;
+        uint32_t index;
+        while ((index = s.next_index.fetch_add(1, std::memory_order_relaxed)) < s.count) {
+            (*s.func)(index);
+            num_processed++;
+        }
+        if (num_processed > 0) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.num_completed += num_processed;
+            if (s.num_completed == s.count) {
+                s.cond_var.notify_all();
+            }
+        }
+    };
+
+    for (uint32_t i = 0; i < num_helpers; i++) {
+        ExecuteJob([state, run]() { run(*state); });
+    }
+    run(*state);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cond_var.wait(lock, [&] {return state->num_completed == state->count;});
+}
+
+RocJpegThreadPool& RocJpegThreadPool::GetParserThreadPool() {
+    static RocJpegThreadPool parser_thread_pool([]() {
+        uint32_t num_threads = std::thread::hardware_concurrency();
+        num_threads = num_threads > 1 ? num_threads - 1 : 1;
+        char value[16];
+        if (GetEnv("ROCJPEG_NUM_PARSER_THREADS", value, sizeof(value))) {
+            int requested_threads = std::atoi(value);
+            if (requested_threads >= 0) {
+                num_threads = static_cast<uint32_t>(requested_threads);
+            }
+        }
+        return num_threads;
+    }());
+    return parser_thread_pool;
+}
@@ -0,0 +1,98 @@
+/*
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef ROC_JPEG_THREAD_POOL_H_
+#define ROC_JPEG_THREAD_POOL_H_
+
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+#include "rocjpeg_commons.h"
+
+/**
+ * @class RocJpegThreadPool
+ * @brief A fixed-size pool of worker threads used for CPU-side work inside the rocJPEG library.
+ *
+ * The pool is created once per process (see GetParserThreadPool) and is shared by all the stream and
+ * decoder handles. Jobs are queued in FIFO order and executed by the first available worker.
+ */
+class RocJpegThreadPool {
+    public:
+        /**
+         * @brief Constructs a RocJpegThreadPool object and starts the worker threads.
+         * @param num_threads The number of worker threads to create.
+         */
+        explicit RocJpegThreadPool(uint32_t num_threads);
+
+        /**
+         * @brief Stops and joins all the worker threads.
+         */
+        ~RocJpegThreadPool();
+
+        /**
+         * @brief Returns the number of worker threads in the pool.
+         */
+        uint32_t GetNumThreads() const { return static_cast<uint32_t>(threads_.size()); }
+
+        /**
+         * @brief Queues a job for execution by one of the worker threads.
+         * @param job The job to execute.
+         */
+        void ExecuteJob(std::function<void()> job);
+
+        /**
+         * @brief Runs `func(i)` for every i in [0, count) and returns once all calls have completed.
+         *
+         * The indices are handed out dynamically, so the workers and the calling thread (which also
+         * takes part in the work) stay busy even if the cost of the individual calls varies a lot.
+         *
+         * @param count The number of indices to process.
+         * @param func The function to call for each index.
+         */
+        void ParallelFor(uint32_t count, const std::function<void(uint32_t)> &func);
+
+        /**
+         * @brief Returns the process-wide thread pool used for parsing JPEG streams.
+         *
+         * The number of worker threads defaults to the number of hardware threads minus one (the calling
+         * thread takes part in the work) and can be overridden with the ROCJPEG_NUM_PARSER_THREADS
+         * environment variable.
+         */
+        static RocJpegThreadPool& GetParserThreadPool();
+
+    private:
+        void ThreadEntry();
+
+        std::mutex mutex_;
+        std::condition_variable cond_var_;
+        bool shutdown_;
+        std::queue<std::function<void()>> jobs_queue_;
+        std::vector<std::thread> threads_;
+};
+
+#endif //ROC_JPEG_THREAD_POOL_H_
@@ -25,19 +25,13 @@ THE SOFTWARE.
 /**
  * @brief Default constructor for RocJpegVaapiMemoryPool class.
  *
- * This constructor initializes the memory pool for different surface formats used in RocJpegVappiDecoder.
- * It creates an empty vector for each surface format and stores it in the mem_pool_ map.
+ * This constructor initializes an empty memory pool for the surfaces used in RocJpegVappiDecoder.
  *
  * @param None
  * @return None
  */
-RocJpegVaapiMemoryPool::RocJpegVaapiMemoryPool() {
-    std::vector<uint32_t> surface_formats = {VA_FOURCC_RGBA, VA_FOURCC_RGBP, VA_FOURCC_444P, VA_FOURCC_422V, VA_FOURCC_YUY2, VA_FOURCC_NV12, VA_FOURCC_Y800};
-    for (auto surface_format : surface_formats) {
-        mem_pool_[surface_format] = std::vector<RocJpegVaapiMemPoolEntry>();
-    }
-    max_pool_size_ = 2;
-}
+RocJpegVaapiMemoryPool::RocJpegVaapiMemoryPool() : va_display_{0}, max_pool_size_{2}, release_sequence_{0}, total_bytes_{0},
+    max_pool_bytes_{0}, idle_timeout_{0} {}
 
 /**
  * @brief Releases the resources used by the RocJpegVaapiMemoryPool.
@@ -51,38 +45,110 @@ RocJpegVaapiMemoryPool::RocJpegVaapiMemoryPool() {
 void RocJpegVaapiMemoryPool::ReleaseResources() {
     VAStatus va_status;
     hipError_t hip_status;
-    for (auto& pair : mem_pool_) {
-        for (auto& entry : pair.second) {
-            if (!entry.va_surface_ids.empty()) {
-                va_status = vaDestroySurfaces(va_display_, entry.va_surface_ids.data(), entry.va_surface_ids.size());
-                if (va_status != VA_STATUS_SUCCESS) {
-                    ERR("ERROR: vaDestroySurfaces failed!");
-                }
+    std::vector<VASurfaceID> va_surface_ids;
+    va_surface_ids.reserve(mem_pool_.size());
+    for (auto& entry : mem_pool_) {
+        va_surface_ids.push_back(entry.va_surface_id);
+        if (entry.hip_interop.hip_mapped_device_mem != nullptr) {
+            hip_status = hipFree(entry.hip_interop.hip_mapped_device_mem);
+            if (hip_status != hipSuccess) {
+                ERR("ERROR: hipFree failed!");
             }
-            if (!entry.hip_interops.empty()) {
-                for(auto& hip_interop_entry : entry.hip_interops) {
-                    if (hip_interop_entry.hip_mapped_device_mem != nullptr) {
-                        hip_status = hipFree(hip_interop_entry.hip_mapped_device_mem);
-                        if (hip_status != hipSuccess) {
-                            ERR("ERROR: hipFree failed!");
-                        }
-                    }
-                    if (hip_interop_entry.hip_ext_mem != nullptr) {
-                        hip_status = hipDestroyExternalMemory(hip_interop_entry.hip_ext_mem);
-                        if (hip_status != hipSuccess) {
-                            ERR("ERROR: hipDestroyExternalMemory failed!");
-                        }
-                    }
-                }
+        }
+        if (entry.hip_interop.hip_ext_mem != nullptr) {
+            hip_status = hipDestroyExternalMemory(entry.hip_interop.hip_ext_mem);
+            if (hip_status != hipSuccess) {
+                ERR("ERROR: hipDestroyExternalMemory failed!");
             }
         }
     }
+    if (!va_surface_ids.empty()) {
+        va_status = vaDestroySurfaces(va_display_, va_surface_ids.data(), va_surface_ids.size());
+        if (va_status != VA_STATUS_SUCCESS) {
+            ERR("ERROR: vaDestroySurfaces failed!");
+        }
+    }
+    mem_pool_.clear();
+    surface_index_.clear();
+    idle_entries_.clear();
+    total_bytes_ = 0;
 }
 
 void RocJpegVaapiMemoryPool::SetPoolSize(uint32_t max_pool_size) {
     max_pool_size_ = max_pool_size;
 }
 
+/**
+ * @brief Sets the memory limits of the memory pool.
+ *
+ * The least recently used idle entries are deleted until the pool fits in the new budget. The busy entries are
+ * never deleted, so the pool may stay over budget until they become idle.
+ *
+ * @param max_pool_bytes The maximum memory held by the surfaces of the pool in bytes, or 0 for no limit.
+ * @param idle_timeout_ms The time after which an idle entry is deleted in milliseconds, or 0 to keep idle entries.
+ */
+void RocJpegVaapiMemoryPool::SetMemoryLimits(size_t max_pool_bytes, uint32_t idle_timeout_ms) {
+    max_pool_bytes_ = max_pool_bytes;
+    idle_timeout_ = std::chrono::milliseconds(idle_timeout_ms);
+    while (max_pool_bytes_ > 0 && total_bytes_ > max_pool_bytes_ && DeleteIdleEntry()) {
+    }
+    ReleaseExpiredEntries();
+}
+
+/**
+ * @brief Makes room in the memory budget for new surfaces.
+ *
+ * The least recently used idle entries are deleted until the new surfaces fit in the budget, or until no entry is
+ * idle. The memory is not set aside: the new surfaces are accounted for when they are added to the pool.
+ *
+ * @param surface_format The pixel format of the new surfaces.
+ * @param image_width The width of the new surfaces.
+ * @param image_height The height of the new surfaces.
+ * @param num_surfaces The number of new surfaces.
+ * @return true if the new surfaces fit in the memory budget, or if no budget is set, false otherwise.
+ */
+bool RocJpegVaapiMemoryPool::ReserveMemory(uint32_t surface_format, uint32_t image_width, uint32_t image_height, uint32_t num_surfaces) {
+    if (max_pool_bytes_ == 0) {
+        return true;
+    }
+    size_t size_in_bytes = EstimateSurfaceSize(surface_format, image_width, image_height) * num_surfaces;
+    while (total_bytes_ + size_in_bytes > max_pool_bytes_) {
+        if (!DeleteIdleEntry()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RocJpegVaapiMemoryPool::TrimIdleEntries() {
+    while (DeleteIdleEntry()) {
+    }
+}
+
+/**
+ * @brief Deletes the entries that have been idle for longer than the idle timeout.
+ *
+ * The lists of idle entries are ordered by release time, so only their expired fronts are visited.
+ */
+void RocJpegVaapiMemoryPool::ReleaseExpiredEntries() {
+    if (idle_timeout_.count() == 0) {
+        return;
+    }
+    auto expiry_time = std::chrono::steady_clock::now() - idle_timeout_;
+    for (auto idle = idle_entries_.begin(); idle != idle_entries_.end();) {
+        // Erasing the last entry of a list erases the list, so the expired entries are counted first.
+        auto next = std::next(idle);
+        size_t num_expired = 0;
+        while (num_expired < idle->second.size() && idle->second[num_expired]->release_time <= expiry_time) {
+            num_expired++;
+        }
+        for (; num_expired > 0; num_expired--) {
+            EraseIdleEntry(idle, idle->second.front());
+        }
+        idle = next;
+    }
+}
+
 void RocJpegVaapiMemoryPool::SetVaapiDisplay(const VADisplay& va_display) {
     va_display_ = va_display;
 }
@@ -90,56 +156,95 @@ void RocJpegVaapiMemoryPool::SetVaapiDisplay(const VADisplay& va_display) {
 /**
  * @brief Retrieves the total size of the memory pool.
  *
- * This function iterates through the memory pool and sums up the sizes of all entries.
- *
- * @return The total size of the memory pool.
+ * @return The number of entries of the memory pool.
  */
 size_t RocJpegVaapiMemoryPool::GetTotalMemPoolSize() const {
-    size_t total_mem_pool_size = 0;
-    for (const auto& pair : mem_pool_) {
-        total_mem_pool_size += pair.second.size();
-    }
-    return total_mem_pool_size;
+    return mem_pool_.size();
 }
 
 /**
  * @brief Deletes an idle entry from the memory pool.
  *
- * This function iterates through the memory pool and searches for an entry
- * with the status `kIdle`. If such an entry is found, it performs the following
- * cleanup operations:
- * - Destroys the VAAPI context if it exists.
- * - Destroys the VAAPI surfaces if they exist.
+ * This function deletes the least recently used idle entry, which is the oldest entry of one of the lists of idle
+ * entries, and performs the following cleanup operations:
+ * - Destroys the VAAPI surface.
  * - Frees HIP mapped device memory and destroys HIP external memory if they exist.
- * - Resets the HIP interop entries.
+ * - Removes the surface from the surface index.
  *
  * After performing the cleanup, the idle entry is removed from the memory pool.
  *
  * @return true if an idle entry was found and deleted, false otherwise.
  */
 bool RocJpegVaapiMemoryPool::DeleteIdleEntry() {
-    for (auto& pair : mem_pool_) {
-        auto it = std::find_if(pair.second.begin(), pair.second.end(), [](const RocJpegVaapiMemPoolEntry& entry) {return entry.entry_status == kIdle;});
-        if (it != pair.second.end()) {
-            auto index = std::distance(pair.second.begin(), it);
-            if (!pair.second[index].va_surface_ids.empty()) {
-                CHECK_VAAPI(vaDestroySurfaces(va_display_, pair.second[index].va_surface_ids.data(), pair.second[index].va_surface_ids.size()));
-                std::fill(pair.second[index].va_surface_ids.begin(), pair.second[index].va_surface_ids.end(), 0);
-            }
-            if (!pair.second[index].hip_interops.empty()) {
-                for(auto& hip_interop_entry : pair.second[index].hip_interops) {
-                    if (hip_interop_entry.hip_mapped_device_mem != nullptr)
-                        CHECK_HIP(hipFree(hip_interop_entry.hip_mapped_device_mem));
-                    if (hip_interop_entry.hip_ext_mem != nullptr)
-                        CHECK_HIP(hipDestroyExternalMemory(hip_interop_entry.hip_ext_mem));
-                    memset((void*)&hip_interop_entry, 0, sizeof(hip_interop_entry));
-                }
-            }
-            pair.second.erase(it);
-            return true;
+    auto oldest = idle_entries_.end();
+    for (auto idle = idle_entries_.begin(); idle != idle_entries_.end(); ++idle) {
+        if (oldest == idle_entries_.end() || idle->second.front()->release_sequence < oldest->second.front()->release_sequence) {
+            oldest = idle;
         }
     }
-    return false;
+    if (oldest == idle_entries_.end()) {
+        return false;
+    }
+    EraseIdleEntry(oldest, oldest->second.front());
+    return true;
+}
+
+/**
+ * @brief Deletes an idle entry, at the front of its list of idle entries, and releases its surface.
+ *
+ * The list is erased from the map of idle entries if the entry was its last one. The errors of the release are
+ * reported but do not stop it, since the entry has to leave the pool either way.
+ *
+ * @param idle The list of idle entries of the entry.
+ * @param it The entry.
+ */
+void RocJpegVaapiMemoryPool::EraseIdleEntry(std::unordered_map<MemPoolKey, std::deque<std::list<RocJpegVaapiMemPoolEntry>::iterator>>::iterator idle,
+                                            std::list<RocJpegVaapiMemPoolEntry>::iterator it) {
+    idle->second.pop_front();
+    if (idle->second.empty()) {
+        idle_entries_.erase(idle);
+    }
+    surface_index_.erase(it->va_surface_id);
+    if (vaDestroySurfaces(va_display_, &it->va_surface_id, 1) != VA_STATUS_SUCCESS) {
+        ERR("ERROR: vaDestroySurfaces failed!");
+    }
+    if (it->hip_interop.hip_mapped_device_mem != nullptr && hipFree(it->hip_interop.hip_mapped_device_mem) != hipSuccess) {
+        ERR("ERROR: hipFree failed!");
+    }
+    if (it->hip_interop.hip_ext_mem != nullptr && hipDestroyExternalMemory(it->hip_interop.hip_ext_mem) != hipSuccess) {
+        ERR("ERROR: hipDestroyExternalMemory failed!");
+    }
+    total_bytes_ -= it->size_in_bytes;
+    mem_pool_.erase(it);
+}
+
+/**
+ * @brief Estimates the memory held by a surface from its pixel format and size.
+ *
+ * The estimate is replaced by the size of the exported surface, which includes the padding of the driver, when the
+ * surface is first mapped to HIP.
+ *
+ * @param surface_format The pixel format of the surface.
+ * @param width The width of the surface.
+ * @param height The height of the surface.
+ * @return The estimated size of the surface in bytes.
+ */
+size_t RocJpegVaapiMemoryPool::EstimateSurfaceSize(uint32_t surface_format, uint32_t width, uint32_t height) {
+    size_t num_pixels = static_cast<size_t>(width) * height;
+    switch (surface_format) {
+        case VA_FOURCC_Y800:
+            return num_pixels;
+        case VA_FOURCC_NV12:
+            return num_pixels * 3 / 2;
+        case VA_FOURCC_YUY2:
+        case VA_FOURCC_422V:
+            return num_pixels * 2;
+        case VA_FOURCC_444P:
+        case VA_FOURCC_RGBP:
+            return num_pixels * 3;
+        default:
+            return num_pixels * 4;
+    }
 }
 
 /**
@@ -147,7 +252,9 @@ bool RocJpegVaapiMemoryPool::DeleteIdleEntry() {
  *
  * This function adds a pool entry to the memory pool for a specific surface format.
  * If the memory pool for the given surface format is not full, the new entry is added to the pool.
- * If the memory pool is full, the oldest entry is removed from the pool and replaced with the new entry.
+ * If the memory pool is full, or the new entry would take it over its memory budget, the least recently used idle
+ * entries are removed from the pool until it fits.
+ * If the memory pool is full and no entry is idle, the new entry is added anyway.
  * If the removed entry has associated resources (VA context, VA surface, HIP memory), they are destroyed and freed.
  *
  * @param surface_format The surface format for which the pool entry is being added.
@@ -155,17 +262,23 @@ bool RocJpegVaapiMemoryPool::DeleteIdleEntry() {
  * @return The status of the operation. Returns ROCJPEG_STATUS_SUCCESS if the operation is successful.
  */
 RocJpegStatus RocJpegVaapiMemoryPool::AddPoolEntry(uint32_t surface_format, const RocJpegVaapiMemPoolEntry& pool_entry) {
-    size_t total_mem_pool_size = GetTotalMemPoolSize();
-    auto& entries = mem_pool_[surface_format];
-    if (total_mem_pool_size < max_pool_size_) {
-        entries.push_back(pool_entry);
-    } else {
-        if (DeleteIdleEntry()) {
-            entries.push_back(pool_entry);
-        } else {
-            ERR("cannot find an idle entry in the the memory pool!");
-            return ROCJPEG_STATUS_INVALID_PARAMETER;
-        }
+    size_t size_in_bytes = EstimateSurfaceSize(surface_format, pool_entry.image_width, pool_entry.image_height);
+    // When every entry is busy, e.g. with asynchronous decode jobs in flight, the pool grows past its maximum
+    // size and budget; the excess entries are deleted again as they become idle and are replaced.
+    while ((GetTotalMemPoolSize() >= max_pool_size_ || (max_pool_bytes_ > 0 && total_bytes_ + size_in_bytes > max_pool_bytes_)) &&
+           DeleteIdleEntry()) {
+    }
+    mem_pool_.push_back(pool_entry);
+    auto it = std::prev(mem_pool_.end());
+    it->surface_format = surface_format;
+    it->release_sequence = 0;
+    it->size_in_bytes = size_in_bytes;
+    total_bytes_ += size_in_bytes;
+    surface_index_[it->va_surface_id] = it;
+    if (it->entry_status == kIdle) {
+        it->release_sequence = ++release_sequence_;
+        it->release_time = std::chrono::steady_clock::now();
+        idle_entries_[{surface_format, it->image_width, it->image_height}].push_back(it);
     }
     return ROCJPEG_STATUS_SUCCESS;
 }
@@ -176,113 +289,137 @@ RocJpegStatus RocJpegVaapiMemoryPool::AddPoolEntry(uint32_t surface_format, cons
  * @param surface_format The surface pixel format of the entry to retrieve.
  * @param image_width The width of the image of the entry to retrieve.
  * @param image_height The height of the image of the entry to retrieve.
- * @param num_surfaces The number of surfaces of the entry to retrieve.
- * @return The matching `RocJpegVaapiMemPoolEntry` if found, or a default-initialized entry if not found.
+ * The most recently released matching entry is returned, since its surface is the most likely to still be cached.
+ *
+ * @return A pointer to the matching `RocJpegVaapiMemPoolEntry`, now marked busy, or nullptr if no idle entry matches.
  */
-RocJpegVaapiMemPoolEntry RocJpegVaapiMemoryPool::GetEntry(uint32_t surface_format, uint32_t image_width, uint32_t image_height, uint32_t num_surfaces) {
-    for (auto& entry : mem_pool_[surface_format]) {
-        if (entry.image_width == image_width && entry.image_height == image_height && entry.va_surface_ids.size() == num_surfaces && entry.entry_status == kIdle) {
-            entry.entry_status = kBusy;
-            return entry;
-        }
+const RocJpegVaapiMemPoolEntry* RocJpegVaapiMemoryPool::GetEntry(uint32_t surface_format, uint32_t image_width, uint32_t image_height) {
+    auto idle = idle_entries_.find({surface_format, image_width, image_height});
+    if (idle == idle_entries_.end()) {
+        return nullptr;
+    }
+    auto it = idle->second.back();
+    idle->second.pop_back();
+    if (idle->second.empty()) {
+        idle_entries_.erase(idle);
     }
-    return {0, 0, kIdle, {}, {}};
+    it->entry_status = kBusy;
+    return &*it;
 }
 
 bool RocJpegVaapiMemoryPool::FindSurfaceId(VASurfaceID surface_id) {
-    for (auto& pair : mem_pool_) {
-        for (auto& entry : pair.second) {
-            if (std::find(entry.va_surface_ids.begin(), entry.va_surface_ids.end(), surface_id) != entry.va_surface_ids.end()) {
-                return true;
-            }
-        }
-    }
-    return false;
+    return surface_index_.find(surface_id) != surface_index_.end();
 }
 
 
 /**
  * @brief Retrieves the HipInteropDeviceMem associated with a given VASurfaceID from the memory pool.
  *
- * This function searches the memory pool for the entry that matches the provided VASurfaceID.
+ * This function looks up the entry that holds the provided VASurfaceID in the surface index of the memory pool.
  * If a matching entry is found and the associated HipInteropDeviceMem is not already initialized,
  * it initializes the HipInteropDeviceMem by exporting the VASurfaceID as a DRM prime surface handle,
  * importing it as an external memory object, and getting the mapped buffer for the external memory.
  * The function then updates the HipInteropDeviceMem with the surface format, width, height, offsets,
  * pitches, and number of layers from the exported surface descriptor.
  *
+ * The export and import are done once per surface, after its first decode, since the driver may reallocate the
+ * storage of a surface when it is first decoded into. The mapping is then reused by every following decode into
+ * the surface, and is released with the surface by DeleteIdleEntry or ReleaseResources.
+ *
  * @param surface_id The VASurfaceID to retrieve the HipInteropDeviceMem for.
  * @param hip_interop [out] The retrieved HipInteropDeviceMem.
  * @return RocJpegStatus Returns ROCJPEG_STATUS_SUCCESS if the HipInteropDeviceMem is successfully retrieved,
  *         ROCJPEG_STATUS_INVALID_PARAMETER if the requested surface_id is not found in the memory pool.
  */
 RocJpegStatus RocJpegVaapiMemoryPool::GetHipInteropMem(VASurfaceID surface_id, HipInteropDeviceMem& hip_interop) {
-    for (auto& pair : mem_pool_) {
-        auto& entries = pair.second;
-        auto it = std::find_if(entries.begin(), entries.end(),
-                              [surface_id](const RocJpegVaapiMemPoolEntry& entry){return std::find(entry.va_surface_ids.begin(), entry.va_surface_ids.end(), surface_id) != entry.va_surface_ids.end();});
-        if (it != entries.end()) {
-            auto idx = std::distance(it->va_surface_ids.begin(), std::find(it->va_surface_ids.begin(), it->va_surface_ids.end(), surface_id));
-            if (it->hip_interops[idx].hip_mapped_device_mem != nullptr) {
-                CHECK_HIP(hipFree(it->hip_interops[idx].hip_mapped_device_mem));
-                if (it->hip_interops[idx].hip_ext_mem != nullptr) {
-                    CHECK_HIP(hipDestroyExternalMemory(it->hip_interops[idx].hip_ext_mem));
-                }
-            }
-            VADRMPRIMESurfaceDescriptor va_drm_prime_surface_desc = {};
-            CHECK_VAAPI(vaExportSurfaceHandle(va_display_, surface_id, VA_SURFACE_ATTRIB_MEM_TYPE_DRM_PRIME_2,
-                VA_EXPORT_SURFACE_READ_ONLY | VA_EXPORT_SURFACE_SEPARATE_LAYERS,
-                &va_drm_prime_surface_desc));
-
-            hipExternalMemoryHandleDesc external_mem_handle_desc = {};
-            hipExternalMemoryBufferDesc external_mem_buffer_desc = {};
-            external_mem_handle_desc.type = hipExternalMemoryHandleTypeOpaqueFd;
-            external_mem_handle_desc.handle.fd = va_drm_prime_surface_desc.objects[0].fd;
-            external_mem_handle_desc.size = va_drm_prime_surface_desc.objects[0].size;
-
-            CHECK_HIP(hipImportExternalMemory(&it->hip_interops[idx].hip_ext_mem, &external_mem_handle_desc));
-            external_mem_buffer_desc.size = va_drm_prime_surface_desc.objects[0].size;
-            CHECK_HIP(hipExternalMemoryGetMappedBuffer((void**)&it->hip_interops[idx].hip_mapped_device_mem, it->hip_interops[idx].hip_ext_mem, &external_mem_buffer_desc));
-
-            uint32_t surface_format = va_drm_prime_surface_desc.fourcc;
-            // Workaround Mesa <= 24.3 returning non-standard VA fourcc
-            if (surface_format == VA_FOURCC('Y', 'U', 'Y', 'V'))
-                surface_format = VA_FOURCC_YUY2;
-
-            it->hip_interops[idx].surface_format = surface_format;
-            it->hip_interops[idx].width = va_drm_prime_surface_desc.width;
-            it->hip_interops[idx].height = va_drm_prime_surface_desc.height;
-            it->hip_interops[idx].size = va_drm_prime_surface_desc.objects[0].size;
-            it->hip_interops[idx].offset[0] = va_drm_prime_surface_desc.layers[0].offset[0];
-            it->hip_interops[idx].offset[1] = va_drm_prime_surface_desc.layers[1].offset[0];
-            it->hip_interops[idx].offset[2] = va_drm_prime_surface_desc.layers[2].offset[0];
-            it->hip_interops[idx].pitch[0] = va_drm_prime_surface_desc.layers[0].pitch[0];
-            it->hip_interops[idx].pitch[1] = va_drm_prime_surface_desc.layers[1].pitch[0];
-            it->hip_interops[idx].pitch[2] = va_drm_prime_surface_desc.layers[2].pitch[0];
-            it->hip_interops[idx].num_layers = va_drm_prime_surface_desc.num_layers;
-
-            for (uint32_t i = 0; i < va_drm_prime_surface_desc.num_objects; ++i) {
-                close(va_drm_prime_surface_desc.objects[i].fd);
-            }
-            hip_interop = it->hip_interops[idx];
-            return ROCJPEG_STATUS_SUCCESS;
+    auto location = surface_index_.find(surface_id);
+    if (location == surface_index_.end()) {
+        // it shouldn't reach here unless the requested surface_id is not in the memory pool.
+        ERR("the surface_id: " + TOSTR(surface_id) + " was not found in the memory pool!");
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    HipInteropDeviceMem &entry_hip_interop = location->second->hip_interop;
+
+    // The mapping of a surface is kept until the surface is destroyed with its pool entry.
+    if (entry_hip_interop.hip_mapped_device_mem != nullptr) {
+        hip_interop = entry_hip_interop;
+        return ROCJPEG_STATUS_SUCCESS;
+    }
+    VADRMPRIMESurfaceDescriptor va_drm_prime_surface_desc = {};
+    CHECK_VAAPI(vaExportSurfaceHandle(va_display_, surface_id, VA_SURFACE_ATTRIB_MEM_TYPE_DRM_PRIME_2,
+        VA_EXPORT_SURFACE_READ_ONLY | VA_EXPORT_SURFACE_SEPARATE_LAYERS,
+        &va_drm_prime_surface_desc));
+
+    hipExternalMemoryHandleDesc external_mem_handle_desc = {};
+    hipExternalMemoryBufferDesc external_mem_buffer_desc = {};
+    external_mem_handle_desc.type = hipExternalMemoryHandleTypeOpaqueFd;
+    external_mem_handle_desc.handle.fd = va_drm_prime_surface_desc.objects[0].fd;
+    external_mem_handle_desc.size = va_drm_prime_surface_desc.objects[0].size;
+
+    // The exported fds are only needed for the import, so they are closed whether it succeeds or not. A failed
+    // mapping also destroys the imported memory, leaving the entry unmapped as before the call.
+    auto close_exported_fds = [&]() {
+        for (uint32_t i = 0; i < va_drm_prime_surface_desc.num_objects; ++i) {
+            close(va_drm_prime_surface_desc.objects[i].fd);
         }
+    };
+    hipError_t hip_status = hipImportExternalMemory(&entry_hip_interop.hip_ext_mem, &external_mem_handle_desc);
+    if (hip_status != hipSuccess) {
+        ERR("hipImportExternalMemory failed with status " + STR(hipGetErrorName(hip_status)));
+        entry_hip_interop.hip_ext_mem = nullptr;
+        close_exported_fds();
+        return ROCJPEG_STATUS_EXECUTION_FAILED;
     }
-    // it shouldn't reach here unless the requested surface_id is not in the memory pool.
-    ERR("the surface_id: " + TOSTR(surface_id) + " was not found in the memory pool!");
-    return ROCJPEG_STATUS_INVALID_PARAMETER;
+    external_mem_buffer_desc.size = va_drm_prime_surface_desc.objects[0].size;
+    hip_status = hipExternalMemoryGetMappedBuffer((void**)&entry_hip_interop.hip_mapped_device_mem, entry_hip_interop.hip_ext_mem, &external_mem_buffer_desc);
+    if (hip_status != hipSuccess) {
+        ERR("hipExternalMemoryGetMappedBuffer failed with status " + STR(hipGetErrorName(hip_status)));
+        if (hipDestroyExternalMemory(entry_hip_interop.hip_ext_mem) != hipSuccess) {
+            ERR("ERROR: hipDestroyExternalMemory failed!");
+        }
+        entry_hip_interop.hip_ext_mem = nullptr;
+        entry_hip_interop.hip_mapped_device_mem = nullptr;
+        close_exported_fds();
+        return ROCJPEG_STATUS_EXECUTION_FAILED;
+    }
+
+    uint32_t surface_format = va_drm_prime_surface_desc.fourcc;
+    // Workaround Mesa <= 24.3 returning non-standard VA fourcc
+    if (surface_format == VA_FOURCC('Y', 'U', 'Y', 'V'))
+        surface_format = VA_FOURCC_YUY2;
+
+    entry_hip_interop.surface_format = surface_format;
+    entry_hip_interop.width = va_drm_prime_surface_desc.width;
+    entry_hip_interop.height = va_drm_prime_surface_desc.height;
+    entry_hip_interop.size = va_drm_prime_surface_desc.objects[0].size;
+    total_bytes_ = total_bytes_ - location->second->size_in_bytes + entry_hip_interop.size;
+    location->second->size_in_bytes = entry_hip_interop.size;
+    entry_hip_interop.offset[0] = va_drm_prime_surface_desc.layers[0].offset[0];
+    entry_hip_interop.offset[1] = va_drm_prime_surface_desc.layers[1].offset[0];
+    entry_hip_interop.offset[2] = va_drm_prime_surface_desc.layers[2].offset[0];
+    entry_hip_interop.pitch[0] = va_drm_prime_surface_desc.layers[0].pitch[0];
+    entry_hip_interop.pitch[1] = va_drm_prime_surface_desc.layers[1].pitch[0];
+    entry_hip_interop.pitch[2] = va_drm_prime_surface_desc.layers[2].pitch[0];
+    entry_hip_interop.num_layers = va_drm_prime_surface_desc.num_layers;
+
+    close_exported_fds();
+    hip_interop = entry_hip_interop;
+    return ROCJPEG_STATUS_SUCCESS;
 }
 
 bool RocJpegVaapiMemoryPool::SetSurfaceAsIdle(VASurfaceID surface_id) {
-    for (auto& pair : mem_pool_) {
-        for (auto& entry : pair.second) {
-            if (std::find(entry.va_surface_ids.begin(), entry.va_surface_ids.end(), surface_id) != entry.va_surface_ids.end()) {
-                entry.entry_status = kIdle;
-                return true;
-            }
-        }
+    auto location = surface_index_.find(surface_id);
+    if (location == surface_index_.end()) {
+        return false;
+    }
+    auto it = location->second;
+    if (it->entry_status == kBusy) {
+        it->entry_status = kIdle;
+        it->release_sequence = ++release_sequence_;
+        it->release_time = std::chrono::steady_clock::now();
+        idle_entries_[{it->surface_format, it->image_width, it->image_height}].push_back(it);
     }
-    return false;
+    return true;
 }
 
 /**
@@ -294,8 +431,8 @@ bool RocJpegVaapiMemoryPool::SetSurfaceAsIdle(VASurfaceID surface_id) {
  */
 RocJpegVappiDecoder::RocJpegVappiDecoder(int device_id) : device_id_{device_id}, drm_fd_{-1}, min_picture_width_{64}, min_picture_height_{64},
     max_picture_width_{4096}, max_picture_height_{4096}, supports_modifiers_{false}, va_display_{0}, va_config_attrib_{{}}, va_config_id_{0}, va_profile_{VAProfileJPEGBaseline},
-    vaapi_mem_pool_(std::make_unique<RocJpegVaapiMemoryPool>()), current_vcn_jpeg_spec_{0}, va_picture_parameter_buf_id_{0}, va_quantization_matrix_buf_id_{0}, va_huffmantable_buf_id_{0},
-    va_slice_param_buf_id_{0}, va_slice_data_buf_id_{0} {
+    vaapi_mem_pool_(std::make_unique<RocJpegVaapiMemoryPool>()), current_vcn_jpeg_spec_{0}, va_buffer_ring_index_{0},
+    picture_parameter_buffer_{} {
         vcn_jpeg_spec_ = {{"gfx908", {2, false, false}},
                           {"gfx90a", {2, false, false}},
                           {"gfx942_mi300a", {24, true, true}},
@@ -415,7 +552,9 @@ RocJpegStatus RocJpegVappiDecoder::InitializeDecoder(std::string device_name, st
         INFO("WARNING: didn't find the vcn jpeg spec for " + gcn_arch_name_base_temp + " using the default setting");
         current_vcn_jpeg_spec_.num_jpeg_cores = 1;
     }
-    vaapi_mem_pool_->SetPoolSize(current_vcn_jpeg_spec_.num_jpeg_cores + 1);
+    // The pool holds individual surfaces: enough for the two groups of one stream per JPEG core that a pipelined
+    // batched decode can hold at a time, plus one.
+    vaapi_mem_pool_->SetPoolSize(2 * current_vcn_jpeg_spec_.num_jpeg_cores + 1);
 
     return ROCJPEG_STATUS_SUCCESS;
 }
@@ -523,35 +662,182 @@ RocJpegStatus RocJpegVappiDecoder::CreateDecoderContext() {
 /**
  * @brief Destroys the data buffers used by the RocJpegVappiDecoder.
  *
- * This function destroys the data buffers used by the RocJpegVappiDecoder, including the picture parameter buffer,
- * quantization matrix buffer, Huffman table buffer, slice parameter buffer, and slice data buffer.
+ * This function destroys the picture parameter, quantization matrix, Huffman table, slice parameter, and slice data
+ * buffers of every slot of the ring of VAAPI buffers.
  *
  * @return The status of the operation. Returns ROCJPEG_STATUS_SUCCESS if the data buffers were successfully destroyed.
  */
 RocJpegStatus RocJpegVappiDecoder::DestroyDataBuffers() {
-    if (va_picture_parameter_buf_id_) {
-        CHECK_VAAPI(vaDestroyBuffer(va_display_, va_picture_parameter_buf_id_));
-        va_picture_parameter_buf_id_ = 0;
+    for (auto &slot : va_buffer_ring_) {
+        for (VABufferID *buf_id : {&slot.picture_parameter_buf_id, &slot.quantization_matrix_buf_id, &slot.huffmantable_buf_id,
+                                   &slot.slice_param_buf_id, &slot.slice_data_buf_id}) {
+            if (*buf_id) {
+                CHECK_VAAPI(vaDestroyBuffer(va_display_, *buf_id));
+                *buf_id = 0;
+            }
+        }
+        slot.slice_data_capacity = 0;
     }
-    if (va_quantization_matrix_buf_id_) {
-        CHECK_VAAPI(vaDestroyBuffer(va_display_, va_quantization_matrix_buf_id_));
-        va_quantization_matrix_buf_id_ = 0;
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Writes data into a VAAPI buffer.
+ *
+ * The buffer is mapped, the data is copied into it, and the buffer is unmapped, so a persistent buffer can be reused
+ * for every submission instead of being destroyed and created again.
+ *
+ * @param buf_id The VAAPI buffer ID.
+ * @param data The data to write.
+ * @param size The size of the data in bytes.
+ * @return The status of the operation.
+ */
+RocJpegStatus RocJpegVappiDecoder::WriteBuffer(VABufferID buf_id, const void *data, size_t size) {
+    void *mapped_data = nullptr;
+    CHECK_VAAPI(vaMapBuffer(va_display_, buf_id, &mapped_data));
+    std::memcpy(mapped_data, data, size);
+    CHECK_VAAPI(vaUnmapBuffer(va_display_, buf_id));
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Writes the entropy-coded data of a JPEG stream into the slice data buffer of a ring slot.
+ *
+ * The slice data buffer of the slot is only recreated when the data does not fit in it, rounded up to 64 KiB, so
+ * its size follows the high-water mark of the streams submitted through the slot. The data is copied in place into
+ * the mapped buffer, which is the same single copy that vaCreateBuffer makes. If the data is scattered over several
+ * segments (see rocJpegStreamParseV), the segments are copied one after the other.
+ *
+ * @param slot The ring slot.
+ * @param jpeg_stream_params The parameters of the JPEG stream.
+ * @return The status of the operation.
+ */
+RocJpegStatus RocJpegVappiDecoder::WriteSliceDataBuffer(VaBufferRingSlot &slot, const JpegStreamParameters *jpeg_stream_params) {
+    uint32_t slice_data_size = jpeg_stream_params->slice_parameter_buffer.slice_data_size;
+    if (slot.slice_data_buf_id == 0 || slice_data_size > slot.slice_data_capacity) {
+        if (slot.slice_data_buf_id) {
+            CHECK_VAAPI(vaDestroyBuffer(va_display_, slot.slice_data_buf_id));
+            slot.slice_data_buf_id = 0;
+            slot.slice_data_capacity = 0;
+        }
+        uint32_t slice_data_capacity = (slice_data_size + 0xFFFF) & ~0xFFFFu;
+        CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VASliceDataBufferType, slice_data_capacity, 1, nullptr, &slot.slice_data_buf_id));
+        slot.slice_data_capacity = slice_data_capacity;
     }
-    if (va_huffmantable_buf_id_) {
-        CHECK_VAAPI(vaDestroyBuffer(va_display_, va_huffmantable_buf_id_));
-        va_huffmantable_buf_id_ = 0;
+    uint8_t *slice_data = nullptr;
+    CHECK_VAAPI(vaMapBuffer(va_display_, slot.slice_data_buf_id, (void **)&slice_data));
+    if (jpeg_stream_params->slice_data_segments == nullptr) {
+        std::memcpy(slice_data, jpeg_stream_params->slice_data_buffer, slice_data_size);
+    } else {
+        for (uint32_t i = 0; i < jpeg_stream_params->num_slice_data_segments; i++) {
+            const JpegDataSegment &segment = jpeg_stream_params->slice_data_segments[i];
+            std::memcpy(slice_data, segment.data, segment.size);
+            slice_data += segment.size;
+        }
     }
-    if (va_slice_param_buf_id_) {
-        CHECK_VAAPI(vaDestroyBuffer(va_display_, va_slice_param_buf_id_));
-        va_slice_param_buf_id_ = 0;
+    CHECK_VAAPI(vaUnmapBuffer(va_display_, slot.slice_data_buf_id));
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Submits a JPEG stream to the hardware decoder using the next slot of the ring of VAAPI buffers.
+ *
+ * The ring has one slot per JPEG core, so the buffers of a stream are not rewritten until as many other streams have
+ * been submitted as there are cores. The buffers of a slot are created the first time it is used and are then
+ * rewritten in place, and the five buffers are rendered with a single vaRenderPicture call.
+ *
+ * @param jpeg_stream_params The parameters of the JPEG stream, for which FillPictureParameterBuffer has been called.
+ * @param surface_id The ID of the output surface.
+ * @return The status of the submission.
+ */
+RocJpegStatus RocJpegVappiDecoder::SubmitPicture(const JpegStreamParameters *jpeg_stream_params, VASurfaceID surface_id) {
+    if (va_buffer_ring_.empty()) {
+        va_buffer_ring_.resize(std::max(current_vcn_jpeg_spec_.num_jpeg_cores, 2u), VaBufferRingSlot{});
     }
-    if (va_slice_data_buf_id_) {
-        CHECK_VAAPI(vaDestroyBuffer(va_display_, va_slice_data_buf_id_));
-        va_slice_data_buf_id_ = 0;
+    VaBufferRingSlot &slot = va_buffer_ring_[va_buffer_ring_index_];
+    va_buffer_ring_index_ = (va_buffer_ring_index_ + 1) % va_buffer_ring_.size();
+    if (slot.picture_parameter_buf_id == 0) {
+        CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VAPictureParameterBufferType, sizeof(VAPictureParameterBufferJPEGBaseline), 1, nullptr, &slot.picture_parameter_buf_id));
+        CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VAIQMatrixBufferType, sizeof(VAIQMatrixBufferJPEGBaseline), 1, nullptr, &slot.quantization_matrix_buf_id));
+        CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VAHuffmanTableBufferType, sizeof(VAHuffmanTableBufferJPEGBaseline), 1, nullptr, &slot.huffmantable_buf_id));
+        CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VASliceParameterBufferType, sizeof(VASliceParameterBufferJPEGBaseline), 1, nullptr, &slot.slice_param_buf_id));
     }
+    CHECK_ROCJPEG(WriteBuffer(slot.picture_parameter_buf_id, &picture_parameter_buffer_, sizeof(VAPictureParameterBufferJPEGBaseline)));
+    CHECK_ROCJPEG(WriteBuffer(slot.quantization_matrix_buf_id, jpeg_stream_params->quantization_matrix_buffer, sizeof(VAIQMatrixBufferJPEGBaseline)));
+    CHECK_ROCJPEG(WriteBuffer(slot.huffmantable_buf_id, jpeg_stream_params->huffman_table_buffer, sizeof(VAHuffmanTableBufferJPEGBaseline)));
+    CHECK_ROCJPEG(WriteBuffer(slot.slice_param_buf_id, &jpeg_stream_params->slice_parameter_buffer, sizeof(VASliceParameterBufferJPEGBaseline)));
+    CHECK_ROCJPEG(WriteSliceDataBuffer(slot, jpeg_stream_params));
+
+    VABufferID buf_ids[] = {slot.picture_parameter_buf_id, slot.quantization_matrix_buf_id, slot.huffmantable_buf_id,
+                            slot.slice_param_buf_id, slot.slice_data_buf_id};
+    CHECK_VAAPI(vaBeginPicture(va_display_, va_context_id_, surface_id));
+    CHECK_VAAPI(vaRenderPicture(va_display_, va_context_id_, buf_ids, sizeof(buf_ids) / sizeof(buf_ids[0])));
+    CHECK_VAAPI(vaEndPicture(va_display_, va_context_id_));
     return ROCJPEG_STATUS_SUCCESS;
 }
 
+/**
+ * @brief Computes the size class of the surfaces that can hold a picture.
+ *
+ * Allocating the surfaces in size classes instead of at the exact size of each picture lets a dataset of mixed
+ * resolutions reuse the surfaces of the memory pool. The hardware decodes the picture into the top-left region of
+ * the surface, and the post-processing uses the dimensions of the picture, not those of the surface.
+ *
+ * @param picture_width The width of the picture.
+ * @param picture_height The height of the picture.
+ * @param surface_width [out] The width of the surfaces of the size class.
+ * @param surface_height [out] The height of the surfaces of the size class.
+ */
+void RocJpegVappiDecoder::GetSurfaceSizeClass(uint32_t picture_width, uint32_t picture_height, uint32_t &surface_width, uint32_t &surface_height) const {
+    surface_width = std::min((picture_width + kSurfaceSizeClassStep - 1) / kSurfaceSizeClassStep * kSurfaceSizeClassStep, std::max(max_picture_width_, picture_width));
+    surface_height = std::min((picture_height + kSurfaceSizeClassStep - 1) / kSurfaceSizeClassStep * kSurfaceSizeClassStep, std::max(max_picture_height_, picture_height));
+}
+
+/**
+ * @brief Fills the staging picture parameter buffer for the submission of a JPEG stream.
+ *
+ * The compact picture parameters of the stream are expanded into the VA-API picture parameter buffer, which is reused
+ * for every submission. The components past the ones of the stream are cleared, and if the HW JPEG decoder has a
+ * built-in ROI-decode capability, the requested crop rectangle is filled in (or cleared if it is not valid).
+ *
+ * @param jpeg_stream_params The parameters of the JPEG stream.
+ * @param decode_params The decode parameters.
+ */
+void RocJpegVappiDecoder::FillPictureParameterBuffer(const JpegStreamParameters *jpeg_stream_params, const RocJpegDecodeParams *decode_params) {
+    const JpegPictureParameters &picture_params = jpeg_stream_params->picture_parameters;
+    picture_parameter_buffer_.picture_width = picture_params.picture_width;
+    picture_parameter_buffer_.picture_height = picture_params.picture_height;
+    picture_parameter_buffer_.num_components = picture_params.num_components;
+    for (int i = 0; i < NUM_COMPONENTS; i++) {
+        picture_parameter_buffer_.components[i].component_id = picture_params.components[i].component_id;
+        picture_parameter_buffer_.components[i].h_sampling_factor = picture_params.components[i].h_sampling_factor;
+        picture_parameter_buffer_.components[i].v_sampling_factor = picture_params.components[i].v_sampling_factor;
+        picture_parameter_buffer_.components[i].quantiser_table_selector = picture_params.components[i].quantiser_table_selector;
+    }
+
+    if (!current_vcn_jpeg_spec_.can_roi_decode) {
+        return;
+    }
+    uint32_t roi_width;
+    uint32_t roi_height;
+    roi_width = decode_params->crop_rectangle.right - decode_params->crop_rectangle.left;
+    roi_height = decode_params->crop_rectangle.bottom - decode_params->crop_rectangle.top;
+    if (roi_width == 0 || roi_height == 0 || roi_width > picture_params.picture_width || roi_height > picture_params.picture_height) {
+        roi_width = 0;
+        roi_height = 0;
+    }
+    VAPictureParameterBufferJPEGBaseline *va_picture_parameter_buffer = reinterpret_cast<VAPictureParameterBufferJPEGBaseline*>(&picture_parameter_buffer_);
+#if VA_CHECK_VERSION(1, 21, 0)
+    va_picture_parameter_buffer->crop_rectangle.x = roi_width ? decode_params->crop_rectangle.left : 0;
+    va_picture_parameter_buffer->crop_rectangle.y = roi_width ? decode_params->crop_rectangle.top : 0;
+    va_picture_parameter_buffer->crop_rectangle.width = roi_width;
+    va_picture_parameter_buffer->crop_rectangle.height = roi_height;
+#else
+    va_picture_parameter_buffer->va_reserved[0] = roi_width ? (decode_params->crop_rectangle.top << 16 | decode_params->crop_rectangle.left) : 0;
+    va_picture_parameter_buffer->va_reserved[1] = roi_height << 16 | roi_width;
+#endif
+}
+
 /**
  * @brief Submits a JPEG decode operation to the VAAPI decoder.
  *
@@ -562,27 +848,29 @@ RocJpegStatus RocJpegVappiDecoder::DestroyDataBuffers() {
  * @param jpeg_stream_params The JPEG stream parameters for the decode operation.
  * @param surface_id [out] The ID of the output surface where the decoded image will be stored.
  * @param decode_params Additional parameters for the decode operation.
+ * @param enforce_memory_budget Whether to fail instead of allocating a surface that exceeds the memory budget.
  * @return The status of the decode operation.
  *         - ROCJPEG_STATUS_SUCCESS if the decode operation was successful.
  *         - ROCJPEG_STATUS_INVALID_PARAMETER if the provided parameters are invalid.
  *         - ROCJPEG_STATUS_JPEG_NOT_SUPPORTED if the JPEG image resolution or chroma subsampling is not supported.
+ *         - ROCJPEG_STATUS_NOT_READY if the budget is enforced and a new surface does not fit in it.
  */
-RocJpegStatus RocJpegVappiDecoder::SubmitDecode(const JpegStreamParameters *jpeg_stream_params, uint32_t &surface_id, const RocJpegDecodeParams *decode_params) {
+RocJpegStatus RocJpegVappiDecoder::SubmitDecode(const JpegStreamParameters *jpeg_stream_params, uint32_t &surface_id, const RocJpegDecodeParams *decode_params, bool enforce_memory_budget) {
     if (jpeg_stream_params == nullptr || decode_params == nullptr) {
         return ROCJPEG_STATUS_INVALID_PARAMETER;
     }
 
-    if (sizeof(jpeg_stream_params->picture_parameter_buffer) != sizeof(VAPictureParameterBufferJPEGBaseline) ||
-        sizeof(jpeg_stream_params->quantization_matrix_buffer) != sizeof(VAIQMatrixBufferJPEGBaseline) ||
-        sizeof(jpeg_stream_params->huffman_table_buffer) != sizeof(VAHuffmanTableBufferJPEGBaseline) ||
+    if (sizeof(picture_parameter_buffer_) != sizeof(VAPictureParameterBufferJPEGBaseline) ||
+        sizeof(*jpeg_stream_params->quantization_matrix_buffer) != sizeof(VAIQMatrixBufferJPEGBaseline) ||
+        sizeof(*jpeg_stream_params->huffman_table_buffer) != sizeof(VAHuffmanTableBufferJPEGBaseline) ||
         sizeof(jpeg_stream_params->slice_parameter_buffer) != sizeof(VASliceParameterBufferJPEGBaseline)) {
         return ROCJPEG_STATUS_INVALID_PARAMETER;
     }
 
-    if (jpeg_stream_params->picture_parameter_buffer.picture_width < min_picture_width_ ||
-        jpeg_stream_params->picture_parameter_buffer.picture_height < min_picture_height_ ||
-        jpeg_stream_params->picture_parameter_buffer.picture_width > max_picture_width_ ||
-        jpeg_stream_params->picture_parameter_buffer.picture_height > max_picture_height_) {
+    if (jpeg_stream_params->picture_parameters.picture_width < min_picture_width_ ||
+        jpeg_stream_params->picture_parameters.picture_height < min_picture_height_ ||
+        jpeg_stream_params->picture_parameters.picture_width > max_picture_width_ ||
+        jpeg_stream_params->picture_parameters.picture_height > max_picture_height_) {
             ERR("The JPEG image resolution is not supported!");
             return ROCJPEG_STATUS_JPEG_NOT_SUPPORTED;
         }
@@ -648,122 +936,130 @@ RocJpegStatus RocJpegVappiDecoder::SubmitDecode(const JpegStreamParameters *jpeg
         surface_attribs.push_back(surface_attrib);
     }
 
-    // if the HW JPEG decoder has a built-in ROI-decode capability then fill the requested crop rectangle to the picture parameter buffer
-    void *picture_parameter_buffer = (void*)&jpeg_stream_params->picture_parameter_buffer;
-    if (current_vcn_jpeg_spec_.can_roi_decode) {
-        uint32_t roi_width;
-        uint32_t roi_height;
-        roi_width = decode_params->crop_rectangle.right - decode_params->crop_rectangle.left;
-        roi_height = decode_params->crop_rectangle.bottom - decode_params->crop_rectangle.top;
-        if (roi_width > 0 && roi_height > 0 && roi_width <= jpeg_stream_params->picture_parameter_buffer.picture_width && roi_height <= jpeg_stream_params->picture_parameter_buffer.picture_height) {
-#if VA_CHECK_VERSION(1, 21, 0)
-            reinterpret_cast<VAPictureParameterBufferJPEGBaseline*>(picture_parameter_buffer)->crop_rectangle.x = decode_params->crop_rectangle.left;
-            reinterpret_cast<VAPictureParameterBufferJPEGBaseline*>(picture_parameter_buffer)->crop_rectangle.y = decode_params->crop_rectangle.top;
-            reinterpret_cast<VAPictureParameterBufferJPEGBaseline*>(picture_parameter_buffer)->crop_rectangle.width = roi_width;
-            reinterpret_cast<VAPictureParameterBufferJPEGBaseline*>(picture_parameter_buffer)->crop_rectangle.height = roi_height;
-#else
-            reinterpret_cast<VAPictureParameterBufferJPEGBaseline*>(picture_parameter_buffer)->va_reserved[0] = decode_params->crop_rectangle.top << 16 | decode_params->crop_rectangle.left;
-            reinterpret_cast<VAPictureParameterBufferJPEGBaseline*>(picture_parameter_buffer)->va_reserved[1] = roi_height << 16 | roi_width;
-#endif
+    uint32_t surface_width, surface_height;
+    GetSurfaceSizeClass(jpeg_stream_params->picture_parameters.picture_width, jpeg_stream_params->picture_parameters.picture_height, surface_width, surface_height);
+    const RocJpegVaapiMemPoolEntry *idle_entry = vaapi_mem_pool_->GetEntry(surface_pixel_format, surface_width, surface_height);
+    if (idle_entry == nullptr) {
+        if (!vaapi_mem_pool_->ReserveMemory(surface_pixel_format, surface_width, surface_height, 1) && enforce_memory_budget) {
+            return ROCJPEG_STATUS_NOT_READY;
         }
-    }
-
-    RocJpegVaapiMemPoolEntry mem_pool_entry = vaapi_mem_pool_->GetEntry(surface_pixel_format, jpeg_stream_params->picture_parameter_buffer.picture_width, jpeg_stream_params->picture_parameter_buffer.picture_height, 1);
-    if (mem_pool_entry.va_surface_ids.empty()) {
-        mem_pool_entry.va_surface_ids.resize(1);
-        CHECK_VAAPI(vaCreateSurfaces(va_display_, surface_format, jpeg_stream_params->picture_parameter_buffer.picture_width, jpeg_stream_params->picture_parameter_buffer.picture_height, mem_pool_entry.va_surface_ids.data(), 1, surface_attribs.data(), surface_attribs.size()));
-        mem_pool_entry.image_width = jpeg_stream_params->picture_parameter_buffer.picture_width;
-        mem_pool_entry.image_height = jpeg_stream_params->picture_parameter_buffer.picture_height;
-        mem_pool_entry.hip_interops.resize(1);
-        surface_id = mem_pool_entry.va_surface_ids[0];
+        RocJpegVaapiMemPoolEntry mem_pool_entry = {};
+        CHECK_VAAPI(vaCreateSurfaces(va_display_, surface_format, surface_width, surface_height, &mem_pool_entry.va_surface_id, 1, surface_attribs.data(), surface_attribs.size()));
+        mem_pool_entry.image_width = surface_width;
+        mem_pool_entry.image_height = surface_height;
+        surface_id = mem_pool_entry.va_surface_id;
         mem_pool_entry.entry_status = kBusy;
         CHECK_ROCJPEG(vaapi_mem_pool_->AddPoolEntry(surface_pixel_format, mem_pool_entry));
     } else {
-        surface_id = mem_pool_entry.va_surface_ids[0];
+        surface_id = idle_entry->va_surface_id;
     }
 
-    CHECK_ROCJPEG(DestroyDataBuffers());
+    FillPictureParameterBuffer(jpeg_stream_params, decode_params);
+    CHECK_ROCJPEG(SubmitPicture(jpeg_stream_params, surface_id));
 
-    CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VAPictureParameterBufferType, sizeof(VAPictureParameterBufferJPEGBaseline), 1, picture_parameter_buffer, &va_picture_parameter_buf_id_));
-    CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VAIQMatrixBufferType, sizeof(VAIQMatrixBufferJPEGBaseline), 1, (void *)&jpeg_stream_params->quantization_matrix_buffer, &va_quantization_matrix_buf_id_));
-    CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VAHuffmanTableBufferType, sizeof(VAHuffmanTableBufferJPEGBaseline), 1, (void *)&jpeg_stream_params->huffman_table_buffer, &va_huffmantable_buf_id_));
-    CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VASliceParameterBufferType, sizeof(VASliceParameterBufferJPEGBaseline), 1, (void *)&jpeg_stream_params->slice_parameter_buffer, &va_slice_param_buf_id_));
-    CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VASliceDataBufferType, jpeg_stream_params->slice_parameter_buffer.slice_data_size, 1, (void *)jpeg_stream_params->slice_data_buffer, &va_slice_data_buf_id_));
+    return ROCJPEG_STATUS_SUCCESS;
+}
 
-    CHECK_VAAPI(vaBeginPicture(va_display_, va_context_id_,  surface_id));
-    CHECK_VAAPI(vaRenderPicture(va_display_, va_context_id_, &va_picture_parameter_buf_id_, 1));
-    CHECK_VAAPI(vaRenderPicture(va_display_, va_context_id_, &va_quantization_matrix_buf_id_, 1));
-    CHECK_VAAPI(vaRenderPicture(va_display_, va_context_id_, &va_huffmantable_buf_id_, 1));
-    CHECK_VAAPI(vaRenderPicture(va_display_, va_context_id_, &va_slice_param_buf_id_, 1));
-    CHECK_VAAPI(vaRenderPicture(va_display_, va_context_id_, &va_slice_data_buf_id_, 1));
-    CHECK_VAAPI(vaEndPicture(va_display_, va_context_id_));
+/**
+ * @brief Checks that a batch of JPEG streams can be decoded by the VCN hardware, without submitting them.
+ *
+ * @param jpeg_streams_params An array of pointers to the parameters of the JPEG streams.
+ * @param batch_size The number of JPEG streams in the batch.
+ * @param decode_params The decoding parameters.
+ * @return ROCJPEG_STATUS_SUCCESS if all the streams are supported, or the error SubmitDecodeBatched would return
+ *         for the first stream that is not.
+ */
+RocJpegStatus RocJpegVappiDecoder::CheckJpegStreamsSupported(const JpegStreamParameters * const *jpeg_streams_params, int batch_size, const RocJpegDecodeParams *decode_params) {
+    if (jpeg_streams_params == nullptr || decode_params == nullptr) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    for (int i = 0; i < batch_size; i++) {
+        JpegStreamKey jpeg_stream_key = {};
+        CHECK_ROCJPEG(GetJpegStreamKey(jpeg_streams_params[i], decode_params, jpeg_stream_key));
+    }
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Computes the surface format, pixel format, and surface size class of a JPEG stream.
+ *
+ * @param jpeg_stream_params The parameters of the JPEG stream.
+ * @param decode_params The decoding parameters.
+ * @param jpeg_stream_key [out] The key of the surfaces the stream is decoded into.
+ * @return ROCJPEG_STATUS_SUCCESS, or ROCJPEG_STATUS_JPEG_NOT_SUPPORTED if the resolution or the chroma subsampling
+ *         of the stream is not supported by the VCN hardware.
+ */
+RocJpegStatus RocJpegVappiDecoder::GetJpegStreamKey(const JpegStreamParameters *jpeg_stream_params, const RocJpegDecodeParams *decode_params, JpegStreamKey &jpeg_stream_key) {
+    if (sizeof(picture_parameter_buffer_) != sizeof(VAPictureParameterBufferJPEGBaseline) ||
+        sizeof(*jpeg_stream_params->quantization_matrix_buffer) != sizeof(VAIQMatrixBufferJPEGBaseline) ||
+        sizeof(*jpeg_stream_params->huffman_table_buffer) != sizeof(VAHuffmanTableBufferJPEGBaseline) ||
+        sizeof(jpeg_stream_params->slice_parameter_buffer) != sizeof(VASliceParameterBufferJPEGBaseline)) {
+        return ROCJPEG_STATUS_INVALID_PARAMETER;
+    }
+    uint32_t picture_width = jpeg_stream_params->picture_parameters.picture_width;
+    uint32_t picture_height = jpeg_stream_params->picture_parameters.picture_height;
+    if (picture_width < min_picture_width_ ||
+        picture_height < min_picture_height_ ||
+        picture_width > max_picture_width_ ||
+        picture_height > max_picture_height_) {
+            ERR("The JPEG image resolution is not supported!");
+            return ROCJPEG_STATUS_JPEG_NOT_SUPPORTED;
+        }
+    GetSurfaceSizeClass(picture_width, picture_height, jpeg_stream_key.width, jpeg_stream_key.height);
 
+    if ((decode_params->output_format == ROCJPEG_OUTPUT_RGB || decode_params->output_format == ROCJPEG_OUTPUT_RGB_PLANAR) && current_vcn_jpeg_spec_.can_convert_to_rgb && jpeg_stream_params->chroma_subsampling != CSS_440) {
+        if (decode_params->output_format == ROCJPEG_OUTPUT_RGB) {
+            jpeg_stream_key.surface_format = VA_RT_FORMAT_RGB32;
+            jpeg_stream_key.pixel_format = VA_FOURCC_RGBA;
+        } else if (decode_params->output_format == ROCJPEG_OUTPUT_RGB_PLANAR) {
+            jpeg_stream_key.surface_format = VA_RT_FORMAT_RGBP;
+            jpeg_stream_key.pixel_format = VA_FOURCC_RGBP;
+        }
+    } else {
+        switch (jpeg_stream_params->chroma_subsampling) {
+            case CSS_444:
+                jpeg_stream_key.surface_format = VA_RT_FORMAT_YUV444;
+                jpeg_stream_key.pixel_format = VA_FOURCC_444P;
+                break;
+            case CSS_440:
+                jpeg_stream_key.surface_format = VA_RT_FORMAT_YUV422;
+                jpeg_stream_key.pixel_format = VA_FOURCC_422V;
+                break;
+            case CSS_422:
+                jpeg_stream_key.surface_format = VA_RT_FORMAT_YUV422;
+                jpeg_stream_key.pixel_format = VA_FOURCC_YUY2;
+                break;
+            case CSS_420:
+                jpeg_stream_key.surface_format = VA_RT_FORMAT_YUV420;
+                jpeg_stream_key.pixel_format = VA_FOURCC_NV12;
+                break;
+            case CSS_400:
+                jpeg_stream_key.surface_format = VA_RT_FORMAT_YUV400;
+                jpeg_stream_key.pixel_format = VA_FOURCC_Y800;
+                break;
+            default:
+                ERR("ERROR: The chroma subsampling is not supported by the VCN hardware!");
+                return ROCJPEG_STATUS_JPEG_NOT_SUPPORTED;
+                break;
+        }
+    }
     return ROCJPEG_STATUS_SUCCESS;
 }
 
-RocJpegStatus RocJpegVappiDecoder::SubmitDecodeBatched(JpegStreamParameters *jpeg_streams_params, int batch_size, const RocJpegDecodeParams *decode_params, uint32_t *surface_ids) {
+RocJpegStatus RocJpegVappiDecoder::SubmitDecodeBatched(const JpegStreamParameters * const *jpeg_streams_params, int batch_size, const RocJpegDecodeParams *decode_params, uint32_t *surface_ids, bool enforce_memory_budget) {
     if (jpeg_streams_params == nullptr || decode_params == nullptr || surface_ids == nullptr) {
         return ROCJPEG_STATUS_INVALID_PARAMETER;
     }
+    // The streams without a surface are marked, so the caller knows which surfaces to release if this fails.
+    std::fill(surface_ids, surface_ids + batch_size, VA_INVALID_SURFACE);
 
     // Group the JPEG streams in the jpeg_streams_params array based on their chroma subsampling, width, and height.
     // Store the groups in an unordered map, where the key is a JpegStreamKey struct and the value is a vector of integers
     // representing the indices of the JPEG streams in the batch.
     std::unordered_map<JpegStreamKey, std::vector<int>> jpeg_stream_groups;
     for (int i = 0; i < batch_size; i++) {
-        if (sizeof(jpeg_streams_params[i].picture_parameter_buffer) != sizeof(VAPictureParameterBufferJPEGBaseline) ||
-            sizeof(jpeg_streams_params[i].quantization_matrix_buffer) != sizeof(VAIQMatrixBufferJPEGBaseline) ||
-            sizeof(jpeg_streams_params[i].huffman_table_buffer) != sizeof(VAHuffmanTableBufferJPEGBaseline) ||
-            sizeof(jpeg_streams_params[i].slice_parameter_buffer) != sizeof(VASliceParameterBufferJPEGBaseline)) {
-            return ROCJPEG_STATUS_INVALID_PARAMETER;
-        }
         JpegStreamKey jpeg_stream_key = {};
-        jpeg_stream_key.width = jpeg_streams_params[i].picture_parameter_buffer.picture_width;
-        jpeg_stream_key.height = jpeg_streams_params[i].picture_parameter_buffer.picture_height;
-        if (jpeg_stream_key.width < min_picture_width_ ||
-            jpeg_stream_key.height < min_picture_height_ ||
-            jpeg_stream_key.width > max_picture_width_ ||
-            jpeg_stream_key.height > max_picture_height_) {
-                ERR("The JPEG image resolution is not supported!");
-                return ROCJPEG_STATUS_JPEG_NOT_SUPPORTED;
-            }
-
-        if ((decode_params->output_format == ROCJPEG_OUTPUT_RGB || decode_params->output_format == ROCJPEG_OUTPUT_RGB_PLANAR) && current_vcn_jpeg_spec_.can_convert_to_rgb && jpeg_streams_params[i].chroma_subsampling != CSS_440) {
-            if (decode_params->output_format == ROCJPEG_OUTPUT_RGB) {
-                jpeg_stream_key.surface_format = VA_RT_FORMAT_RGB32;
-                jpeg_stream_key.pixel_format = VA_FOURCC_RGBA;
-            } else if (decode_params->output_format == ROCJPEG_OUTPUT_RGB_PLANAR) {
-                jpeg_stream_key.surface_format = VA_RT_FORMAT_RGBP;
-                jpeg_stream_key.pixel_format = VA_FOURCC_RGBP;
-            }
-        } else {
-            switch (jpeg_streams_params[i].chroma_subsampling) {
-                case CSS_444:
-                    jpeg_stream_key.surface_format = VA_RT_FORMAT_YUV444;
-                    jpeg_stream_key.pixel_format = VA_FOURCC_444P;
-                    break;
-                case CSS_440:
-                    jpeg_stream_key.surface_format = VA_RT_FORMAT_YUV422;
-                    jpeg_stream_key.pixel_format = VA_FOURCC_422V;
-                    break;
-                case CSS_422:
-                    jpeg_stream_key.surface_format = VA_RT_FORMAT_YUV422;
-                    jpeg_stream_key.pixel_format = VA_FOURCC_YUY2;
-                    break;
-                case CSS_420:
-                    jpeg_stream_key.surface_format = VA_RT_FORMAT_YUV420;
-                    jpeg_stream_key.pixel_format = VA_FOURCC_NV12;
-                    break;
-                case CSS_400:
-                    jpeg_stream_key.surface_format = VA_RT_FORMAT_YUV400;
-                    jpeg_stream_key.pixel_format = VA_FOURCC_Y800;
-                    break;
-                default:
-                    ERR("ERROR: The chroma subsampling is not supported by the VCN hardware!");
-                    return ROCJPEG_STATUS_JPEG_NOT_SUPPORTED;
-                    break;
-            }
-        }
+        CHECK_ROCJPEG(GetJpegStreamKey(jpeg_streams_params[i], decode_params, jpeg_stream_key));
         jpeg_stream_groups[jpeg_stream_key].push_back(i);
     }
 
@@ -785,74 +1081,64 @@ RocJpegStatus RocJpegVappiDecoder::SubmitDecodeBatched(JpegStreamParameters *jpe
         surface_attribs[1].value.value.p = &modifier_list;
     }
 
-    uint32_t roi_width;
-    uint32_t roi_height;
-    roi_width = decode_params->crop_rectangle.right - decode_params->crop_rectangle.left;
-    roi_height = decode_params->crop_rectangle.bottom - decode_params->crop_rectangle.top;
-
     // Iterate through all entries of jpeg_stream_groups.
-    // Check if there is a matching entry in the memory pool.
-    // If not, allocate surfaces and create a context for each group.
-    // Submit the JPEG streams to the hardware for decoding.
-    for (const auto& group : jpeg_stream_groups) {
-        const JpegStreamKey& key = group.first;
-        const std::vector<int>& indices = group.second;
+    // Take an idle surface of the memory pool for each stream of the group, whatever batch the surface was
+    // allocated for, and allocate the missing surfaces with a single call.
+    // The surfaces of all the groups are acquired before any stream is submitted, so that if the memory budget is
+    // enforced and exhausted, the surfaces acquired so far can be released and no stream is left decoding.
+    std::vector<VASurfaceID> new_surface_ids;
+    for (auto group = jpeg_stream_groups.begin(); group != jpeg_stream_groups.end(); ++group) {
+        const JpegStreamKey& key = group->first;
+        const std::vector<int>& indices = group->second;
 
         surface_format = key.surface_format;
         surface_attribs[0].value.value.i = key.pixel_format;
 
-        RocJpegVaapiMemPoolEntry mem_pool_entry = vaapi_mem_pool_->GetEntry(key.pixel_format, key.width, key.height, indices.size());
-        if (mem_pool_entry.va_surface_ids.empty()) {
-            mem_pool_entry.va_surface_ids.resize(indices.size());
-            CHECK_VAAPI(vaCreateSurfaces(va_display_, surface_format, key.width, key.height, mem_pool_entry.va_surface_ids.data(), mem_pool_entry.va_surface_ids.size(), surface_attribs.data(), supports_modifiers_ ? 2 : 1));
+        size_t num_reused_surfaces = 0;
+        for (; num_reused_surfaces < indices.size(); num_reused_surfaces++) {
+            const RocJpegVaapiMemPoolEntry *idle_entry = vaapi_mem_pool_->GetEntry(key.pixel_format, key.width, key.height);
+            if (idle_entry == nullptr) {
+                break;
+            }
+            surface_ids[indices[num_reused_surfaces]] = idle_entry->va_surface_id;
+        }
+        if (num_reused_surfaces < indices.size()) {
+            uint32_t num_new_surfaces = indices.size() - num_reused_surfaces;
+            if (!vaapi_mem_pool_->ReserveMemory(key.pixel_format, key.width, key.height, num_new_surfaces) && enforce_memory_budget) {
+                for (auto acquired = jpeg_stream_groups.begin(); acquired != group; ++acquired) {
+                    for (int idx : acquired->second) {
+                        vaapi_mem_pool_->SetSurfaceAsIdle(surface_ids[idx]);
+                        surface_ids[idx] = VA_INVALID_SURFACE;
+                    }
+                }
+                for (size_t i = 0; i < num_reused_surfaces; i++) {
+                    vaapi_mem_pool_->SetSurfaceAsIdle(surface_ids[indices[i]]);
+                    surface_ids[indices[i]] = VA_INVALID_SURFACE;
+                }
+                return ROCJPEG_STATUS_NOT_READY;
+            }
+            new_surface_ids.resize(num_new_surfaces);
+            CHECK_VAAPI(vaCreateSurfaces(va_display_, surface_format, key.width, key.height, new_surface_ids.data(), new_surface_ids.size(), surface_attribs.data(), supports_modifiers_ ? 2 : 1));
+            RocJpegVaapiMemPoolEntry mem_pool_entry = {};
             mem_pool_entry.image_width = key.width;
             mem_pool_entry.image_height = key.height;
-            for (int i = 0; i < mem_pool_entry.va_surface_ids.size(); i++) {
-                surface_ids[indices[i]] = mem_pool_entry.va_surface_ids[i];
-            }
-            mem_pool_entry.hip_interops.resize(indices.size());
             mem_pool_entry.entry_status = kBusy;
-            CHECK_ROCJPEG(vaapi_mem_pool_->AddPoolEntry(key.pixel_format, mem_pool_entry));
-        } else {
-            for (int i = 0; i < mem_pool_entry.va_surface_ids.size(); i++) {
-                surface_ids[indices[i]] = mem_pool_entry.va_surface_ids[i];
+            for (size_t i = 0; i < new_surface_ids.size(); i++) {
+                mem_pool_entry.va_surface_id = new_surface_ids[i];
+                surface_ids[indices[num_reused_surfaces + i]] = new_surface_ids[i];
+                CHECK_ROCJPEG(vaapi_mem_pool_->AddPoolEntry(key.pixel_format, mem_pool_entry));
             }
         }
+    }
 
-        for (int idx : indices) {
-            // if the HW JPEG decoder has a built-in ROI-decode capability then fill the requested crop rectangle to the picture parameter buffer
-            void* picture_parameter_buffer = &jpeg_streams_params[idx].picture_parameter_buffer;
-            if (current_vcn_jpeg_spec_.can_roi_decode && roi_width > 0 && roi_height > 0 &&
-                roi_width <= jpeg_streams_params[idx].picture_parameter_buffer.picture_width &&
-                roi_height <= jpeg_streams_params[idx].picture_parameter_buffer.picture_height) {
-#if VA_CHECK_VERSION(1, 21, 0)
-            reinterpret_cast<VAPictureParameterBufferJPEGBaseline*>(picture_parameter_buffer)->crop_rectangle.x = decode_params->crop_rectangle.left;
-            reinterpret_cast<VAPictureParameterBufferJPEGBaseline*>(picture_parameter_buffer)->crop_rectangle.y = decode_params->crop_rectangle.top;
-            reinterpret_cast<VAPictureParameterBufferJPEGBaseline*>(picture_parameter_buffer)->crop_rectangle.width = roi_width;
-            reinterpret_cast<VAPictureParameterBufferJPEGBaseline*>(picture_parameter_buffer)->crop_rectangle.height = roi_height;
-#else
-            reinterpret_cast<VAPictureParameterBufferJPEGBaseline*>(picture_parameter_buffer)->va_reserved[0] = decode_params->crop_rectangle.top << 16 | decode_params->crop_rectangle.left;
-            reinterpret_cast<VAPictureParameterBufferJPEGBaseline*>(picture_parameter_buffer)->va_reserved[1] = roi_height << 16 | roi_width;
-#endif
-            }
-            CHECK_ROCJPEG(DestroyDataBuffers());
-            CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VAPictureParameterBufferType, sizeof(VAPictureParameterBufferJPEGBaseline), 1, picture_parameter_buffer, &va_picture_parameter_buf_id_));
-            CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VAIQMatrixBufferType, sizeof(VAIQMatrixBufferJPEGBaseline), 1, (void *)&jpeg_streams_params[idx].quantization_matrix_buffer, &va_quantization_matrix_buf_id_));
-            CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VAHuffmanTableBufferType, sizeof(VAHuffmanTableBufferJPEGBaseline), 1, (void *)&jpeg_streams_params[idx].huffman_table_buffer, &va_huffmantable_buf_id_));
-            CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VASliceParameterBufferType, sizeof(VASliceParameterBufferJPEGBaseline), 1, (void *)&jpeg_streams_params[idx].slice_parameter_buffer, &va_slice_param_buf_id_));
-            CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VASliceDataBufferType, jpeg_streams_params[idx].slice_parameter_buffer.slice_data_size, 1, (void *)jpeg_streams_params[idx].slice_data_buffer, &va_slice_data_buf_id_));
-
-            CHECK_VAAPI(vaBeginPicture(va_display_, va_context_id_, surface_ids[idx]));
-            CHECK_VAAPI(vaRenderPicture(va_display_, va_context_id_, &va_picture_parameter_buf_id_, 1));
-            CHECK_VAAPI(vaRenderPicture(va_display_, va_context_id_, &va_quantization_matrix_buf_id_, 1));
-            CHECK_VAAPI(vaRenderPicture(va_display_, va_context_id_, &va_huffmantable_buf_id_, 1));
-            CHECK_VAAPI(vaRenderPicture(va_display_, va_context_id_, &va_slice_param_buf_id_, 1));
-            CHECK_VAAPI(vaRenderPicture(va_display_, va_context_id_, &va_slice_data_buf_id_, 1));
-            CHECK_VAAPI(vaEndPicture(va_display_, va_context_id_));
+    // Submit the JPEG streams to the hardware for decoding.
+    for (const auto& group : jpeg_stream_groups) {
+        for (int idx : group.second) {
+            FillPictureParameterBuffer(jpeg_streams_params[idx], decode_params);
+            CHECK_ROCJPEG(SubmitPicture(jpeg_streams_params[idx], surface_ids[idx]));
         }
     }
 
-
     return ROCJPEG_STATUS_SUCCESS;
 }
 
@@ -867,11 +1153,23 @@ RocJpegStatus RocJpegVappiDecoder::SubmitDecodeBatched(JpegStreamParameters *jpe
  * @return The status of the synchronization operation.
  */
 RocJpegStatus RocJpegVappiDecoder::SyncSurface(VASurfaceID surface_id) {
-    VASurfaceStatus surface_status;
     if (!vaapi_mem_pool_->FindSurfaceId(surface_id)) {
         return ROCJPEG_STATUS_INVALID_PARAMETER;
     }
+    return WaitSurface(surface_id);
+}
 
+/**
+ * @brief Waits until the specified VASurfaceID is ready, without looking it up in the memory pool.
+ *
+ * Unlike SyncSurface, this function does not access the memory pool, so it can be called without holding the lock
+ * of the decoder while another thread submits decodes.
+ *
+ * @param surface_id The VASurfaceID to wait for.
+ * @return The status of the synchronization operation.
+ */
+RocJpegStatus RocJpegVappiDecoder::WaitSurface(VASurfaceID surface_id) {
+    VASurfaceStatus surface_status;
     CHECK_VAAPI(vaQuerySurfaceStatus(va_display_, surface_id, &surface_status));
     while (surface_status != VASurfaceReady) {
         VAStatus va_status = vaSyncSurface(va_display_, surface_id);
@@ -890,6 +1188,20 @@ RocJpegStatus RocJpegVappiDecoder::SyncSurface(VASurfaceID surface_id) {
     return ROCJPEG_STATUS_SUCCESS;
 }
 
+/**
+ * @brief Checks whether the decoding of the specified VASurfaceID has completed, without blocking.
+ *
+ * @param surface_id The VASurfaceID to query.
+ * @param is_ready Set to true if the surface is ready.
+ * @return The status of the query.
+ */
+RocJpegStatus RocJpegVappiDecoder::QuerySurfaceReady(VASurfaceID surface_id, bool &is_ready) {
+    VASurfaceStatus surface_status;
+    CHECK_VAAPI(vaQuerySurfaceStatus(va_display_, surface_id, &surface_status));
+    is_ready = surface_status == VASurfaceReady;
+    return ROCJPEG_STATUS_SUCCESS;
+}
+
 /**
  * @brief Retrieves the HipInteropDeviceMem associated with the specified VASurfaceID.
  *
@@ -39,8 +39,12 @@ THE SOFTWARE.
     namespace fs = std::experimental::filesystem;
 #endif
 #include <unordered_map>
+#include <list>
+#include <deque>
 #include <memory>
 #include <functional>
+#include <chrono>
+#include <algorithm>
 #include <va/va.h>
 #include <va/va_drm.h>
 #include <va/va_drmcommon.h>
@@ -91,6 +95,21 @@ struct HipInteropDeviceMem {
     uint32_t num_layers; /**< Number of layers making up the surface */
 };
 
+/**
+ * @brief Structure representing a slot of the ring of persistent VA buffers used to submit the JPEG streams.
+ *
+ * The buffers are created once and rewritten in place for each submission. The slice data buffer is recreated only
+ * when a stream has more entropy-coded data than it can hold, so its size follows the high-water mark of the slot.
+ */
+typedef struct {
+    VABufferID picture_parameter_buf_id; /**< The VAAPI picture parameter buffer ID. */
+    VABufferID quantization_matrix_buf_id; /**< The VAAPI quantization matrix buffer ID. */
+    VABufferID huffmantable_buf_id; /**< The VAAPI Huffman table buffer ID. */
+    VABufferID slice_param_buf_id; /**< The VAAPI slice parameter buffer ID. */
+    VABufferID slice_data_buf_id; /**< The VAAPI slice data buffer ID. */
+    uint32_t slice_data_capacity; /**< The size of the slice data buffer in bytes. */
+} VaBufferRingSlot;
+
 /**
  * @brief Defines the enumeration MemPoolEntryStatus.
  */
@@ -104,15 +123,45 @@ typedef enum {
  * @brief Structure representing an entry in the RocJpegVaapiMemPool.
  *
  * This structure holds information about a memory pool entry used by the RocJpegVaapiDecoder.
- * It contains the image width and height, the entry status, an array of VA surface IDs,
- * and an array of HipInteropDeviceMem objects.
+ * Each entry holds a single surface, so the surfaces of a batch can be assembled from any idle entries of the
+ * right format and size. It contains the width and height of the surface, the entry status, the VA surface ID,
+ * and its HipInteropDeviceMem object.
  */
 struct RocJpegVaapiMemPoolEntry {
     uint32_t image_width;
     uint32_t image_height;
     MemPoolEntryStatus entry_status;
-    std::vector<VASurfaceID> va_surface_ids;
-    std::vector<HipInteropDeviceMem> hip_interops;
+    VASurfaceID va_surface_id;
+    HipInteropDeviceMem hip_interop;
+    uint32_t surface_format; // The pixel format of the surface, set when the entry is added to the pool.
+    uint64_t release_sequence; // The order in which the entry became idle, to delete the least recently used one.
+    std::chrono::steady_clock::time_point release_time; // The time at which the entry became idle.
+    size_t size_in_bytes; // The memory held by the surface, estimated until it is exported to HIP.
+};
+
+/**
+ * @brief Structure representing the key of the idle entries of the memory pool that can be reused for a decode.
+ */
+struct MemPoolKey {
+    uint32_t surface_format; /**< The pixel format of the surface. */
+    uint32_t image_width; /**< The width of the surface. */
+    uint32_t image_height; /**< The height of the surface. */
+
+    bool operator==(const MemPoolKey& other) const {
+        return surface_format == other.surface_format && image_width == other.image_width && image_height == other.image_height;
+    }
+};
+
+/**
+ * @brief Specialization of the std::hash template for MemPoolKey.
+ */
+template <>
+struct std::hash<MemPoolKey> {
+    std::size_t operator()(const MemPoolKey& k) const {
+        uint64_t result = (static_cast<uint64_t>(k.image_width) << 32 | k.image_height) * 0x9E3779B97F4A7C15ull;
+        result ^= k.surface_format + (result >> 29);
+        return static_cast<std::size_t>(result);
+    }
 };
 
 /**
@@ -122,6 +171,15 @@ struct RocJpegVaapiMemPoolEntry {
  * The RocJpegVaapiMemoryPool class provides methods to manage and allocate memory resources for VAAPI surfaces.
  * It allows setting the pool size, associating a VADisplay, finding surface IDs, getting pool entries, adding pool entries,
  * and retrieving HipInterop memory for a specific surface ID.
+ *
+ * The pool manages individual surfaces: each entry holds one surface, and a batch takes as many idle entries as it
+ * has streams of a given format and size. The surfaces are indexed by ID, and the idle entries are kept in a list per
+ * format and size, so acquiring and releasing an entry and looking a surface up take constant time regardless of the
+ * pool size.
+ *
+ * The pool is bounded by a number of surfaces and, optionally, by the memory they hold; the least recently used idle
+ * surfaces are deleted to stay within both limits, and, if an idle timeout is set, the surfaces that stay idle longer
+ * than the timeout are deleted by ReleaseExpiredEntries.
  */
 class RocJpegVaapiMemoryPool {
     public:
@@ -141,6 +199,33 @@ class RocJpegVaapiMemoryPool {
          */
         void SetPoolSize(uint32_t max_pool_size);
 
+        /**
+         * @brief Sets the memory limits of the memory pool, and deletes idle entries to fit in the new budget.
+         * @param max_pool_bytes The maximum memory held by the surfaces of the pool in bytes, or 0 for no limit.
+         * @param idle_timeout_ms The time after which an idle surface is deleted in milliseconds, or 0 to keep idle surfaces.
+         */
+        void SetMemoryLimits(size_t max_pool_bytes, uint32_t idle_timeout_ms);
+
+        /**
+         * @brief Makes room in the memory budget for new surfaces, deleting the least recently used idle entries.
+         * @param surface_format The pixel format of the new surfaces.
+         * @param image_width The width of the new surfaces.
+         * @param image_height The height of the new surfaces.
+         * @param num_surfaces The number of new surfaces.
+         * @return true if the new surfaces fit in the memory budget, or if no budget is set, false otherwise.
+         */
+        bool ReserveMemory(uint32_t surface_format, uint32_t image_width, uint32_t image_height, uint32_t num_surfaces);
+
+        /**
+         * @brief Deletes all the idle entries of the memory pool.
+         */
+        void TrimIdleEntries();
+
+        /**
+         * @brief Deletes the entries that have been idle for longer than the idle timeout, if one is set.
+         */
+        void ReleaseExpiredEntries();
+
         /**
          * @brief Sets the VADisplay for the memory pool.
          * @param va_display The VADisplay to be set.
@@ -159,10 +244,9 @@ class RocJpegVaapiMemoryPool {
          * @param surface_format The surface format of the pool entry.
          * @param image_width The image width of the pool entry.
          * @param image_height The image height of the pool entry.
-         * @param num_surfaces The number of surfaces of the entry to retrieve.
-         * @return The RocJpegVaapiMemPoolEntry object if found, otherwise a default-constructed object.
+         * @return The idle entry, now marked busy, if one is found, otherwise nullptr.
          */
-        RocJpegVaapiMemPoolEntry GetEntry(uint32_t surface_format, uint32_t image_width, uint32_t image_height, uint32_t num_surfaces);
+        const RocJpegVaapiMemPoolEntry* GetEntry(uint32_t surface_format, uint32_t image_width, uint32_t image_height);
 
         /**
          * @brief Adds a pool entry to the memory pool.
@@ -192,8 +276,14 @@ class RocJpegVaapiMemoryPool {
 
     private:
         VADisplay va_display_; // The VADisplay associated with the memory pool.
-        uint32_t max_pool_size_; // The maximum pool size of the memory pool (mem_pool_) per entry.
-        std::unordered_map<uint32_t, std::vector<RocJpegVaapiMemPoolEntry>> mem_pool_; // The memory pool.
+        uint32_t max_pool_size_; // The maximum number of entries of the memory pool, unless they are all busy.
+        std::list<RocJpegVaapiMemPoolEntry> mem_pool_; // The entries of the memory pool, whose addresses are stable.
+        std::unordered_map<VASurfaceID, std::list<RocJpegVaapiMemPoolEntry>::iterator> surface_index_; // The entry of each surface of the pool.
+        std::unordered_map<MemPoolKey, std::deque<std::list<RocJpegVaapiMemPoolEntry>::iterator>> idle_entries_; // The idle entries, least recently used first.
+        uint64_t release_sequence_; // The number of times an entry became idle.
+        size_t total_bytes_; // The memory held by the surfaces of the pool.
+        size_t max_pool_bytes_; // The maximum memory held by the surfaces of the pool, unless they are all busy, or 0 for no limit.
+        std::chrono::milliseconds idle_timeout_; // The time after which an idle entry is deleted, or 0 to keep idle entries.
         /**
          * @brief Retrieves the total size of the memory pool.
          *
@@ -209,13 +299,29 @@ class RocJpegVaapiMemoryPool {
          * @return true if the idle entry was successfully deleted, false otherwise.
          */
         bool DeleteIdleEntry();
+        /**
+         * @brief Deletes an idle entry from the memory pool.
+         * @param idle The list of idle entries of the entry.
+         * @param it The entry, at the front of its list of idle entries.
+         */
+        void EraseIdleEntry(std::unordered_map<MemPoolKey, std::deque<std::list<RocJpegVaapiMemPoolEntry>::iterator>>::iterator idle,
+                            std::list<RocJpegVaapiMemPoolEntry>::iterator it);
+        /**
+         * @brief Estimates the memory held by a surface before it is exported.
+         * @param surface_format The pixel format of the surface.
+         * @param width The width of the surface.
+         * @param height The height of the surface.
+         * @return The estimated size of the surface in bytes.
+         */
+        static size_t EstimateSurfaceSize(uint32_t surface_format, uint32_t width, uint32_t height);
 };
 
 /**
  * @brief Structure representing the key for a JPEG stream.
  *
  * This structure contains information about the surface format, pixel format, width, and height
- * of a JPEG stream. It is used for comparing two JpegStreamKey objects for equality.
+ * of a JPEG stream. The width and height are the size class of the surfaces that can hold the stream, so
+ * streams of close sizes are grouped together. It is used for comparing two JpegStreamKey objects for equality.
  */
 struct JpegStreamKey {
     uint32_t surface_format; /**< The surface format of the JPEG stream. */
@@ -291,9 +397,10 @@ public:
      * @param jpeg_stream_params The parameters of the JPEG stream.
      * @param surface_id The ID of the output surface.
      *  @param decode_params Additional parameters for the decode operation.
+     * @param enforce_memory_budget Whether to fail with ROCJPEG_STATUS_NOT_READY instead of exceeding the memory budget.
      * @return The status of the decoding operation.
      */
-    RocJpegStatus SubmitDecode(const JpegStreamParameters *jpeg_stream_params, uint32_t &surface_id, const RocJpegDecodeParams *decode_params);
+    RocJpegStatus SubmitDecode(const JpegStreamParameters *jpeg_stream_params, uint32_t &surface_id, const RocJpegDecodeParams *decode_params, bool enforce_memory_budget);
 
     /**
      * @brief Waits for the decoding operation to complete.
@@ -302,6 +409,21 @@ public:
      */
     RocJpegStatus SyncSurface(VASurfaceID surface_id);
 
+    /**
+     * @brief Waits for the decoding operation to complete, without looking the surface up in the memory pool.
+     * @param surface_id The ID of the output surface.
+     * @return The status of the synchronization operation.
+     */
+    RocJpegStatus WaitSurface(VASurfaceID surface_id);
+
+    /**
+     * @brief Checks whether the decoding operation has completed, without blocking.
+     * @param surface_id The ID of the output surface.
+     * @param is_ready Set to true if the surface is ready.
+     * @return The status of the query.
+     */
+    RocJpegStatus QuerySurfaceReady(VASurfaceID surface_id, bool &is_ready);
+
     /**
      * @brief Retrieves the HIP interop memory associated with the specified surface.
      * @param surface_id The ID of the surface.
@@ -313,13 +435,28 @@ public:
     /**
      * Submits a batch of JPEG streams for decoding using the VAAPI decoder.
      *
-     * @param jpeg_streams_params An array of the JPEG streams parameters to be decoded.
+     * @param jpeg_streams_params An array of pointers to the parameters of the JPEG streams to be decoded.
      * @param batch_size The number of JPEG streams in the batch.
      * @param decode_params The decoding parameters for the VAAPI decoder.
-     * @param surface_ids An array to store the surface IDs of the decoded frames.
+     * @param surface_ids An array to store the surface IDs of the decoded frames. If the submission fails, the
+     *        surfaces that have been acquired are left in it for the caller to release, and the other entries are
+     *        set to VA_INVALID_SURFACE.
+     * @param enforce_memory_budget Whether to fail with ROCJPEG_STATUS_NOT_READY, without submitting any stream,
+     *        instead of exceeding the memory budget.
      * @return The status of the decoding operation.
      */
-    RocJpegStatus SubmitDecodeBatched(JpegStreamParameters *jpeg_streams_params, int batch_size, const RocJpegDecodeParams *decode_params, uint32_t *surface_ids);
+    RocJpegStatus SubmitDecodeBatched(const JpegStreamParameters * const *jpeg_streams_params, int batch_size, const RocJpegDecodeParams *decode_params, uint32_t *surface_ids, bool enforce_memory_budget);
+
+    /**
+     * @brief Checks that a batch of JPEG streams can be decoded by the VCN hardware, without submitting them.
+     *
+     * @param jpeg_streams_params An array of pointers to the parameters of the JPEG streams.
+     * @param batch_size The number of JPEG streams in the batch.
+     * @param decode_params The decoding parameters.
+     * @return ROCJPEG_STATUS_SUCCESS if all the streams are supported, or ROCJPEG_STATUS_JPEG_NOT_SUPPORTED if the
+     *         resolution or the chroma subsampling of a stream is not.
+     */
+    RocJpegStatus CheckJpegStreamsSupported(const JpegStreamParameters * const *jpeg_streams_params, int batch_size, const RocJpegDecodeParams *decode_params);
 
     /**
      * @brief Returns the current VCN JPEG specification.
@@ -334,6 +471,23 @@ public:
      * @return The status of the operation.
      */
     RocJpegStatus SetSurfaceAsIdle(VASurfaceID surface_id);
+
+    /**
+     * @brief Sets the memory limits of the memory pool.
+     * @param max_pool_bytes The maximum memory held by the surfaces of the pool in bytes, or 0 for no limit.
+     * @param idle_timeout_ms The time after which an idle surface is released in milliseconds, or 0 to keep idle surfaces.
+     */
+    void SetMemoryLimits(size_t max_pool_bytes, uint32_t idle_timeout_ms) {vaapi_mem_pool_->SetMemoryLimits(max_pool_bytes, idle_timeout_ms);}
+
+    /**
+     * @brief Releases all the idle surfaces of the memory pool.
+     */
+    void TrimMemory() {vaapi_mem_pool_->TrimIdleEntries();}
+
+    /**
+     * @brief Releases the surfaces of the memory pool that have been idle for longer than the idle timeout.
+     */
+    void ReleaseExpiredSurfaces() {vaapi_mem_pool_->ReleaseExpiredEntries();}
 private:
     int device_id_; // The ID of the device
     int drm_fd_; // The file descriptor for the DRM device
@@ -350,11 +504,10 @@ private:
     std::unordered_map<std::string, VcnJpegSpec> vcn_jpeg_spec_; // The map of VCN JPEG specifications
     std::unique_ptr<RocJpegVaapiMemoryPool> vaapi_mem_pool_; // The VAAPI memory pool
     VcnJpegSpec current_vcn_jpeg_spec_; // The current VCN JPEG specification
-    VABufferID va_picture_parameter_buf_id_; // The VAAPI picture parameter buffer ID
-    VABufferID va_quantization_matrix_buf_id_; // The VAAPI quantization matrix buffer ID
-    VABufferID va_huffmantable_buf_id_; // The VAAPI Huffman table buffer ID
-    VABufferID va_slice_param_buf_id_; // The VAAPI slice parameter buffer ID
-    VABufferID va_slice_data_buf_id_; // The VAAPI slice data buffer ID
+    std::vector<VaBufferRingSlot> va_buffer_ring_; // The ring of persistent VAAPI buffers, one slot per JPEG core
+    uint32_t va_buffer_ring_index_; // The slot of the ring used by the next submission
+    PictureParameterBuffer picture_parameter_buffer_; // The staging VAAPI picture parameter buffer, filled at submit time
+    static constexpr uint32_t kSurfaceSizeClassStep = 256; // The step in pixels of the sizes of the surfaces of the memory pool
 
     /**
      * @brief Initializes the VAAPI with the specified DRM node.
@@ -380,11 +533,77 @@ private:
     RocJpegStatus CreateDecoderContext();
 
     /**
-     * @brief Destroys the data buffers.
+     * @brief Destroys the buffers of the ring of VAAPI buffers.
      * @return The status of the buffer destruction.
      */
     RocJpegStatus DestroyDataBuffers();
 
+    /**
+     * @brief Fills the staging picture parameter buffer from the compact picture parameters of a JPEG stream.
+     *
+     * Only the components of the stream and the crop rectangle are written; the other fields of the staging
+     * buffer are zeroed once at construction.
+     *
+     * @param jpeg_stream_params The parameters of the JPEG stream.
+     * @param decode_params The decode parameters, whose crop rectangle is passed to a decoder that can decode an ROI.
+     */
+    void FillPictureParameterBuffer(const JpegStreamParameters *jpeg_stream_params, const RocJpegDecodeParams *decode_params);
+
+    /**
+     * @brief Writes data into a VAAPI buffer through a mapping.
+     * @param buf_id The VAAPI buffer ID.
+     * @param data The data to write.
+     * @param size The size of the data in bytes.
+     * @return The status of the operation.
+     */
+    RocJpegStatus WriteBuffer(VABufferID buf_id, const void *data, size_t size);
+
+    /**
+     * @brief Writes the entropy-coded data of a JPEG stream into the slice data buffer of a ring slot.
+     *
+     * The slice data buffer is grown to the size of the data if needed. The entropy-coded data of a stream that is
+     * scattered over several buffers is copied segment by segment, so it is never gathered into a contiguous buffer first.
+     *
+     * @param slot The ring slot.
+     * @param jpeg_stream_params The parameters of the JPEG stream.
+     * @return The status of the operation.
+     */
+    RocJpegStatus WriteSliceDataBuffer(VaBufferRingSlot &slot, const JpegStreamParameters *jpeg_stream_params);
+
+    /**
+     * @brief Submits a JPEG stream to the hardware decoder using the next slot of the ring of VAAPI buffers.
+     *
+     * FillPictureParameterBuffer must have been called for the stream.
+     *
+     * @param jpeg_stream_params The parameters of the JPEG stream.
+     * @param surface_id The ID of the output surface.
+     * @return The status of the submission.
+     */
+    RocJpegStatus SubmitPicture(const JpegStreamParameters *jpeg_stream_params, VASurfaceID surface_id);
+
+    /**
+     * @brief Computes the size class of the surfaces that can hold a picture.
+     *
+     * The width and height of the picture are rounded up to a multiple of kSurfaceSizeClassStep, without exceeding
+     * the maximum picture size, so that pictures of close sizes share the surfaces of the memory pool. The picture
+     * is decoded into the top-left region of the surface.
+     *
+     * @param picture_width The width of the picture.
+     * @param picture_height The height of the picture.
+     * @param surface_width [out] The width of the surfaces of the size class.
+     * @param surface_height [out] The height of the surfaces of the size class.
+     */
+    void GetSurfaceSizeClass(uint32_t picture_width, uint32_t picture_height, uint32_t &surface_width, uint32_t &surface_height) const;
+
+    /**
+     * @brief Computes the surface format, pixel format, and surface size class of a JPEG stream.
+     * @param jpeg_stream_params The parameters of the JPEG stream.
+     * @param decode_params The decoding parameters.
+     * @param jpeg_stream_key [out] The key of the surfaces the stream is decoded into.
+     * @return The status of the operation.
+     */
+    RocJpegStatus GetJpegStreamKey(const JpegStreamParameters *jpeg_stream_params, const RocJpegDecodeParams *decode_params, JpegStreamKey &jpeg_stream_key);
+
     /**
      * @brief Retrieves the visible devices.
      * @param visible_devices The vector to store the visible devices.